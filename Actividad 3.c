@@ -1,608 +1,4481 @@
-/**
- * Simulador de Administración de Memoria
- * 
- * Este programa simula un sistema de administración de memoria que permite:
- * - Administrar particiones fijas y dinámicas
- * - Simular carga y liberación de procesos
- * - Calcular fragmentación interna y externa
- * - Simular compactación de memoria
- */
-
-
- #include <stdio.h>
- #include <stdlib.h>
- #include <string.h>
- #include <stdbool.h>
- 
-#define MAX_PROCESS_NAME 20
-#define DEFAULT_MEMORY_SIZE 64  // Tamaño de memoria en MB
-
-// Tipos de particiones
-typedef enum {
-    FIXED_PARTITIONS,
-    DYNAMIC_PARTITIONS
-} PartitionType;
-
-// Estado de un bloque de memoria
-typedef enum {
-    FREE,
-    OCCUPIED
-} BlockStatus;
-
-// Estructura para representar un bloque de memoria
-typedef struct MemoryBlock {
-    int id;                     // ID del bloque
-    int start_address;          // Dirección de inicio
-    int size;                   // Tamaño en MB
-    BlockStatus status;         // Estado (FREE u OCCUPIED)
-    char process_name[MAX_PROCESS_NAME]; // Nombre del proceso que ocupa el bloque
-    struct MemoryBlock* next;   // Puntero al siguiente bloque
-} MemoryBlock;
-
-// Estructura principal para la simulación
-typedef struct {
-    MemoryBlock* memory_map;    // Lista enlazada de bloques de memoria
-    int total_memory;           // Tamaño total de la memoria en MB
-    int available_memory;       // Memoria disponible en MB
-    PartitionType partition_type; // Tipo de partición actual
-    int num_fixed_partitions;   // Número de particiones fijas (si se usa ese modo)
-    int fixed_partition_size;   // Tamaño de cada partición fija
-} MemorySimulator;
-
-// Prototipos de funciones
-MemorySimulator* initSimulator(int memory_size);
-void setPartitionMode(MemorySimulator* sim, PartitionType type, int num_partitions);
-void displayMemoryMap(MemorySimulator* sim);
-bool allocateProcess(MemorySimulator* sim, char* process_name, int process_size);
-bool deallocateProcess(MemorySimulator* sim, char* process_name);
-void calculateFragmentation(MemorySimulator* sim, int* internal_frag, int* external_frag);
-void compactMemory(MemorySimulator* sim);
-void freeSimulator(MemorySimulator* sim);
-void displayMenu();
-
-int main() {
-    int memory_size = DEFAULT_MEMORY_SIZE;
-    MemorySimulator* simulator = initSimulator(memory_size);
-    
-    int choice;
-    bool running = true;
-    
-    while (running) {
-        displayMenu();
-        printf("\nIngrese su opción: ");
-        scanf("%d", &choice);
-        getchar(); // Consumir el carácter de nueva línea
-        
-        switch (choice) {
-            case 1: {
-                int partition_type;
-                printf("\nSeleccione el tipo de partición:\n");
-                printf("1. Particiones Fijas\n");
-                printf("2. Particiones Dinámicas\n");
-                printf("Ingrese su opción: ");
-                scanf("%d", &partition_type);
-                
-                if (partition_type == 1) {
-                    int num_partitions;
-                    printf("Ingrese el número de particiones fijas: ");
-                    scanf("%d", &num_partitions);
-                    setPartitionMode(simulator, FIXED_PARTITIONS, num_partitions);
-                } else if (partition_type == 2) {
-                    setPartitionMode(simulator, DYNAMIC_PARTITIONS, 0);
-                } else {
-                    printf("Opción inválida.\n");
-                }
-                break;
-            }
-            case 2: {
-                char process_name[MAX_PROCESS_NAME];
-                int process_size;
-                
-                printf("\nIngrese el nombre del proceso: ");
-                scanf("%s", process_name);
-                printf("Ingrese el tamaño del proceso (en MB): ");
-                scanf("%d", &process_size);
-                
-                if (allocateProcess(simulator, process_name, process_size)) {
-                    printf("\nProceso '%s' cargado exitosamente.\n", process_name);
-                } else {
-                    printf("\nNo se pudo cargar el proceso '%s'. Memoria insuficiente.\n", process_name);
-                }
-                
-                displayMemoryMap(simulator);
-                break;
-            }
-            case 3: {
-                char process_name[MAX_PROCESS_NAME];
-                
-                printf("\nIngrese el nombre del proceso a liberar: ");
-                scanf("%s", process_name);
-                
-                if (deallocateProcess(simulator, process_name)) {
-                    printf("\nProceso '%s' liberado exitosamente.\n", process_name);
-                } else {
-                    printf("\nNo se encontró el proceso '%s'.\n", process_name);
-                }
-                
-                displayMemoryMap(simulator);
-                break;
-            }
-            case 4: {
-                int internal_frag, external_frag;
-                calculateFragmentation(simulator, &internal_frag, &external_frag);
-                
-                printf("\nFragmentación:\n");
-                printf("- Fragmentación interna: %d MB\n", internal_frag);
-                printf("- Fragmentación externa: %d MB\n", external_frag);
-                break;
-            }
-            case 5: {
-                printf("\nEstado de la memoria antes de la compactación:\n");
-                displayMemoryMap(simulator);
-                
-                compactMemory(simulator);
-                
-                printf("\nEstado de la memoria después de la compactación:\n");
-                displayMemoryMap(simulator);
-                break;
-            }
-            case 6: {
-                displayMemoryMap(simulator);
-                break;
-            }
-            case 0: {
-                running = false;
-                break;
-            }
-            default:
-                printf("\nOpción inválida.\n");
-        }
-    }
-    
-    freeSimulator(simulator);
-    printf("\nSimulador finalizado.\n");
-    
-    return 0;
-}
-
-// Inicializa el simulador con un tamaño de memoria dado
-MemorySimulator* initSimulator(int memory_size) {
-    MemorySimulator* sim = (MemorySimulator*) malloc(sizeof(MemorySimulator));
-    
-    if (sim == NULL) {
-        printf("Error: No se pudo asignar memoria para el simulador.\n");
-        exit(1);
-    }
-    
-    // Inicializar el primer bloque como libre, con el tamaño total de memoria
-    MemoryBlock* initial_block = (MemoryBlock*) malloc(sizeof(MemoryBlock));
-    
-    if (initial_block == NULL) {
-        printf("Error: No se pudo asignar memoria para el bloque inicial.\n");
-        free(sim);
-        exit(1);
-    }
-    
-    initial_block->id = 0;
-    initial_block->start_address = 0;
-    initial_block->size = memory_size;
-    initial_block->status = FREE;
-    strcpy(initial_block->process_name, "");
-    initial_block->next = NULL;
-    
-    sim->memory_map = initial_block;
-    sim->total_memory = memory_size;
-    sim->available_memory = memory_size;
-    sim->partition_type = DYNAMIC_PARTITIONS;  // Por defecto
-    sim->num_fixed_partitions = 0;
-    sim->fixed_partition_size = 0;
-    
-    printf("Simulador inicializado con %d MB de memoria.\n", memory_size);
-    
-    return sim;
-}
-
-// Establece el modo de partición
-void setPartitionMode(MemorySimulator* sim, PartitionType type, int num_partitions) {
-    // Liberar la memoria y volver a inicializar con la nueva configuración
-    while (sim->memory_map != NULL) {
-        MemoryBlock* temp = sim->memory_map;
-        sim->memory_map = sim->memory_map->next;
-        free(temp);
-    }
-    
-    sim->partition_type = type;
-    sim->available_memory = sim->total_memory;
-    
-    if (type == FIXED_PARTITIONS) {
-        sim->num_fixed_partitions = num_partitions;
-        sim->fixed_partition_size = sim->total_memory / num_partitions;
-        
-        // Crear las particiones fijas
-        MemoryBlock* prev_block = NULL;
-        
-        for (int i = 0; i < num_partitions; i++) {
-            MemoryBlock* block = (MemoryBlock*) malloc(sizeof(MemoryBlock));
-            
-            if (block == NULL) {
-                printf("Error: No se pudo asignar memoria para el bloque %d.\n", i);
-                exit(1);
-            }
-            
-            block->id = i;
-            block->start_address = i * sim->fixed_partition_size;
-            block->size = sim->fixed_partition_size;
-            block->status = FREE;
-            strcpy(block->process_name, "");
-            block->next = NULL;
-            
-            if (prev_block == NULL) {
-                sim->memory_map = block;
-            } else {
-                prev_block->next = block;
-            }
-            
-            prev_block = block;
-        }
-        
-        printf("Modo de particiones fijas establecido con %d particiones de %d MB cada una.\n", 
-               num_partitions, sim->fixed_partition_size);
-    } else {
-        // Crear un único bloque libre con todo el espacio
-        MemoryBlock* block = (MemoryBlock*) malloc(sizeof(MemoryBlock));
-        
-        if (block == NULL) {
-            printf("Error: No se pudo asignar memoria para el bloque inicial.\n");
-            exit(1);
-        }
-        
-        block->id = 0;
-        block->start_address = 0;
-        block->size = sim->total_memory;
-        block->status = FREE;
-        strcpy(block->process_name, "");
-        block->next = NULL;
-        
-        sim->memory_map = block;
-        
-        printf("Modo de particiones dinámicas establecido.\n");
-    }
-}
-
-// Muestra el mapa de memoria actual
-void displayMemoryMap(MemorySimulator* sim) {
-    printf("\n=== Estado actual de la memoria (%d MB total, %d MB disponible) ===\n", 
-           sim->total_memory, sim->available_memory);
-    printf("Dirección\tTamaño\tEstado\t\tProceso\n");
-    printf("--------------------------------------------------------------\n");
-    
-    MemoryBlock* current = sim->memory_map;
-    int id_counter = 0;
-    
-    while (current != NULL) {
-        printf("%4d MB\t\t%4d MB\t%s\t\t%s\n", 
-               current->start_address, 
-               current->size, 
-               current->status == FREE ? "LIBRE" : "OCUPADO",
-               current->status == FREE ? "-" : current->process_name);
-        
-        current = current->next;
-        id_counter++;
-    }
-    
-    printf("--------------------------------------------------------------\n");
-    
-    // Representación gráfica
-    printf("\nRepresentación gráfica de la memoria:\n");
-    printf("[");
-    
-    current = sim->memory_map;
-    while (current != NULL) {
-        // Imprimir bloques proporcionales a su tamaño
-        int block_chars = (current->size * 50) / sim->total_memory;
-        if (block_chars < 1) block_chars = 1;
-        
-        for (int i = 0; i < block_chars; i++) {
-            if (current->status == FREE) {
-                printf(".");
-            } else {
-                printf("#");
-            }
-        }
-        
-        if (current->next != NULL) {
-            printf("|");
-        }
-        
-        current = current->next;
-    }
-    
-    printf("]\n");
-    printf("Leyenda: [.] = Libre, [#] = Ocupado\n\n");
-}
-
-// Asigna memoria para un proceso según el modo de partición
-bool allocateProcess(MemorySimulator* sim, char* process_name, int process_size) {
-    if (process_size <= 0) {
-        printf("Error: El tamaño del proceso debe ser mayor que cero.\n");
-        return false;
-    }
-    
-    if (process_size > sim->available_memory) {
-        printf("Error: No hay suficiente memoria disponible para el proceso.\n");
-        return false;
-    }
-    
-    // Verificar si el proceso ya existe
-    MemoryBlock* current = sim->memory_map;
-    while (current != NULL) {
-        if (current->status == OCCUPIED && strcmp(current->process_name, process_name) == 0) {
-            printf("Error: Ya existe un proceso con el nombre '%s'.\n", process_name);
-            return false;
-        }
-        current = current->next;
-    }
-    
-    if (sim->partition_type == FIXED_PARTITIONS) {
-        // Algoritmo de First-Fit para particiones fijas
-        current = sim->memory_map;
-        while (current != NULL) {
-            if (current->status == FREE && process_size <= current->size) {
-                current->status = OCCUPIED;
-                strcpy(current->process_name, process_name);
-                sim->available_memory -= current->size;  // Reservamos toda la partición
-                return true;
-            }
-            current = current->next;
-        }
-        
-        printf("Error: No se encontró una partición libre lo suficientemente grande.\n");
-        return false;
-    } else {
-        // Algoritmo de First-Fit para particiones dinámicas
-        current = sim->memory_map;
-        int new_id = 0;
-        
-        while (current != NULL) {
-            if (current->id > new_id) {
-                new_id = current->id;
-            }
-            
-            if (current->status == FREE && process_size <= current->size) {
-                // Encontramos un bloque libre que puede contener el proceso
-                if (current->size == process_size) {
-                    // El bloque es exactamente del tamaño necesario
-                    current->status = OCCUPIED;
-                    strcpy(current->process_name, process_name);
-                    sim->available_memory -= process_size;
-                    return true;
-                } else {
-                    // El bloque es más grande de lo necesario, dividirlo
-                    MemoryBlock* new_block = (MemoryBlock*) malloc(sizeof(MemoryBlock));
-                    
-                    if (new_block == NULL) {
-                        printf("Error: No se pudo asignar memoria para el nuevo bloque.\n");
-                        return false;
-                    }
-                    
-                    new_block->id = new_id + 1;
-                    new_block->start_address = current->start_address;
-                    new_block->size = process_size;
-                    new_block->status = OCCUPIED;
-                    strcpy(new_block->process_name, process_name);
-                    
-                    // Ajustar el bloque original
-                    current->start_address += process_size;
-                    current->size -= process_size;
-                    
-                    // Insertar el nuevo bloque antes del actual
-                    new_block->next = current;
-                    
-                    // Actualizar los punteros
-                    if (current == sim->memory_map) {
-                        sim->memory_map = new_block;
-                    } else {
-                        MemoryBlock* prev = sim->memory_map;
-                        while (prev->next != current) {
-                            prev = prev->next;
-                        }
-                        prev->next = new_block;
-                    }
-                    
-                    sim->available_memory -= process_size;
-                    return true;
-                }
-            }
-            
-            current = current->next;
-        }
-        
-        printf("Error: No se encontró un bloque libre lo suficientemente grande.\n");
-        return false;
-    }
-}
-
-// Libera la memoria ocupada por un proceso
-bool deallocateProcess(MemorySimulator* sim, char* process_name) {
-    MemoryBlock* current = sim->memory_map;
-    MemoryBlock* prev = NULL;
-    bool found = false;
-    
-    while (current != NULL) {
-        if (current->status == OCCUPIED && strcmp(current->process_name, process_name) == 0) {
-            found = true;
-            
-            // Liberar el bloque
-            current->status = FREE;
-            strcpy(current->process_name, "");
-            
-            if (sim->partition_type == FIXED_PARTITIONS) {
-                sim->available_memory += current->size;
-            } else {
-                sim->available_memory += current->size;
-                
-                // Intentar fusionar con bloques adyacentes (coalescing)
-                MemoryBlock* next_block = current->next;
-                
-                // Fusionar con el bloque siguiente si está libre
-                if (next_block != NULL && next_block->status == FREE) {
-                    current->size += next_block->size;
-                    current->next = next_block->next;
-                    free(next_block);
-                }
-                
-                // Fusionar con el bloque anterior si está libre
-                if (prev != NULL && prev->status == FREE) {
-                    prev->size += current->size;
-                    prev->next = current->next;
-                    free(current);
-                    current = prev;
-                }
-            }
-            
-            break;
-        }
-        
-        prev = current;
-        current = current->next;
-    }
-    
-    return found;
-}
-
-// Calcula la fragmentación interna y externa
-void calculateFragmentation(MemorySimulator* sim, int* internal_frag, int* external_frag) {
-    *internal_frag = 0;
-    *external_frag = 0;
-    
-    MemoryBlock* current = sim->memory_map;
-    
-    while (current != NULL) {
-        if (sim->partition_type == FIXED_PARTITIONS && current->status == OCCUPIED) {
-            // Fragmentación interna en particiones fijas
-            int used_size = 0;
-            // En un sistema real, esto sería el tamaño real del proceso
-            // Para este simulador, asumimos que el tamaño real es el 70% del tamaño de la partición
-            used_size = (int)(current->size * 0.7);
-            *internal_frag += (current->size - used_size);
-        }
-        
-        if (sim->partition_type == DYNAMIC_PARTITIONS && current->status == FREE) {
-            // Fragmentación externa en particiones dinámicas
-            *external_frag += current->size;
-        }
-        
-        current = current->next;
-    }
-    
-    // En particiones fijas, la fragmentación externa es cero
-    if (sim->partition_type == FIXED_PARTITIONS) {
-        *external_frag = 0;
-    }
-}
-
-// Compacta la memoria (solo para particiones dinámicas)
-void compactMemory(MemorySimulator* sim) {
-    if (sim->partition_type == FIXED_PARTITIONS) {
-        printf("La compactación solo es aplicable al modo de particiones dinámicas.\n");
-        return;
-    }
-    
-    // Crear una nueva lista de bloques
-    MemoryBlock* new_memory_map = NULL;
-    MemoryBlock* new_memory_tail = NULL;
-    
-    // Primero, agregar todos los bloques ocupados
-    MemoryBlock* current = sim->memory_map;
-    int current_address = 0;
-    
-    while (current != NULL) {
-        if (current->status == OCCUPIED) {
-            MemoryBlock* new_block = (MemoryBlock*) malloc(sizeof(MemoryBlock));
-            
-            if (new_block == NULL) {
-                printf("Error: No se pudo asignar memoria para el nuevo bloque.\n");
-                return;
-            }
-            
-            new_block->id = current->id;
-            new_block->start_address = current_address;
-            new_block->size = current->size;
-            new_block->status = OCCUPIED;
-            strcpy(new_block->process_name, current->process_name);
-            new_block->next = NULL;
-            
-            if (new_memory_map == NULL) {
-                new_memory_map = new_block;
-                new_memory_tail = new_block;
-            } else {
-                new_memory_tail->next = new_block;
-                new_memory_tail = new_block;
-            }
-            
-            current_address += current->size;
-        }
-        
-        current = current->next;
-    }
-    
-    // Agregar un bloque libre al final si hay espacio disponible
-    if (sim->available_memory > 0) {
-        MemoryBlock* free_block = (MemoryBlock*) malloc(sizeof(MemoryBlock));
-        
-        if (free_block == NULL) {
-            printf("Error: No se pudo asignar memoria para el bloque libre.\n");
-            return;
-        }
-        
-        free_block->id = (new_memory_tail != NULL) ? new_memory_tail->id + 1 : 0;
-        free_block->start_address = current_address;
-        free_block->size = sim->available_memory;
-        free_block->status = FREE;
-        strcpy(free_block->process_name, "");
-        free_block->next = NULL;
-        
-        if (new_memory_map == NULL) {
-            new_memory_map = free_block;
-        } else {
-            new_memory_tail->next = free_block;
-        }
-    }
-    
-    // Liberar la memoria del mapa antiguo
-    while (sim->memory_map != NULL) {
-        MemoryBlock* temp = sim->memory_map;
-        sim->memory_map = sim->memory_map->next;
-        free(temp);
-    }
-    
-    // Actualizar el mapa de memoria
-    sim->memory_map = new_memory_map;
-    
-    printf("Memoria compactada exitosamente.\n");
-}
-
-// Libera la memoria utilizada por el simulador
-void freeSimulator(MemorySimulator* sim) {
-    MemoryBlock* current = sim->memory_map;
-    
-    while (current != NULL) {
-        MemoryBlock* temp = current;
-        current = current->next;
-        free(temp);
-    }
-    
-    free(sim);
-}
-
-// Muestra el menú de opciones
-void displayMenu() {
-    printf("\n=== Simulador de Administración de Memoria ===\n");
-    printf("1. Establecer modo de partición\n");
-    printf("2. Cargar proceso\n");
-    printf("3. Liberar proceso\n");
-    printf("4. Calcular fragmentación\n");
-    printf("5. Compactar memoria\n");
-    printf("6. Mostrar estado de memoria\n");
-    printf("0. Salir\n");
-}
\ No newline at end of file
+/**
+ * Simulador de Administración de Memoria
+ * 
+ * Este programa simula un sistema de administración de memoria que permite:
+ * - Administrar particiones fijas, dinámicas, por sistema buddy o con un mapa de bits
+ * - Simular carga y liberación de procesos
+ * - Calcular fragmentación interna y externa en O(1) con contadores incrementales
+ * - Simular compactación de memoria (completa, incremental o hasta que quepa un proceso)
+ * - Elegir la política de ubicación (first, next, best, worst-fit, listas segregadas o
+ *   first-fit por escaneo vectorizado de una tabla contigua)
+ * - Reproducir trazas de operaciones en modo no interactivo y medir su rendimiento
+ * - Direcciones y tamaños de 64 bits con granularidad configurable (bytes, KB, páginas o MB)
+ * - Modo concurrente con arenas protegidas por locks y medición de escalabilidad por hilos
+ * - Barrido de configuraciones en paralelo sobre una misma traza con salida CSV
+ * - Generador sintético de carga con distribuciones de tamaño y de vida configurables
+ * - Simulación por eventos discretos con llegadas, duraciones y métricas ponderadas por tiempo,
+ *   con una cola de admisión opcional (FIFO, menor tamaño primero o por prioridad)
+ * - Snapshots binarios versionados del estado, restaurados con mmap, y checkpoints de trazas
+ * - Memoria virtual paginada con TLB y reemplazo FIFO, LRU, CLOCK o aging sobre una traza
+ *   de referencias
+ *
+ * El motor vive en memsim.c (interfaz en memsim.h); este archivo tiene el menú, los modos
+ * no interactivos y los reportes, que son los únicos que escriben en la terminal.
+ */
+
+
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <stdbool.h>
+ #include <stdint.h>
+ #include <stdarg.h>
+ #include <time.h>
+ #include <ctype.h>
+ #include <errno.h>
+ #include <limits.h>
+ #include <pthread.h>
+ #include <unistd.h>
+ #include <math.h>
+ #include <fcntl.h>
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+ #include "memsim.h"
+ 
+#define DEFAULT_MEMORY_SIZE 64  // Tamaño de memoria en MB
+#define MAX_TRACE_LINE 256      // Longitud máxima de una línea de traza
+#define THREAD_BENCH_OPS 200000       // Operaciones por hilo en la medición de escalabilidad
+#define THREAD_BENCH_LIVE 1024        // Procesos vivos como máximo por hilo en la medición
+#define SWEEP_MAX_VALUES 64           // Valores como máximo por dimensión de la grilla del barrido
+#define SWEEP_DEFAULT_PARTITIONS 4    // Particiones fijas si la grilla no las indica
+#define DEPARTURE_HEAP_INITIAL_CAPACITY 1024 // Entradas iniciales del heap de salidas
+#define MAP_DISPLAY_WIDTH 50          // Columnas de la representación gráfica del mapa
+#define TLB_WAYS 4                    // Vías de cada conjunto de la TLB
+#define DEFAULT_TLB_ENTRIES 64        // Entradas de la TLB si no se indica otra cantidad
+#define DEFAULT_AGING_INTERVAL 1000   // Referencias entre desplazamientos de los contadores de aging
+#define PAGE_TABLE_INITIAL_CAPACITY 64 // Entradas iniciales de la tabla de páginas de un proceso
+#define PAGING_MAX_PROCESSES 65536    // Procesos distintos como máximo en una traza de referencias
+#define BACKLOG_PROFILE_SLOTS 16      // Intervalos del perfil de la cola de admisión en el tiempo
+#define BENCH_DEFAULT_MAX_BLOCKS 1000000 // Mayor cantidad de bloques de la batería de microbenchmarks
+#define BENCH_DEFAULT_REPETITIONS 5   // Repeticiones medidas de cada caso
+#define BENCH_WARMUP 1                // Repeticiones de calentamiento (no se miden)
+#define BENCH_DEFAULT_THRESHOLD 0.10  // Fracción de aumento de la mediana que cuenta como regresión
+#define BENCH_NOISE_SIGMAS 3.0        // Desvíos combinados que la diferencia de medianas debe superar
+#define BENCH_CALIBRATION_WORDS 65536 // Palabras (512 KB) del recorrido que mide la velocidad de la máquina
+#define BENCH_CALIBRATION_STEPS 262144 // Pasos de cada medición de calibración
+#define BENCH_BATCH 256               // Operaciones por tanda medida
+#define BENCH_SLOT 16                 // Tamaño máximo de los procesos de la batería (bytes)
+#define BENCH_TARGET_NS 5000000ULL    // Tiempo medido mínimo por repetición
+#define BENCH_MAX_WALL_NS 100000000ULL // Tiempo total por repetición (con preparación) tras el que se corta
+
+// Tipos de operación que puede contener una traza
+typedef enum {
+    TRACE_ALLOC,
+    TRACE_FREE,
+    TRACE_COMPACT,
+    TRACE_MODE,
+    TRACE_POLICY,
+    TRACE_OP_COUNT
+} TraceOpType;
+
+// Resultados acumulados durante la reproducción de una traza
+typedef struct {
+    LatencyHistogram latency[TRACE_OP_COUNT]; // Latencias por tipo de operación
+    uint64_t failures[TRACE_OP_COUNT];        // Operaciones que devolvieron error
+    uint64_t invalid_lines;                   // Líneas que no se pudieron interpretar
+    uint64_t sim_ns;                          // Tiempo total dentro del simulador
+    uint64_t wall_ns;                         // Tiempo total incluyendo lectura de la traza
+    uint64_t fit_compactions;                 // Compactaciones parciales tras un alloc fallido
+    uint64_t samples;                         // Muestras de estadísticas (una por operación)
+    double sum_external_ratio;                // Suma del índice de fragmentación externa
+    double max_external_ratio;                // Máximo índice de fragmentación externa
+    uint64_t sum_free_blocks;                 // Suma de bloques libres
+    uint64_t max_free_blocks;                 // Máximo de bloques libres
+} TraceReport;
+
+// Variantes de las operaciones de traza que las necesitan
+#define TRACE_FREE_UNKNOWN 1    // free de un nombre que no puede existir (demasiado largo)
+#define TRACE_COMPACT_ALL 0     // compact
+#define TRACE_COMPACT_BLOCKS 1  // compact blocks <K>
+#define TRACE_COMPACT_SIZE 2    // compact mb <tamaño>
+#define TRACE_COMPACT_FIT 3     // compact fit <tamaño>
+
+// Operación de traza ya interpretada (sin depender del texto original)
+typedef struct {
+    TraceOpType type;
+    uint8_t variant;            // Variante de compact/free, modo de partición o política
+    MemSize amount;             // Tamaño, bloques, particiones o unidades por bit
+    char name[MAX_PROCESS_NAME];
+} TraceOp;
+
+// Traza completa en memoria: se interpreta una vez y se comparte solo para lectura
+typedef struct {
+    TraceOp* ops;
+    size_t count;
+    size_t capacity;
+    uint64_t invalid_lines;     // Líneas descartadas al interpretar
+    MemoryUnit unit;            // Unidad con la que se interpretaron los tamaños
+} TraceProgram;
+
+// Una configuración del barrido: un simulador independiente por cada una
+typedef struct {
+    MemSize memory_size;
+    PartitionType mode;
+    int partitions;             // Particiones fijas (0 en los demás modos)
+    PlacementPolicy placement;
+} SweepConfig;
+
+// Resultado resumido de una configuración del barrido
+typedef struct {
+    uint64_t operations;        // Operaciones ejecutadas
+    uint64_t failures;          // Operaciones que devolvieron error
+    uint64_t sim_ns;            // Tiempo dentro del simulador
+    uint64_t alloc_p50_ns;      // Latencia mediana de alloc
+    uint64_t alloc_p99_ns;      // Percentil 99 de la latencia de alloc
+    MemSize internal_frag;      // Fragmentación interna final
+    MemSize external_frag;      // Fragmentación externa final
+    double mean_external_ratio; // Índice de fragmentación externa medio durante la traza
+    double max_external_ratio;  // Índice de fragmentación externa máximo
+    uint64_t max_free_blocks;   // Máximo de bloques libres durante la traza
+    MemSize compaction_moved;   // Memoria movida por compactación
+    bool valid;                 // Invariantes verificadas al terminar
+} SweepResult;
+
+// Cola de trabajo de un hilo del pool: un rango de configuraciones donde el dueño toma
+// desde el final y los demás hilos roban desde el principio
+typedef struct {
+    pthread_mutex_t lock;
+    size_t top;                 // Primera configuración pendiente (lado de los ladrones)
+    size_t bottom;              // Una después de la última pendiente (lado del dueño)
+} WorkDeque;
+
+// Estado compartido del pool de trabajo del barrido (la traza es solo de lectura)
+typedef struct {
+    const TraceProgram* trace;
+    const SweepConfig* configs;
+    SweepResult* results;
+    WorkDeque* deques;
+    int worker_count;
+    bool compact_on_fail;
+} SweepPool;
+
+// Un hilo del pool con sus contadores
+typedef struct {
+    SweepPool* pool;
+    int id;
+    uint64_t executed;          // Configuraciones ejecutadas
+    uint64_t stolen;            // Configuraciones robadas a otros hilos
+} SweepWorker;
+
+// Distribuciones del generador sintético de carga
+typedef enum {
+    DIST_FIXED,                 // Siempre el mismo valor (a)
+    DIST_UNIFORM,               // Entero uniforme entre low y high
+    DIST_EXPONENTIAL,           // Exponencial de media a
+    DIST_PARETO,                // Pareto de forma a y mínimo b (cola pesada)
+    DIST_BIMODAL                // a con probabilidad 1 - c, b con probabilidad c
+} DistributionKind;
+
+// Distribución con sus parámetros; los valores generados se acotan a [1, max]
+typedef struct {
+    DistributionKind kind;
+    double a;
+    double b;
+    double c;
+    uint64_t low;               // Cotas de la uniforme, en enteros para no perder precisión
+    uint64_t high;
+    MemSize max;
+} Distribution;
+
+// Salida programada de un proceso: el nombre se reconstruye a partir de su número
+typedef struct {
+    uint64_t time;              // Instante de la salida
+    uint64_t name_id;           // Número del proceso (su nombre es "g" + el número en base 36)
+} Departure;
+
+// Heap binario de salidas ordenado por instante (mínimo en la raíz)
+typedef struct {
+    Departure* entries;
+    size_t count;
+    size_t capacity;
+} DepartureHeap;
+
+// Generador de carga en streaming: produce eventos alloc/free sin guardarlos; la
+// memoria usada depende solo de los procesos vivos, no de la cantidad de eventos
+typedef struct {
+    Distribution sizes;         // Tamaño de cada proceso en unidades
+    Distribution lifetimes;     // Vida de cada proceso en asignaciones
+    uint64_t rng;               // Estado del generador aleatorio (xorshift64*)
+    uint64_t clock;             // Asignaciones intentadas hasta ahora
+    uint64_t next_name_id;      // Número del próximo proceso
+    DepartureHeap departures;   // Procesos vivos ordenados por salida
+    uint64_t allocations;       // Eventos alloc generados
+    uint64_t frees;             // Eventos free generados
+} WorkloadGenerator;
+
+// Origen de las llegadas de la simulación por eventos: distribuciones o un archivo con
+// líneas "<llegada> <tamaño> <duración> [prioridad]" ordenadas por llegada
+typedef struct {
+    Distribution interarrival;  // Tiempo entre llegadas
+    Distribution sizes;         // Tamaño de cada proceso en unidades
+    Distribution durations;     // Tiempo que cada proceso permanece cargado
+    Distribution priorities;    // Prioridad de cada llegada (si has_priorities)
+    bool has_priorities;        // Sin --priorities ni columna en el archivo, todas valen 0
+    uint64_t rng;
+    uint64_t clock;             // Instante de la última llegada
+    FILE* file;                 // Si no es NULL, las llegadas se leen de aquí
+    MemoryUnit unit;            // Unidad de los tamaños del archivo
+    uint64_t line_number;
+    uint64_t invalid_lines;
+} ArrivalSource;
+
+// Resultados de la simulación por eventos discretos; las áreas son integrales en el
+// tiempo simulado y divididas por la duración dan los promedios ponderados por tiempo
+typedef struct {
+    uint64_t arrivals;          // Procesos que llegaron
+    uint64_t rejected;          // Llegadas que no cupieron
+    uint64_t departures;        // Procesos que terminaron
+    uint64_t fit_compactions;   // Compactaciones parciales para admitir una llegada
+    uint64_t start_time;        // Instante de la primera llegada
+    uint64_t end_time;          // Instante del último evento
+    double used_area;           // Integral de la memoria ocupada
+    double external_ratio_area; // Integral del índice de fragmentación externa
+    double free_blocks_area;    // Integral de la cantidad de bloques libres
+    uint64_t max_live;          // Máximo de procesos cargados a la vez
+    uint64_t wall_ns;           // Tiempo real de la simulación
+    uint64_t queued;            // Llegadas que esperaron en la cola de admisión
+    double backlog_area;        // Integral de la cantidad de solicitudes en espera
+    double backlog_profile[BACKLOG_PROFILE_SLOTS]; // La misma integral por intervalo de tiempo
+    uint64_t profile_width;     // Duración de cada intervalo (se duplica al llenarse el perfil)
+} TimedReport;
+
+// Checkpoints periódicos durante la reproducción de una traza
+typedef struct {
+    uint64_t every;             // Operaciones entre checkpoints (0 = ninguno)
+    const char* prefix;         // Cada checkpoint se escribe en "<prefix>.<línea>.snap"
+    uint64_t skip_lines;        // Líneas ya aplicadas (al reanudar desde un checkpoint)
+    uint64_t written;           // Checkpoints escritos
+    uint64_t last_line;         // Última línea leída de la traza
+} TraceCheckpoint;
+
+// Política de reemplazo de páginas
+typedef enum {
+    REPLACE_FIFO,               // La página cargada hace más tiempo
+    REPLACE_LRU,                // La usada hace más tiempo (lista exacta, O(1) por referencia)
+    REPLACE_CLOCK,              // Segunda oportunidad con un bit de referencia
+    REPLACE_AGING,              // LRU aproximado con contadores desplazados periódicamente
+    REPLACE_POLICY_COUNT
+} ReplacementPolicy;
+
+// Entrada de la tabla de páginas de un proceso. Las páginas tocadas nunca se borran:
+// al desalojarlas solo pierden el marco
+typedef struct {
+    uint64_t key;               // Número de página virtual + 1 (0 = entrada vacía)
+    int32_t frame;              // Marco donde reside la página, o -1 si no está cargada
+} PageTableEntry;
+
+// Tabla de páginas de un proceso: hash abierto con sondeo lineal por número de página
+typedef struct {
+    PageTableEntry* entries;
+    size_t capacity;            // Potencia de dos
+    size_t count;               // Páginas tocadas alguna vez
+    int shift;                  // 64 - log2(capacity), para el hash multiplicativo
+} PageTable;
+
+// Marco de memoria física
+typedef struct {
+    uint64_t vpn;               // Página que contiene
+    uint32_t pid;               // Proceso dueño de la página
+    int32_t prev;               // Lista intrusiva: FIFO en orden de carga, LRU en orden de uso
+    int32_t next;
+    uint32_t age;               // Contador de aging (el bit alto es la referencia más reciente)
+    bool referenced;            // Bit de referencia (CLOCK y aging)
+    bool dirty;                 // Se escribió desde que se cargó
+} PageFrame;
+
+// Entrada de la TLB. Está etiquetada con el proceso, así que no se vacía al cambiar de proceso
+typedef struct {
+    uint64_t vpn;
+    uint32_t pid;
+    int32_t frame;              // -1 = entrada inválida
+    uint64_t last_use;          // Para elegir la víctima dentro del conjunto
+} TlbEntry;
+
+// Contadores de una política de reemplazo
+typedef struct {
+    uint64_t references;
+    uint64_t writes;
+    uint64_t tlb_hits;
+    uint64_t faults;
+    uint64_t cold_faults;       // Primera referencia a la página
+    uint64_t evictions;
+    uint64_t writebacks;        // Desalojos de páginas modificadas
+} PagingStats;
+
+// Memoria física paginada administrada con una política de reemplazo
+typedef struct {
+    ReplacementPolicy policy;
+    PageFrame* frames;
+    uint32_t frame_count;
+    uint32_t frames_used;       // Los marcos se ocupan en orden y nunca vuelven a quedar libres
+    int32_t list_head;          // Más reciente (carga en FIFO, uso en LRU)
+    int32_t list_tail;          // Próxima víctima de FIFO y LRU
+    uint32_t clock_hand;        // Próximo marco a revisar (CLOCK y aging)
+    uint64_t aging_interval;
+    uint64_t aging_countdown;
+    TlbEntry* tlb;              // tlb_sets * TLB_WAYS entradas
+    uint32_t tlb_sets;          // Potencia de dos; 0 = sin TLB
+    uint64_t tlb_clock;
+    PageTable* tables;          // Una tabla de páginas por proceso
+    size_t table_count;
+    PagingStats stats;
+} Pager;
+
+// Configuración de la simulación paginada
+typedef struct {
+    uint64_t page_size;         // Bytes por página (potencia de dos)
+    uint32_t frame_count;
+    uint32_t tlb_entries;
+    uint64_t aging_interval;
+    bool policies[REPLACE_POLICY_COUNT]; // Políticas a simular sobre la misma traza
+} PagingConfig;
+
+// Texto acumulado en memoria para imprimirlo con una sola escritura
+typedef struct {
+    char* data;
+    size_t length;
+    size_t capacity;
+    bool failed;                // Falló una reserva: el texto quedó incompleto
+} TextBuffer;
+
+// Parámetros de la batería de microbenchmarks
+typedef struct {
+    uint64_t max_blocks;        // Bloques del caso más grande (potencias de diez desde 10)
+    int repetitions;            // Repeticiones medidas de cada caso
+    double threshold;           // Aumento relativo de la mediana que cuenta como regresión
+    PlacementPolicy placement;  // Política de ubicación de los modos que la usan
+    const char* json_path;      // Archivo de resultados (NULL = no se escribe)
+    const char* baseline_path;  // Resultados de referencia para comparar (NULL = no se compara)
+} BenchConfig;
+
+// Prototipos de funciones (las del motor están en memsim.h)
+void displayMemoryMap(MemorySimulator* sim);
+bool exportMemoryMap(MemorySimulator* sim, const char* path);
+void displayMenu();
+void printPartitionMode(MemorySimulator* sim);
+void printAllocationError(MemorySimulator* sim, SimStatus status, const char* process_name);
+bool readPartitionLayout(const char* text, MemoryUnit unit, MemSize** sizes, size_t* count);
+bool applyPartitionLayout(MemorySimulator* sim, const char* text);
+
+// Instrumentación del camino crítico
+void printInstrumentation(FILE* out, MemorySimulator* sim);
+bool dumpInstrumentation(MemorySimulator* sim, const char* path);
+
+// Texto en memoria para la salida del mapa
+void renderMemoryMap(MemorySimulator* sim, TextBuffer* buf);
+void textBufferAppend(TextBuffer* buf, const char* format, ...);
+void textBufferRepeat(TextBuffer* buf, char ch, size_t count);
+void textBufferFree(TextBuffer* buf);
+
+// Validación a gran escala y mediciones
+bool runScaleCheck(MemorySimulator* sim, uint64_t block_count);
+bool runScanBenchmark(void);
+bool runThreadBenchmark(int max_threads, int arena_count, MemSize memory_size, MemoryUnit unit,
+                        PlacementPolicy placement);
+bool runBenchmarkSuite(const BenchConfig* config);
+
+// Reproducción de trazas y medición
+bool runTraceFile(MemorySimulator* sim, const char* path, bool compact_on_fail, TraceReport* report,
+                  TraceCheckpoint* checkpoint);
+int parseTraceLine(char* line, MemoryUnit unit, uint64_t line_number, TraceOp* op);
+bool parseCount(const char* text, uint64_t* value);
+bool executeTraceOp(MemorySimulator* sim, const TraceOp* op, bool compact_on_fail, TraceReport* report);
+bool loadTrace(const char* path, MemoryUnit unit, TraceProgram* program);
+void freeTrace(TraceProgram* program);
+bool writeSnapshot(MemorySimulator* sim, const char* path, uint64_t trace_line);
+
+// Generador sintético de carga
+bool parseDistribution(const char* spec, MemoryUnit unit, MemSize max, Distribution* dist);
+uint64_t sampleDistribution(const Distribution* dist, uint64_t* rng);
+void formatProcessName(uint64_t id, char* name);
+bool departureHeapPush(DepartureHeap* heap, uint64_t time, uint64_t name_id);
+Departure departureHeapPop(DepartureHeap* heap);
+void departureHeapFree(DepartureHeap* heap);
+void generatorInit(WorkloadGenerator* gen, const Distribution* sizes, const Distribution* lifetimes, uint64_t seed);
+void generatorNext(WorkloadGenerator* gen, TraceOp* op);
+bool generatorAdmit(WorkloadGenerator* gen, const TraceOp* op);
+void generatorFree(WorkloadGenerator* gen);
+bool runGeneratedWorkload(MemorySimulator* sim, WorkloadGenerator* gen, uint64_t events,
+                          bool compact_on_fail, TraceReport* report);
+
+// Simulación por eventos discretos
+bool arrivalNext(ArrivalSource* source, uint64_t* time, MemSize* size, uint64_t* duration, uint32_t* priority);
+bool runTimedSimulation(MemorySimulator* sim, ArrivalSource* source, uint64_t max_events, uint64_t horizon,
+                        bool compact_on_fail, AdmissionQueue* queue, TimedReport* report);
+void printTimedReport(MemorySimulator* sim, const TimedReport* report, const AdmissionQueue* queue);
+
+// Memoria virtual paginada
+bool parseReplacementPolicies(const char* text, bool* policies);
+const char* replacementPolicyName(ReplacementPolicy policy);
+bool pagerInit(Pager* pager, ReplacementPolicy policy, const PagingConfig* config);
+bool pagerAccess(Pager* pager, uint32_t pid, uint64_t vpn, bool write);
+void pagerFree(Pager* pager);
+bool runPagingTrace(const char* path, const PagingConfig* config);
+
+// Barrido de configuraciones en paralelo
+bool parseSweepGrid(const char* spec, MemoryUnit unit, MemSize default_memory, PlacementPolicy default_policy,
+                    SweepConfig** configs, size_t* count);
+void runSweepConfig(const TraceProgram* trace, const SweepConfig* config, bool compact_on_fail,
+                    TraceReport* report, SweepResult* result);
+bool runSweep(const char* trace_path, const char* grid, MemoryUnit unit, MemSize default_memory,
+              PlacementPolicy default_policy, bool compact_on_fail, int jobs, const char* csv_path);
+void printTraceReport(MemorySimulator* sim, const TraceReport* report);
+void printUsage(const char* program);
+
+int main(int argc, char* argv[]) {
+    MemSize memory_size = DEFAULT_MEMORY_SIZE;
+    const char* memory_text = NULL;
+    MemoryUnit unit = UNIT_MB;
+    const char* trace_path = NULL;
+    PlacementPolicy placement = PLACEMENT_FIRST_FIT;
+    bool compact_on_fail = false;
+    uint64_t scale_blocks = 0;
+    bool bench_scan = false;
+    int bench_threads = 0;
+    bool bench_suite = false;
+    BenchConfig bench = { BENCH_DEFAULT_MAX_BLOCKS, BENCH_DEFAULT_REPETITIONS, BENCH_DEFAULT_THRESHOLD,
+                          PLACEMENT_FIRST_FIT, NULL, NULL };
+    int arena_count = 0;
+    const char* sweep_trace = NULL;
+    const char* sweep_grid = "";
+    const char* csv_path = NULL;
+    int jobs = 0;
+    uint64_t generate_events = 0;
+    const char* size_spec = "exp:4";
+    const char* lifetime_spec = "exp:10";
+    uint64_t seed = 1;
+    uint64_t des_events = 0;
+    uint64_t horizon = 0;
+    const char* interarrival_spec = "exp:1";
+    const char* arrivals_path = NULL;
+    const char* priority_spec = NULL;
+    bool use_queue = false;
+    QueueDiscipline discipline = QUEUE_FIFO;
+    const char* layout_text = NULL;
+    const char* restore_path = NULL;
+    const char* save_path = NULL;
+    const char* export_path = NULL;
+    const char* stats_path = NULL;
+    const char* paging_path = NULL;
+    const char* page_size_text = "4K";
+    const char* replace_spec = "fifo,lru,clock,aging";
+    PagingConfig paging = { 0, 0, DEFAULT_TLB_ENTRIES, DEFAULT_AGING_INTERVAL, { false } };
+    bool show_map = true;           // Mostrar el mapa después de cada operación del menú
+    bool resume = false;
+    bool policy_given = false;
+    TraceCheckpoint checkpoint = { 0, "checkpoint", 0, 0, 0 };
+    
+    // Procesar argumentos de línea de comandos
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace_path = argv[++i];
+        } else if (strcmp(argv[i], "--memory") == 0 && i + 1 < argc) {
+            memory_text = argv[++i];  // Se interpreta al final, cuando ya se conoce la unidad
+        } else if (strcmp(argv[i], "--unit") == 0 && i + 1 < argc) {
+            if (!parseMemoryUnit(argv[++i], &unit)) {
+                fprintf(stderr, "Error: Unidad desconocida '%s'.\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--scale-check") == 0 && i + 1 < argc) {
+            scale_blocks = strtoull(argv[++i], NULL, 10);
+            if (scale_blocks == 0) {
+                fprintf(stderr, "Error: La cantidad de bloques debe ser mayor que cero.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--bench-scan") == 0) {
+            bench_scan = true;
+        } else if (strcmp(argv[i], "--bench-threads") == 0 && i + 1 < argc) {
+            bench_threads = atoi(argv[++i]);
+            if (bench_threads <= 0) {
+                fprintf(stderr, "Error: La cantidad de hilos debe ser mayor que cero.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--bench-suite") == 0) {
+            bench_suite = true;
+        } else if (strcmp(argv[i], "--bench-json") == 0 && i + 1 < argc) {
+            bench.json_path = argv[++i];
+        } else if (strcmp(argv[i], "--bench-baseline") == 0 && i + 1 < argc) {
+            bench.baseline_path = argv[++i];
+        } else if (strcmp(argv[i], "--bench-reps") == 0 && i + 1 < argc) {
+            bench.repetitions = atoi(argv[++i]);
+            if (bench.repetitions <= 0) {
+                fprintf(stderr, "Error: La cantidad de repeticiones debe ser mayor que cero.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--bench-max-blocks") == 0 && i + 1 < argc) {
+            bench.max_blocks = strtoull(argv[++i], NULL, 10);
+            if (bench.max_blocks < 10) {
+                fprintf(stderr, "Error: La cantidad máxima de bloques debe ser al menos 10.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--bench-threshold") == 0 && i + 1 < argc) {
+            bench.threshold = atof(argv[++i]) / 100.0;
+            if (bench.threshold <= 0) {
+                fprintf(stderr, "Error: El umbral de regresión debe ser un porcentaje mayor que cero.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--arenas") == 0 && i + 1 < argc) {
+            arena_count = atoi(argv[++i]);
+            if (arena_count <= 0) {
+                fprintf(stderr, "Error: La cantidad de arenas debe ser mayor que cero.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--sweep") == 0 && i + 1 < argc) {
+            sweep_trace = argv[++i];
+        } else if (strcmp(argv[i], "--grid") == 0 && i + 1 < argc) {
+            sweep_grid = argv[++i];
+        } else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+            csv_path = argv[++i];
+        } else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+            jobs = atoi(argv[++i]);
+            if (jobs <= 0) {
+                fprintf(stderr, "Error: La cantidad de hilos debe ser mayor que cero.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--generate") == 0 && i + 1 < argc) {
+            generate_events = strtoull(argv[++i], NULL, 10);
+            if (generate_events == 0) {
+                fprintf(stderr, "Error: La cantidad de eventos debe ser mayor que cero.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--sizes") == 0 && i + 1 < argc) {
+            size_spec = argv[++i];
+        } else if (strcmp(argv[i], "--lifetime") == 0 && i + 1 < argc) {
+            lifetime_spec = argv[++i];
+        } else if (strcmp(argv[i], "--des") == 0 && i + 1 < argc) {
+            des_events = strtoull(argv[++i], NULL, 10);
+            if (des_events == 0) {
+                fprintf(stderr, "Error: La cantidad de eventos debe ser mayor que cero.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--horizon") == 0 && i + 1 < argc) {
+            horizon = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--interarrival") == 0 && i + 1 < argc) {
+            interarrival_spec = argv[++i];
+        } else if (strcmp(argv[i], "--arrivals") == 0 && i + 1 < argc) {
+            arrivals_path = argv[++i];
+        } else if (strcmp(argv[i], "--queue") == 0 && i + 1 < argc) {
+            if (!parseQueueDiscipline(argv[++i], &discipline)) {
+                fprintf(stderr, "Error: Disciplina de cola desconocida '%s'.\n", argv[i]);
+                return 1;
+            }
+            use_queue = true;
+        } else if (strcmp(argv[i], "--priorities") == 0 && i + 1 < argc) {
+            priority_spec = argv[++i];
+        } else if (strcmp(argv[i], "--layout") == 0 && i + 1 < argc) {
+            layout_text = argv[++i];
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--restore") == 0 && i + 1 < argc) {
+            restore_path = argv[++i];
+        } else if (strcmp(argv[i], "--resume") == 0) {
+            resume = true;
+        } else if (strcmp(argv[i], "--save") == 0 && i + 1 < argc) {
+            save_path = argv[++i];
+        } else if (strcmp(argv[i], "--export-map") == 0 && i + 1 < argc) {
+            export_path = argv[++i];
+        } else if (strcmp(argv[i], "--stats-dump") == 0 && i + 1 < argc) {
+            stats_path = argv[++i];
+        } else if (strcmp(argv[i], "--paging") == 0 && i + 1 < argc) {
+            paging_path = argv[++i];
+        } else if (strcmp(argv[i], "--page-size") == 0 && i + 1 < argc) {
+            page_size_text = argv[++i];
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            uint64_t frames;
+            if (!parseCount(argv[++i], &frames) || frames > UINT32_MAX) {
+                fprintf(stderr, "Error: Cantidad de marcos inválida '%s'.\n", argv[i]);
+                return 1;
+            }
+            paging.frame_count = (uint32_t) frames;
+        } else if (strcmp(argv[i], "--tlb") == 0 && i + 1 < argc) {
+            uint64_t entries;
+            if (!parseCount(argv[++i], &entries) || entries > UINT32_MAX) {
+                fprintf(stderr, "Error: Cantidad de entradas de la TLB inválida '%s'.\n", argv[i]);
+                return 1;
+            }
+            paging.tlb_entries = (uint32_t) entries;
+        } else if (strcmp(argv[i], "--replace") == 0 && i + 1 < argc) {
+            replace_spec = argv[++i];
+        } else if (strcmp(argv[i], "--aging-interval") == 0 && i + 1 < argc) {
+            paging.aging_interval = strtoull(argv[++i], NULL, 10);
+            if (paging.aging_interval == 0) {
+                fprintf(stderr, "Error: El intervalo de aging debe ser mayor que cero.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--no-map") == 0) {
+            show_map = false;
+        } else if (strcmp(argv[i], "--checkpoint-every") == 0 && i + 1 < argc) {
+            checkpoint.every = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--checkpoint-prefix") == 0 && i + 1 < argc) {
+            checkpoint.prefix = argv[++i];
+        } else if (strcmp(argv[i], "--compact-on-fail") == 0) {
+            compact_on_fail = true;
+        } else if (strcmp(argv[i], "--policy") == 0 && i + 1 < argc) {
+            if (!parsePlacementPolicy(argv[++i], &placement)) {
+                fprintf(stderr, "Error: Política de ubicación desconocida '%s'.\n", argv[i]);
+                return 1;
+            }
+            policy_given = true;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    
+    if (bench_scan) {
+        return runScanBenchmark() ? 0 : 1;
+    }
+    
+    if (bench_suite) {
+        bench.placement = placement;
+        return runBenchmarkSuite(&bench) ? 0 : 1;
+    }
+    
+    if (memory_text != NULL && (!parseMemorySize(memory_text, unit, &memory_size) || memory_size == 0)) {
+        fprintf(stderr, "Error: El tamaño de memoria debe ser mayor que cero.\n");
+        return 1;
+    }
+    
+    if (sweep_trace != NULL) {
+        return runSweep(sweep_trace, sweep_grid, unit, memory_size, placement, compact_on_fail,
+                        jobs, csv_path) ? 0 : 1;
+    }
+    
+    if (paging_path != NULL) {
+        MemSize page_size;
+        if (!parseMemorySize(page_size_text, UNIT_BYTE, &page_size) || page_size == 0 ||
+            (page_size & (page_size - 1)) != 0) {
+            fprintf(stderr, "Error: El tamaño de página debe ser una potencia de dos.\n");
+            return 1;
+        }
+        if (!parseReplacementPolicies(replace_spec, paging.policies)) {
+            fprintf(stderr, "Error: Políticas de reemplazo inválidas '%s' (use fifo,lru,clock,aging).\n",
+                    replace_spec);
+            return 1;
+        }
+        
+        // Sin --frames la memoria física es --memory dividida en páginas
+        paging.page_size = page_size;
+        if (paging.frame_count == 0) {
+            unsigned __int128 frames = (unsigned __int128) memory_size * memoryUnitBytes(unit) / page_size;
+            paging.frame_count = frames > INT32_MAX ? INT32_MAX : (uint32_t) frames;
+        }
+        if (paging.frame_count == 0 || paging.frame_count > INT32_MAX) {
+            fprintf(stderr, "Error: La cantidad de marcos debe estar entre 1 y %d.\n", INT32_MAX);
+            return 1;
+        }
+        return runPagingTrace(paging_path, &paging) ? 0 : 1;
+    }
+    
+    if (bench_threads > 0) {
+        // Sin --memory se reservan 16 MB por hilo, en KB para que los procesos sean chicos
+        if (memory_text == NULL) {
+            unit = UNIT_KB;
+            memory_size = (MemSize) bench_threads * 16384;
+        }
+        return runThreadBenchmark(bench_threads, arena_count > 0 ? arena_count : bench_threads,
+                                  memory_size, unit, placement) ? 0 : 1;
+    }
+    
+    // Las vidas (en asignaciones o en unidades de tiempo) se leen sin conversión de unidad
+    Distribution sizes, lifetimes, interarrival, priorities;
+    bool timed = des_events > 0 || horizon > 0 || arrivals_path != NULL;
+    if ((generate_events > 0 || timed) && !parseDistribution(size_spec, unit, memory_size, &sizes)) {
+        fprintf(stderr, "Error: Distribución de tamaños inválida '%s' (los tamaños no pueden superar la memoria).\n",
+                size_spec);
+        return 1;
+    }
+    if ((generate_events > 0 || timed) &&
+        (!parseDistribution(lifetime_spec, UNIT_BYTE, UINT64_MAX / 4, &lifetimes) ||
+         (lifetimes.kind != DIST_EXPONENTIAL && lifetimes.kind != DIST_FIXED))) {
+        fprintf(stderr, "Error: Distribución de vida inválida '%s' (use exp:MEDIA o fixed:N).\n", lifetime_spec);
+        return 1;
+    }
+    if (timed && !parseDistribution(interarrival_spec, UNIT_BYTE, UINT64_MAX / 4, &interarrival)) {
+        fprintf(stderr, "Error: Distribución de llegadas inválida '%s'.\n", interarrival_spec);
+        return 1;
+    }
+    if (timed && priority_spec != NULL && !parseDistribution(priority_spec, UNIT_BYTE, UINT32_MAX, &priorities)) {
+        fprintf(stderr, "Error: Distribución de prioridades inválida '%s'.\n", priority_spec);
+        return 1;
+    }
+    if ((use_queue || priority_spec != NULL) && !timed) {
+        fprintf(stderr, "Error: --queue y --priorities solo se usan en la simulación por eventos.\n");
+        return 1;
+    }
+    if (layout_text != NULL && restore_path != NULL) {
+        fprintf(stderr, "Error: --layout no se combina con --restore (el snapshot ya trae sus particiones).\n");
+        return 1;
+    }
+    
+    MemorySimulator* simulator;
+    
+    if (restore_path != NULL) {
+        // Partir del estado guardado; --policy permite bifurcar con otra política
+        uint64_t start = monotonicNanos();
+        SimStatus status;
+        simulator = loadSnapshot(restore_path, &checkpoint.skip_lines, &status);
+        if (simulator == NULL) {
+            fprintf(stderr, "Error: No se pudo restaurar '%s': %s.\n", restore_path, simStatusMessage(status));
+            return 1;
+        }
+        printf("Simulador restaurado desde '%s' en %.3f s (%llu %s, %zu nodos, línea de traza %llu).\n",
+               restore_path, (double) (monotonicNanos() - start) / 1e9,
+               (unsigned long long) simulator->total_memory, memoryUnitName(simulator->unit),
+               simulator->pool.live_nodes, (unsigned long long) checkpoint.skip_lines);
+        if (policy_given && setPlacementPolicy(simulator, placement) != SIM_OK) {
+            fprintf(stderr, "Error: %s.\n", simStatusMessage(SIM_ERR_NO_MEMORY));
+        }
+        // Sin --resume la traza se aplica completa sobre el estado restaurado
+        if (!resume) {
+            checkpoint.skip_lines = 0;
+        }
+    } else {
+        simulator = initSimulator(memory_size, unit);
+        if (simulator == NULL || setPlacementPolicy(simulator, placement) != SIM_OK) {
+            fprintf(stderr, "Error: No se pudo asignar memoria para el simulador.\n");
+            if (simulator != NULL) freeSimulator(simulator);
+            return 1;
+        }
+        printf("Simulador inicializado con %llu %s de memoria.\n",
+               (unsigned long long) memory_size, memoryUnitName(unit));
+        
+        if (layout_text != NULL) {
+            if (!applyPartitionLayout(simulator, layout_text)) {
+                freeSimulator(simulator);
+                return 1;
+            }
+            printPartitionMode(simulator);
+        }
+    }
+    
+    // Validación a gran escala: millones de bloques vivos y memoria usada por bloque
+    if (scale_blocks > 0) {
+        bool ok = runScaleCheck(simulator, scale_blocks);
+        freeSimulator(simulator);
+        return ok ? 0 : 1;
+    }
+    
+    // Simulación por eventos discretos: llegadas con duración y salidas en orden de tiempo
+    if (timed) {
+        ArrivalSource source;
+        TimedReport report;
+        AdmissionQueue* queue = NULL;
+        
+        memset(&source, 0, sizeof(ArrivalSource));
+        source.interarrival = interarrival;
+        source.sizes = sizes;
+        source.durations = lifetimes;
+        source.has_priorities = priority_spec != NULL;
+        if (source.has_priorities) {
+            source.priorities = priorities;
+        }
+        source.rng = seed != 0 ? seed : 0x9E3779B97F4A7C15ULL;
+        source.unit = unit;
+        
+        if (arrivals_path != NULL && (source.file = fopen(arrivals_path, "r")) == NULL) {
+            fprintf(stderr, "Error: No se pudo abrir el archivo de llegadas '%s'.\n", arrivals_path);
+            freeSimulator(simulator);
+            return 1;
+        }
+        if (use_queue && (queue = admissionQueueCreate(discipline)) == NULL) {
+            fprintf(stderr, "Error: No se pudo asignar memoria para la cola de admisión.\n");
+            if (source.file != NULL) fclose(source.file);
+            freeSimulator(simulator);
+            return 1;
+        }
+        // Sin límites, las llegadas generadas no terminarían nunca
+        if (arrivals_path == NULL && des_events == 0 && horizon == 0) {
+            des_events = 1000000;
+        }
+        
+        bool ok = runTimedSimulation(simulator, &source, des_events, horizon, compact_on_fail, queue, &report);
+        
+        if (ok) {
+            printTimedReport(simulator, &report, queue);
+            if (source.invalid_lines > 0) {
+                printf("Líneas inválidas en el archivo de llegadas: %llu\n",
+                       (unsigned long long) source.invalid_lines);
+            }
+        }
+        if (stats_path != NULL) {
+            dumpInstrumentation(simulator, stats_path);
+        }
+        
+        if (source.file != NULL) {
+            fclose(source.file);
+        }
+        admissionQueueFree(queue);
+        freeSimulator(simulator);
+        return ok ? 0 : 1;
+    }
+    
+    // Carga sintética: los eventos se generan a medida que se ejecutan
+    if (generate_events > 0) {
+        WorkloadGenerator gen;
+        TraceReport* report = (TraceReport*) calloc(1, sizeof(TraceReport));
+        if (report == NULL) {
+            printf("Error: No se pudo asignar memoria para el reporte.\n");
+            freeSimulator(simulator);
+            return 1;
+        }
+        
+        generatorInit(&gen, &sizes, &lifetimes, seed);
+        bool ok = runGeneratedWorkload(simulator, &gen, generate_events, compact_on_fail, report);
+        
+        if (ok) {
+            printTraceReport(simulator, report);
+            printf("Carga generada: %llu llegadas, %llu salidas, %zu procesos vivos "
+                   "(heap de salidas: %zu entradas reservadas)\n",
+                   (unsigned long long) gen.allocations, (unsigned long long) gen.frees,
+                   gen.departures.count, gen.departures.capacity);
+            if (save_path != NULL && writeSnapshot(simulator, save_path, 0)) {
+                printf("Estado final guardado en '%s'.\n", save_path);
+            }
+            if (export_path != NULL && exportMemoryMap(simulator, export_path)) {
+                printf("Mapa de memoria exportado a '%s'.\n", export_path);
+            }
+        }
+        if (stats_path != NULL) {
+            dumpInstrumentation(simulator, stats_path);
+        }
+        
+        generatorFree(&gen);
+        free(report);
+        freeSimulator(simulator);
+        return ok ? 0 : 1;
+    }
+    
+    // Modo no interactivo: reproducir la traza y reportar resultados
+    if (trace_path != NULL) {
+        TraceReport* report = (TraceReport*) calloc(1, sizeof(TraceReport));
+        
+        if (report == NULL) {
+            printf("Error: No se pudo asignar memoria para el reporte.\n");
+            freeSimulator(simulator);
+            return 1;
+        }
+        
+        bool ok = runTraceFile(simulator, trace_path, compact_on_fail, report, &checkpoint);
+        
+        if (ok) {
+            printTraceReport(simulator, report);
+            if (checkpoint.written > 0) {
+                printf("Checkpoints escritos: %llu (%s.<línea>.snap)\n",
+                       (unsigned long long) checkpoint.written, checkpoint.prefix);
+            }
+            if (save_path != NULL && writeSnapshot(simulator, save_path, checkpoint.last_line)) {
+                printf("Estado final guardado en '%s'.\n", save_path);
+            }
+            if (export_path != NULL && exportMemoryMap(simulator, export_path)) {
+                printf("Mapa de memoria exportado a '%s'.\n", export_path);
+            }
+        }
+        if (stats_path != NULL) {
+            dumpInstrumentation(simulator, stats_path);
+        }
+        
+        free(report);
+        freeSimulator(simulator);
+        return ok ? 0 : 1;
+    }
+    
+    int choice;
+    bool running = true;
+    
+    while (running) {
+        displayMenu();
+        printf("\nIngrese su opción: ");
+        scanf("%d", &choice);
+        getchar(); // Consumir el carácter de nueva línea
+        
+        switch (choice) {
+            case 1: {
+                int partition_type;
+                printf("\nSeleccione el tipo de partición:\n");
+                printf("1. Particiones Fijas\n");
+                printf("2. Particiones Dinámicas\n");
+                printf("3. Sistema Buddy\n");
+                printf("4. Mapa de bits\n");
+                printf("Ingrese su opción: ");
+                scanf("%d", &partition_type);
+                
+                SimStatus status = SIM_ERR_INVALID_ARGUMENT;
+                if (partition_type == 1) {
+                    char layout[MAX_TRACE_LINE];
+                    printf("Ingrese el número de particiones fijas o sus tamaños (ej. 4x16,2x64 o @archivo): ");
+                    scanf("%255s", layout);
+                    
+                    // Un número solo es la cantidad de particiones iguales
+                    if (layout[strspn(layout, "0123456789")] == '\0') {
+                        long num_partitions = strtol(layout, NULL, 10);
+                        status = setPartitionMode(simulator, FIXED_PARTITIONS,
+                                                  num_partitions > INT32_MAX ? INT32_MAX : (int) num_partitions);
+                    } else if (applyPartitionLayout(simulator, layout)) {
+                        status = SIM_OK;
+                    } else {
+                        break;
+                    }
+                } else if (partition_type == 2) {
+                    status = setPartitionMode(simulator, DYNAMIC_PARTITIONS, 0);
+                } else if (partition_type == 3) {
+                    status = setPartitionMode(simulator, BUDDY_PARTITIONS, 0);
+                } else if (partition_type == 4) {
+                    int chunk;
+                    printf("Ingrese las unidades de memoria por bit (0 = automático): ");
+                    scanf("%d", &chunk);
+                    status = setPartitionMode(simulator, BITMAP_PARTITIONS, chunk < 0 ? 0 : chunk);
+                } else {
+                    printf("Opción inválida.\n");
+                    break;
+                }
+                
+                if (status == SIM_OK) {
+                    printPartitionMode(simulator);
+                } else {
+                    printf("Error: %s.\n", simStatusMessage(status));
+                }
+                break;
+            }
+            case 2: {
+                char process_name[MAX_PROCESS_NAME];
+                char size_text[32];
+                MemSize process_size;
+                
+                printf("\nIngrese el nombre del proceso: ");
+                scanf("%s", process_name);
+                printf("Ingrese el tamaño del proceso (en %s): ", memoryUnitName(simulator->unit));
+                scanf("%31s", size_text);
+                
+                if (!parseMemorySize(size_text, simulator->unit, &process_size)) {
+                    printf("\nTamaño inválido '%s'.\n", size_text);
+                    break;
+                }
+                
+                SimStatus status = allocateProcess(simulator, process_name, process_size);
+                if (status == SIM_OK) {
+                    printf("\nProceso '%s' cargado exitosamente.\n", process_name);
+                } else {
+                    printf("\nNo se pudo cargar el proceso '%s'.\n", process_name);
+                    printAllocationError(simulator, status, process_name);
+                }
+                
+                if (show_map) {
+                    displayMemoryMap(simulator);
+                }
+                break;
+            }
+            case 3: {
+                char process_name[MAX_PROCESS_NAME];
+                
+                printf("\nIngrese el nombre del proceso a liberar: ");
+                scanf("%s", process_name);
+                
+                if (deallocateProcess(simulator, process_name) == SIM_OK) {
+                    printf("\nProceso '%s' liberado exitosamente.\n", process_name);
+                } else {
+                    printf("\nNo se encontró el proceso '%s'.\n", process_name);
+                }
+                
+                if (show_map) {
+                    displayMemoryMap(simulator);
+                }
+                break;
+            }
+            case 4: {
+                MemSize internal_frag, external_frag;
+                calculateFragmentation(simulator, &internal_frag, &external_frag);
+                
+                MemoryStats stats;
+                getMemoryStats(simulator, &stats);
+                
+                const char* unit_name = memoryUnitName(simulator->unit);
+                printf("\nFragmentación:\n");
+                printf("- Fragmentación interna: %llu %s\n", (unsigned long long) internal_frag, unit_name);
+                printf("- Fragmentación externa: %llu %s\n", (unsigned long long) external_frag, unit_name);
+                printf("- Bloques libres: %llu (mayor: %llu %s, índice de fragmentación: %.2f)\n",
+                       (unsigned long long) stats.free_blocks, (unsigned long long) stats.largest_free_block,
+                       unit_name, stats.external_ratio);
+                break;
+            }
+            case 5: {
+                if (show_map) {
+                    printf("\nEstado de la memoria antes de la compactación:\n");
+                    displayMemoryMap(simulator);
+                }
+                
+                CompactionResult result;
+                if (compactMemory(simulator, &result) == SIM_OK) {
+                    printf("Memoria compactada exitosamente (%llu %s movidos en %llu bloques).\n",
+                           (unsigned long long) result.size_moved, memoryUnitName(simulator->unit),
+                           (unsigned long long) result.blocks_moved);
+                } else {
+                    printf("La compactación solo es aplicable al modo de particiones dinámicas.\n");
+                }
+                
+                if (show_map) {
+                    printf("\nEstado de la memoria después de la compactación:\n");
+                    displayMemoryMap(simulator);
+                }
+                break;
+            }
+            case 6: {
+                displayMemoryMap(simulator);
+                break;
+            }
+            case 7: {
+                int policy_choice;
+                printf("\nSeleccione la política de ubicación (actual: %s):\n",
+                       placementPolicyName(simulator->placement));
+                printf("1. First-Fit\n");
+                printf("2. Next-Fit\n");
+                printf("3. Best-Fit\n");
+                printf("4. Worst-Fit\n");
+                printf("5. Listas segregadas (TLSF)\n");
+                printf("6. First-Fit por escaneo vectorizado (tabla contigua)\n");
+                printf("Ingrese su opción: ");
+                scanf("%d", &policy_choice);
+                
+                if (policy_choice >= 1 && policy_choice <= 6) {
+                    if (setPlacementPolicy(simulator, (PlacementPolicy) (policy_choice - 1)) != SIM_OK) {
+                        printf("Error: %s.\n", simStatusMessage(SIM_ERR_NO_MEMORY));
+                    }
+                    printf("Política de ubicación establecida: %s\n",
+                           placementPolicyName(simulator->placement));
+                } else {
+                    printf("Opción inválida.\n");
+                }
+                break;
+            }
+            case 8: {
+                show_map = !show_map;
+                printf("\nMapa después de cada operación: %s\n", show_map ? "activado" : "desactivado");
+                break;
+            }
+            case 9: {
+                char path[256];
+                
+                printf("\nIngrese el archivo de salida (.csv o .json): ");
+                scanf("%255s", path);
+                
+                if (exportMemoryMap(simulator, path)) {
+                    printf("Mapa de memoria exportado a '%s'.\n", path);
+                }
+                break;
+            }
+            case 10: {
+                printInstrumentation(stdout, simulator);
+                break;
+            }
+            case 0: {
+                running = false;
+                break;
+            }
+            default:
+                printf("\nOpción inválida.\n");
+        }
+    }
+    
+    if (stats_path != NULL) {
+        dumpInstrumentation(simulator, stats_path);
+    }
+    freeSimulator(simulator);
+    printf("\nSimulador finalizado.\n");
+    
+    return 0;
+}
+
+// Garantiza lugar para extra bytes más el '\0' final
+static bool textBufferReserve(TextBuffer* buf, size_t extra) {
+    if (buf->failed) {
+        return false;
+    }
+    
+    if (buf->length + extra + 1 <= buf->capacity) {
+        return true;
+    }
+    
+    size_t capacity = buf->capacity > 0 ? buf->capacity : 4096;
+    while (capacity < buf->length + extra + 1) {
+        capacity *= 2;
+    }
+    
+    char* data = (char*) realloc(buf->data, capacity);
+    if (data == NULL) {
+        buf->failed = true;
+        return false;
+    }
+    
+    buf->data = data;
+    buf->capacity = capacity;
+    return true;
+}
+
+// Agrega texto con formato al final del buffer
+void textBufferAppend(TextBuffer* buf, const char* format, ...) {
+    va_list args;
+    
+    // Primer intento con el lugar que ya hay; casi siempre alcanza
+    va_start(args, format);
+    size_t room = buf->capacity > buf->length ? buf->capacity - buf->length : 0;
+    int written = vsnprintf(room > 0 ? buf->data + buf->length : NULL, room, format, args);
+    va_end(args);
+    
+    if (written < 0) {
+        buf->failed = true;
+        return;
+    }
+    
+    if ((size_t) written >= room) {
+        if (!textBufferReserve(buf, (size_t) written)) {
+            return;
+        }
+        va_start(args, format);
+        vsnprintf(buf->data + buf->length, (size_t) written + 1, format, args);
+        va_end(args);
+    }
+    
+    buf->length += (size_t) written;
+}
+
+// Agrega count copias del carácter ch
+void textBufferRepeat(TextBuffer* buf, char ch, size_t count) {
+    if (!textBufferReserve(buf, count)) {
+        return;
+    }
+    
+    memset(buf->data + buf->length, ch, count);
+    buf->length += count;
+    buf->data[buf->length] = '\0';
+}
+
+// Libera el texto acumulado
+void textBufferFree(TextBuffer* buf) {
+    free(buf->data);
+    buf->data = NULL;
+    buf->length = 0;
+    buf->capacity = 0;
+}
+
+// Lista de bloques a mostrar: en modo mapa de bits se arma una temporal con procesos y huecos
+static MemoryBlock* memoryMapBlocks(MemorySimulator* sim, MemoryBlock** gaps) {
+    *gaps = NULL;
+    if (sim->partition_type == BITMAP_PARTITIONS) {
+        return bitmapBuildMap(sim, gaps);
+    }
+    return sim->memory_map;
+}
+
+// Tabla y barra con un renglón y un tramo por bloque
+static void renderBlockMap(MemorySimulator* sim, MemoryBlock* map, TextBuffer* buf) {
+    const char* unit_name = memoryUnitName(sim->unit);
+    
+    textBufferAppend(buf, "Dirección\tTamaño\tEstado\t\tProceso\n");
+    textBufferAppend(buf, "--------------------------------------------------------------\n");
+    
+    for (MemoryBlock* current = map; current != NULL; current = current->next) {
+        textBufferAppend(buf, "%4llu %s\t\t%4llu %s\t%s\t\t%s\n", 
+                         (unsigned long long) current->start_address, unit_name,
+                         (unsigned long long) current->size, unit_name,
+                         current->status == FREE ? "LIBRE" : "OCUPADO",
+                         current->status == FREE ? "-" : current->process_name);
+    }
+    
+    textBufferAppend(buf, "--------------------------------------------------------------\n");
+    
+    // Representación gráfica
+    textBufferAppend(buf, "\nRepresentación gráfica de la memoria:\n");
+    textBufferAppend(buf, "[");
+    
+    for (MemoryBlock* current = map; current != NULL; current = current->next) {
+        // Tramos proporcionales al tamaño (producto en 128 bits: no desborda)
+        MemSize block_chars = (MemSize) ((unsigned __int128) current->size * MAP_DISPLAY_WIDTH / sim->total_memory);
+        if (block_chars < 1) block_chars = 1;
+        
+        textBufferRepeat(buf, current->status == FREE ? '.' : '#', (size_t) block_chars);
+        
+        if (current->next != NULL) {
+            textBufferRepeat(buf, '|', 1);
+        }
+    }
+    
+    textBufferAppend(buf, "]\n");
+    textBufferAppend(buf, "Leyenda: [.] = Libre, [#] = Ocupado\n\n");
+}
+
+// Vista reducida: cada columna agrega la ocupación de un tramo fijo de direcciones.
+// Cada bloque visita solo las columnas que toca, así que el costo es O(bloques + columnas)
+static void renderColumnMap(MemorySimulator* sim, MemoryBlock* map, uint64_t block_count, TextBuffer* buf) {
+    const char* unit_name = memoryUnitName(sim->unit);
+    MemSize total = sim->total_memory;
+    MemSize occupied[MAP_DISPLAY_WIDTH] = { 0 };
+    uint64_t blocks[MAP_DISPLAY_WIDTH] = { 0 };
+    
+    for (MemoryBlock* current = map; current != NULL; current = current->next) {
+        MemSize start = current->start_address;
+        MemSize end = start + current->size;
+        size_t first = (size_t) ((unsigned __int128) start * MAP_DISPLAY_WIDTH / total);
+        blocks[first]++;
+        
+        if (current->status == FREE) {
+            continue;
+        }
+        
+        size_t last = (size_t) ((unsigned __int128) (end - 1) * MAP_DISPLAY_WIDTH / total);
+        for (size_t column = first; column <= last; column++) {
+            MemSize low = (MemSize) ((unsigned __int128) total * column / MAP_DISPLAY_WIDTH);
+            MemSize high = (MemSize) ((unsigned __int128) total * (column + 1) / MAP_DISPLAY_WIDTH);
+            occupied[column] += (end < high ? end : high) - (start > low ? start : low);
+        }
+    }
+    
+    textBufferAppend(buf, "%llu bloques: se muestran agrupados en %d columnas\n",
+                     (unsigned long long) block_count, MAP_DISPLAY_WIDTH);
+    textBufferAppend(buf, "Columna\tDesde\t\tHasta\t\tOcupado\tBloques\n");
+    textBufferAppend(buf, "--------------------------------------------------------------\n");
+    
+    char bar[MAP_DISPLAY_WIDTH];
+    for (size_t column = 0; column < MAP_DISPLAY_WIDTH; column++) {
+        MemSize low = (MemSize) ((unsigned __int128) total * column / MAP_DISPLAY_WIDTH);
+        MemSize high = (MemSize) ((unsigned __int128) total * (column + 1) / MAP_DISPLAY_WIDTH);
+        double ratio = (double) occupied[column] / (double) (high - low);
+        
+        textBufferAppend(buf, "%4zu\t%4llu %s\t%4llu %s\t%5.1f%%\t%llu\n", column,
+                         (unsigned long long) low, unit_name, (unsigned long long) high, unit_name,
+                         ratio * 100.0, (unsigned long long) blocks[column]);
+        
+        if (occupied[column] == 0) {
+            bar[column] = '.';
+        } else if (occupied[column] == high - low) {
+            bar[column] = '#';
+        } else {
+            bar[column] = ratio < 1.0 / 3.0 ? '-' : (ratio < 2.0 / 3.0 ? '+' : '=');
+        }
+    }
+    
+    textBufferAppend(buf, "--------------------------------------------------------------\n");
+    textBufferAppend(buf, "\nRepresentación gráfica de la memoria:\n");
+    textBufferAppend(buf, "[%.*s]\n", MAP_DISPLAY_WIDTH, bar);
+    textBufferAppend(buf, "Leyenda: [.] = Libre, [-] < 1/3, [+] < 2/3, [=] < 100%%, [#] = Ocupado\n\n");
+}
+
+// Arma en buf el texto del mapa de memoria actual; con más bloques que columnas se muestra
+// la ocupación agrupada por columnas
+void renderMemoryMap(MemorySimulator* sim, TextBuffer* buf) {
+    const char* unit_name = memoryUnitName(sim->unit);
+    MemoryBlock* gaps;
+    MemoryBlock* map = memoryMapBlocks(sim, &gaps);
+    
+    uint64_t block_count = 0;
+    for (MemoryBlock* current = map; current != NULL; current = current->next) {
+        block_count++;
+    }
+    
+    textBufferAppend(buf, "\n=== Estado actual de la memoria (%llu %s total, ", (unsigned long long) sim->total_memory,
+                     unit_name);
+    if (sim->usable_memory < sim->total_memory) {
+        textBufferAppend(buf, "%llu %s asignables, ", (unsigned long long) sim->usable_memory, unit_name);
+    }
+    textBufferAppend(buf, "%llu %s disponible) ===\n", (unsigned long long) sim->available_memory, unit_name);
+    
+    if (block_count > MAP_DISPLAY_WIDTH) {
+        renderColumnMap(sim, map, block_count, buf);
+    } else {
+        renderBlockMap(sim, map, buf);
+    }
+    free(gaps);
+}
+
+// Muestra el mapa de memoria con una sola escritura
+void displayMemoryMap(MemorySimulator* sim) {
+    TextBuffer buf = { NULL, 0, 0, false };
+    
+    renderMemoryMap(sim, &buf);
+    if (buf.failed) {
+        printf("\nError: No se pudo asignar memoria para mostrar el mapa.\n");
+    } else {
+        fwrite(buf.data, 1, buf.length, stdout);
+    }
+    textBufferFree(&buf);
+}
+
+// Escribe s entre comillas y con los caracteres especiales escapados (JSON o CSV)
+static void exportQuoted(FILE* out, const char* s, bool json) {
+    fputc('"', out);
+    for (; *s != '\0'; s++) {
+        unsigned char ch = (unsigned char) *s;
+        if (!json) {
+            if (ch == '"') {
+                fputc('"', out);
+            }
+            fputc(ch, out);
+        } else if (ch == '"' || ch == '\\') {
+            fprintf(out, "\\%c", ch);
+        } else if (ch < 0x20) {
+            fprintf(out, "\\u%04x", ch);
+        } else {
+            fputc(ch, out);
+        }
+    }
+    fputc('"', out);
+}
+
+// Exporta el mapa de memoria para herramientas externas: JSON si path termina en
+// ".json", CSV (un bloque por fila) en otro caso
+bool exportMemoryMap(MemorySimulator* sim, const char* path) {
+    size_t length = strlen(path);
+    bool json = length >= 5 && strcmp(path + length - 5, ".json") == 0;
+    
+    FILE* out = fopen(path, "w");
+    if (out == NULL) {
+        printf("Error: No se pudo crear '%s': %s\n", path, strerror(errno));
+        return false;
+    }
+    
+    MemoryBlock* gaps;
+    MemoryBlock* map = memoryMapBlocks(sim, &gaps);
+    
+    if (json) {
+        fprintf(out, "{\"unit\":\"%s\",\"total\":%llu,\"usable\":%llu,\"available\":%llu,\"mode\":\"%s\","
+                     "\"policy\":\"%s\",\"blocks\":[",
+                memoryUnitName(sim->unit), (unsigned long long) sim->total_memory,
+                (unsigned long long) sim->usable_memory, (unsigned long long) sim->available_memory,
+                partitionTypeName(sim->partition_type),
+                placementPolicyName(sim->placement));
+    } else {
+        fprintf(out, "address,size,status,process,requested\n");
+    }
+    
+    for (MemoryBlock* current = map; current != NULL; current = current->next) {
+        bool free_block = current->status == FREE;
+        
+        if (json) {
+            fprintf(out, "%s\n{\"address\":%llu,\"size\":%llu,\"status\":\"%s\",\"process\":",
+                    current == map ? "" : ",", (unsigned long long) current->start_address,
+                    (unsigned long long) current->size, free_block ? "free" : "occupied");
+            if (free_block) {
+                fprintf(out, "null,\"requested\":0}");
+            } else {
+                exportQuoted(out, current->process_name, true);
+                fprintf(out, ",\"requested\":%llu}", (unsigned long long) current->requested_size);
+            }
+        } else {
+            fprintf(out, "%llu,%llu,%s,", (unsigned long long) current->start_address,
+                    (unsigned long long) current->size, free_block ? "free" : "occupied");
+            if (!free_block) {
+                exportQuoted(out, current->process_name, false);
+            }
+            fprintf(out, ",%llu\n", free_block ? 0ULL : (unsigned long long) current->requested_size);
+        }
+    }
+    
+    if (json) {
+        fprintf(out, "\n]}\n");
+    }
+    free(gaps);
+    
+    // fclose informa los errores de escritura que quedaron en el buffer
+    bool ok = !ferror(out);
+    if (fclose(out) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        printf("Error: No se pudo escribir '%s'.\n", path);
+    }
+    return ok;
+}
+
+// Carga block_count procesos pequeños, libera uno de cada dos y vuelve a ocupar los huecos;
+// luego valida la estructura y reporta tiempos y memoria de metadatos por bloque
+bool runScaleCheck(MemorySimulator* sim, uint64_t block_count) {
+    char name[MAX_PROCESS_NAME];
+    uint64_t seed = 0x2545F4914F6CDD1DULL;
+    uint64_t failures = 0;
+    uint64_t operations = 0;
+    
+    // Fase 1: llenar la memoria con procesos de 1 a 8 unidades (nombres en hexadecimal,
+    // que siempre caben en MAX_PROCESS_NAME)
+    uint64_t start = monotonicNanos();
+    for (uint64_t i = 0; i < block_count; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        snprintf(name, sizeof(name), "s%llx", (unsigned long long) i);
+        if (allocateProcess(sim, name, 1 + (seed & 7)) != SIM_OK) {
+            failures++;
+        }
+        operations++;
+    }
+    uint64_t fill_ns = monotonicNanos() - start;
+    
+    // Fase 2: liberar uno de cada dos para dejar un hueco entre cada par de procesos
+    start = monotonicNanos();
+    for (uint64_t i = 1; i < block_count; i += 2) {
+        snprintf(name, sizeof(name), "s%llx", (unsigned long long) i);
+        deallocateProcess(sim, name);
+        operations++;
+    }
+    uint64_t free_ns = monotonicNanos() - start;
+    
+    // Fase 3: volver a ocupar los huecos con procesos más chicos (quedan restos libres)
+    start = monotonicNanos();
+    for (uint64_t i = 1; i < block_count; i += 2) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        snprintf(name, sizeof(name), "r%llx", (unsigned long long) i);
+        if (allocateProcess(sim, name, 1 + (seed & 3)) != SIM_OK) {
+            failures++;
+        }
+        operations++;
+    }
+    uint64_t refill_ns = monotonicNanos() - start;
+    
+    char problem[SIM_ERROR_TEXT];
+    bool valid = validateSimulator(sim, problem, sizeof(problem));
+    
+    size_t pool_bytes = 0;
+    for (BlockChunk* chunk = sim->pool.first_chunk; chunk != NULL; chunk = chunk->next) {
+        pool_bytes += sizeof(BlockChunk) + chunk->capacity * sizeof(MemoryBlock);
+    }
+    size_t index_bytes = sim->name_index_capacity * sizeof(MemoryBlock*);
+    size_t live = sim->pool.live_nodes;
+    double total_seconds = (double) (fill_ns + free_ns + refill_ns) / 1e9;
+    
+    printf("\n=== Validación a gran escala ===\n");
+    printf("Memoria: %llu %s (%llu bytes por unidad)\n", (unsigned long long) sim->total_memory,
+           memoryUnitName(sim->unit), (unsigned long long) memoryUnitBytes(sim->unit));
+    printf("Operaciones: %llu (asignaciones fallidas: %llu)\n",
+           (unsigned long long) operations, (unsigned long long) failures);
+    printf("Tiempo: carga %.3f s, liberación %.3f s, recarga %.3f s (%.0f ops/s)\n",
+           (double) fill_ns / 1e9, (double) free_ns / 1e9, (double) refill_ns / 1e9,
+           total_seconds > 0 ? (double) operations / total_seconds : 0.0);
+    printf("Bloques vivos: %zu (%zu ocupados, %llu libres)\n",
+           live, sim->name_index_count, (unsigned long long) sim->free_block_count);
+    printf("Metadatos: %zu B por MemoryBlock; pool %.1f MB, índice por nombre %.1f MB\n",
+           sizeof(MemoryBlock), (double) pool_bytes / 1048576.0, (double) index_bytes / 1048576.0);
+    printf("Memoria de metadatos por bloque vivo: %.1f B\n",
+           live > 0 ? (double) (pool_bytes + index_bytes) / (double) live : 0.0);
+    printf("Validación de invariantes: %s\n", valid ? "correcta" : "FALLÓ");
+    if (!valid) {
+        fprintf(stderr, "Inconsistencia: %s\n", problem);
+    }
+    
+    return valid;
+}
+
+// Mide una búsqueda first-fit repetida: recorriendo la lista enlazada (como el simulador
+// original) o escaneando la tabla contigua con la variante indicada (0 = escalar,
+// 1 = SSE4.2, 2 = AVX2). Devuelve los ns por búsqueda y el bloque encontrado.
+static double scanBenchmarkRun(MemorySimulator* sim, int variant, MemSize size, int repetitions,
+                               MemoryBlock** found) {
+    const FreeTable* table = &sim->free_table;
+    uint64_t start = monotonicNanos();
+    
+    for (int r = 0; r < repetitions; r++) {
+        size_t index = table->count;
+        
+        if (variant < 0) {
+            MemoryBlock* block = sim->memory_map;
+            while (block != NULL && (block->status != FREE || block->size < size)) {
+                block = block->next;
+            }
+            *found = block;
+            __asm__ volatile("" : : "r"(block) : "memory");  // Impedir que se elimine el bucle
+            continue;
+        }
+#ifdef FREE_TABLE_SIMD
+        if (variant == 2) index = freeTableScanAvx2(table->size, table->count, size);
+        if (variant == 1) index = freeTableScanSse42(table->size, table->count, size);
+#endif
+        if (variant == 0) index = freeTableScanScalar(table->size, table->count, size);
+        *found = index < table->count ? table->node[index] : NULL;
+        __asm__ volatile("" : : "r"(index) : "memory");
+    }
+    
+    return (double) (monotonicNanos() - start) / repetitions;
+}
+
+// Compara el escaneo first-fit de la lista enlazada con el de la tabla contigua (escalar y
+// SIMD) con 10k, 100k y 1M bloques libres, verificando que todas elijan el mismo bloque
+bool runScanBenchmark(void) {
+    static const uint64_t block_counts[] = { 10000, 100000, 1000000 };
+    static const char* variant_names[] = { "lista", "escalar", "SSE4.2", "AVX2" };
+    bool all_match = true;
+    
+    int supported = 0;
+#ifdef FREE_TABLE_SIMD
+    __builtin_cpu_init();
+    supported = __builtin_cpu_supports("avx2") ? 2 : __builtin_cpu_supports("sse4.2") ? 1 : 0;
+#endif
+    
+    printf("\n=== Escaneo first-fit: lista enlazada vs. tabla contigua ===\n");
+    printf("%-10s %-8s %14s %14s %10s\n", "Libres", "Variante", "ns/búsqueda", "bloques/ns", "Aceleración");
+    printf("--------------------------------------------------------------\n");
+    
+    for (size_t c = 0; c < sizeof(block_counts) / sizeof(block_counts[0]); c++) {
+        uint64_t count = block_counts[c];
+        
+        // Procesos de 1 a 8 bytes alternados con huecos de 1 a 8 bytes; solo el hueco final
+        // (el resto de la memoria) alcanza para 9 bytes, así que cada búsqueda recorre todo
+        MemorySimulator* sim = initSimulator(count * 16 + 64, UNIT_BYTE);
+        if (sim == NULL || setPlacementPolicy(sim, PLACEMENT_FIRST_FIT_SCAN) != SIM_OK) {
+            fprintf(stderr, "Error: %s.\n", simStatusMessage(SIM_ERR_NO_MEMORY));
+            if (sim != NULL) freeSimulator(sim);
+            return false;
+        }
+
+        char name[MAX_PROCESS_NAME];
+        uint64_t seed = 0x9E3779B97F4A7C15ULL;
+        for (uint64_t i = 0; i < 2 * count; i++) {
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            snprintf(name, sizeof(name), "b%llx", (unsigned long long) i);
+            allocateProcess(sim, name, 1 + (seed & 7));
+        }
+        for (uint64_t i = 0; i < 2 * count; i += 2) {
+            snprintf(name, sizeof(name), "b%llx", (unsigned long long) i);
+            deallocateProcess(sim, name);
+        }
+        
+        int repetitions = (int) (20000000 / count);
+        double list_ns = 0;
+        MemoryBlock* expected = NULL;
+        
+        for (int variant = -1; variant <= supported; variant++) {
+            MemoryBlock* found = NULL;
+            scanBenchmarkRun(sim, variant, 9, 1, &found);  // Calentamiento
+            double ns = scanBenchmarkRun(sim, variant, 9, repetitions, &found);
+            
+            if (variant < 0) {
+                list_ns = ns;
+                expected = found;
+            } else if (found != expected) {
+                all_match = false;
+            }
+            
+            printf("%-10llu %-8s %14.0f %14.2f %9.1fx\n", (unsigned long long) sim->free_table.count,
+                   variant_names[variant + 1], ns, (double) sim->free_table.count / ns, list_ns / ns);
+        }
+        
+        // Además, las ubicaciones deben coincidir con la lista para tamaños que sí aparecen
+        for (MemSize size = 1; size <= 9; size++) {
+            MemoryBlock* block = sim->memory_map;
+            while (block != NULL && (block->status != FREE || block->size < size)) {
+                block = block->next;
+            }
+            if (findFreeBlock(sim, size) != block) {
+                all_match = false;
+            }
+        }
+        
+        freeSimulator(sim);
+    }
+    
+    printf("Ubicaciones idénticas a la lista enlazada: %s\n", all_match ? "sí" : "NO");
+    return all_match;
+}
+
+// Trabajo y resultados de un hilo de la medición de escalabilidad
+typedef struct {
+    ConcurrentSimulator* cs;
+    unsigned thread_id;
+    uint64_t operations;        // Operaciones realizadas
+    uint64_t failures;          // Asignaciones que no cupieron en ninguna arena
+    uint64_t spills;            // Asignaciones que terminaron fuera de la arena hogar
+} ThreadWorkload;
+
+// Cuerpo de cada hilo: asigna y libera procesos de 1 a 8 unidades al azar, manteniendo
+// hasta THREAD_BENCH_LIVE procesos vivos propios
+static void* threadBenchmarkWorker(void* argument) {
+    ThreadWorkload* work = (ThreadWorkload*) argument;
+    ConcurrentSimulator* cs = work->cs;
+    int home = (int) (work->thread_id % (unsigned) cs->arena_count);
+    
+    char names[THREAD_BENCH_LIVE][MAX_PROCESS_NAME];
+    int arenas[THREAD_BENCH_LIVE];
+    size_t live = 0;
+    uint64_t seed = 0x9E3779B97F4A7C15ULL * (work->thread_id + 1);
+    
+    for (unsigned counter = 0; counter < THREAD_BENCH_OPS; counter++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        
+        if (live == THREAD_BENCH_LIVE || (live > 0 && (seed & 1) != 0)) {
+            // Liberar uno al azar y llenar su lugar con el último
+            size_t victim = (size_t) ((seed >> 8) % live);
+            concurrentDeallocate(cs, arenas[victim], names[victim]);
+            live--;
+            memcpy(names[victim], names[live], MAX_PROCESS_NAME);
+            arenas[victim] = arenas[live];
+        } else {
+            snprintf(names[live], MAX_PROCESS_NAME, "t%x.%x", work->thread_id, counter);
+            int arena = concurrentAllocate(cs, home, names[live], 1 + ((seed >> 8) & 7));
+            
+            if (arena < 0) {
+                work->failures++;
+            } else {
+                if (arena != home) work->spills++;
+                arenas[live++] = arena;
+            }
+        }
+        work->operations++;
+    }
+    
+    return NULL;
+}
+
+// Mide el rendimiento del modo concurrente con 1 a max_threads hilos sobre arena_count
+// arenas y valida todas las invariantes al terminar cada corrida
+bool runThreadBenchmark(int max_threads, int arena_count, MemSize memory_size, MemoryUnit unit,
+                        PlacementPolicy placement) {
+    pthread_t* threads = (pthread_t*) malloc((size_t) max_threads * sizeof(pthread_t));
+    ThreadWorkload* work = (ThreadWorkload*) malloc((size_t) max_threads * sizeof(ThreadWorkload));
+    bool all_valid = true;
+    double base_throughput = 0;
+    
+    if (threads == NULL || work == NULL) {
+        fprintf(stderr, "Error: No se pudo asignar memoria para la medición.\n");
+        free(threads);
+        free(work);
+        return false;
+    }
+    
+    printf("\n=== Escalabilidad del modo concurrente ===\n");
+    printf("Memoria: %llu %s en %d arenas, política %s, %d operaciones por hilo\n",
+           (unsigned long long) memory_size, memoryUnitName(unit), arena_count,
+           placementPolicyName(placement), THREAD_BENCH_OPS);
+    printf("%-6s %14s %10s %12s %10s %10s %8s\n",
+           "Hilos", "ops/s", "Escala", "Contención", "Desbordes", "Fallos", "Válido");
+    printf("--------------------------------------------------------------------------\n");
+    
+    for (int thread_count = 1; thread_count <= max_threads; thread_count++) {
+        ConcurrentSimulator* cs = concurrentInit(memory_size, unit, arena_count, placement);
+        if (cs == NULL) {
+            fprintf(stderr, "Error: No se pudo crear el simulador concurrente.\n");
+            all_valid = false;
+            break;
+        }
+        
+        uint64_t start = monotonicNanos();
+        int started = 0;
+        for (int t = 0; t < thread_count; t++) {
+            memset(&work[t], 0, sizeof(ThreadWorkload));
+            work[t].cs = cs;
+            work[t].thread_id = (unsigned) t;
+            if (pthread_create(&threads[t], NULL, threadBenchmarkWorker, &work[t]) != 0) {
+                break;
+            }
+            started++;
+        }
+        for (int t = 0; t < started; t++) {
+            pthread_join(threads[t], NULL);
+        }
+        double seconds = (double) (monotonicNanos() - start) / 1e9;
+        
+        uint64_t operations = 0, failures = 0, spills = 0, acquisitions = 0, contended = 0;
+        for (int t = 0; t < started; t++) {
+            operations += work[t].operations;
+            failures += work[t].failures;
+            spills += work[t].spills;
+        }
+        for (int i = 0; i < cs->arena_count; i++) {
+            acquisitions += cs->arenas[i].acquisitions;
+            contended += cs->arenas[i].contended;
+        }
+        
+        char problem[SIM_ERROR_TEXT] = "no arrancaron todos los hilos";
+        bool valid = (started == thread_count) && concurrentValidate(cs, problem, sizeof(problem));
+        all_valid = all_valid && valid;
+        
+        double throughput = seconds > 0 ? (double) operations / seconds : 0.0;
+        if (thread_count == 1) base_throughput = throughput;
+        
+        printf("%-6d %14.0f %9.2fx %11.2f%% %10llu %10llu %8s\n", thread_count, throughput,
+               base_throughput > 0 ? throughput / base_throughput : 0.0,
+               acquisitions > 0 ? 100.0 * (double) contended / (double) acquisitions : 0.0,
+               (unsigned long long) spills, (unsigned long long) failures, valid ? "sí" : "NO");
+        if (!valid) {
+            fprintf(stderr, "Inconsistencia: %s\n", problem);
+        }
+        
+        concurrentFree(cs);
+    }
+    
+    free(threads);
+    free(work);
+    return all_valid;
+}
+
+// Operaciones que mide la batería de microbenchmarks
+typedef enum {
+    BENCH_ALLOC,
+    BENCH_FREE,
+    BENCH_COMPACT,
+    BENCH_FRAGMENTATION,
+    BENCH_MAP,
+    BENCH_OP_COUNT
+} BenchOp;
+
+// Un caso preparado: el simulador y los procesos vivos que contiene
+typedef struct {
+    MemorySimulator* sim;
+    char (*names)[MAX_PROCESS_NAME];
+    MemSize* sizes;
+    size_t live;
+    uint64_t next_name;         // Para generar nombres que no se repiten
+    uint64_t rng;
+} BenchState;
+
+// Resumen de un caso: estadísticas del tiempo por operación de cada repetición
+typedef struct {
+    BenchOp op;
+    PartitionType mode;
+    uint64_t blocks;            // Procesos cargados antes de liberar la fracción de huecos
+    double fragmentation;       // Fracción de esos procesos que se liberó
+    uint64_t ops;               // Operaciones medidas en la última repetición
+    double median_ns;
+    double mean_ns;
+    double stddev_ns;
+    double min_ns;
+    double max_ns;
+} BenchResult;
+
+// Nombre estable de una operación de la batería (clave en el JSON de resultados)
+static const char* benchOpName(BenchOp op) {
+    static const char* names[BENCH_OP_COUNT] = { "alloc", "free", "compact", "fragmentation", "map" };
+    return names[op];
+}
+
+// Siguiente número pseudoaleatorio del caso (xorshift)
+static uint64_t benchRandom(BenchState* state) {
+    state->rng ^= state->rng << 13;
+    state->rng ^= state->rng >> 7;
+    state->rng ^= state->rng << 17;
+    return state->rng;
+}
+
+// Libera el simulador y los arreglos de un caso
+static void benchTeardown(BenchState* state) {
+    if (state->sim != NULL) {
+        freeSimulator(state->sim);
+    }
+    free(state->names);
+    free(state->sizes);
+    memset(state, 0, sizeof(BenchState));
+}
+
+// Prepara un caso: carga blocks procesos de 1 a BENCH_SLOT bytes y libera al azar la
+// fracción pedida para dejar huecos. Queda memoria libre para una tanda de asignaciones
+static bool benchSetup(BenchState* state, PartitionType mode, PlacementPolicy placement, uint64_t blocks,
+                       double fragmentation) {
+    uint64_t slots = blocks + blocks / 4 + BENCH_BATCH;
+    
+    memset(state, 0, sizeof(BenchState));
+    state->rng = 0x9E3779B97F4A7C15ULL ^ blocks;
+    state->sim = initSimulator(slots * BENCH_SLOT, UNIT_BYTE);
+    state->names = malloc(blocks * sizeof(*state->names));
+    state->sizes = (MemSize*) malloc(blocks * sizeof(MemSize));
+    
+    if (state->sim == NULL || state->names == NULL || state->sizes == NULL ||
+        setPlacementPolicy(state->sim, placement) != SIM_OK ||
+        setPartitionMode(state->sim, mode, mode == FIXED_PARTITIONS ? (int) slots : 0) != SIM_OK) {
+        benchTeardown(state);
+        return false;
+    }
+    
+    for (uint64_t i = 0; i < blocks; i++) {
+        char* name = state->names[state->live];
+        MemSize size = 1 + benchRandom(state) % BENCH_SLOT;
+        
+        snprintf(name, MAX_PROCESS_NAME, "b%llx", (unsigned long long) state->next_name++);
+        if (allocateProcess(state->sim, name, size) == SIM_OK) {
+            state->sizes[state->live++] = size;
+        }
+    }
+    
+    // Liberar la fracción pedida conservando en orden a los que quedan
+    uint64_t threshold = (uint64_t) (fragmentation * 4294967296.0);
+    size_t kept = 0;
+    
+    for (size_t i = 0; i < state->live; i++) {
+        if ((benchRandom(state) & 0xFFFFFFFFULL) < threshold) {
+            deallocateProcess(state->sim, state->names[i]);
+        } else {
+            memmove(state->names[kept], state->names[i], MAX_PROCESS_NAME);
+            state->sizes[kept++] = state->sizes[i];
+        }
+    }
+    state->live = kept;
+    return true;
+}
+
+// Tanda de asignaciones medida; después se liberan sin medir para volver al estado del caso
+static uint64_t benchAllocBatch(BenchState* state, uint64_t* ops) {
+    char names[BENCH_BATCH][MAX_PROCESS_NAME];
+    MemSize sizes[BENCH_BATCH];
+    bool placed[BENCH_BATCH];
+    
+    for (int i = 0; i < BENCH_BATCH; i++) {
+        snprintf(names[i], MAX_PROCESS_NAME, "n%llx", (unsigned long long) state->next_name++);
+        sizes[i] = 1 + benchRandom(state) % BENCH_SLOT;
+    }
+    
+    uint64_t start = monotonicNanos();
+    for (int i = 0; i < BENCH_BATCH; i++) {
+        placed[i] = allocateProcess(state->sim, names[i], sizes[i]) == SIM_OK;
+    }
+    uint64_t elapsed = monotonicNanos() - start;
+    
+    for (int i = 0; i < BENCH_BATCH; i++) {
+        if (placed[i]) {
+            deallocateProcess(state->sim, names[i]);
+        }
+    }
+    *ops = BENCH_BATCH;
+    return elapsed;
+}
+
+// Tanda de liberaciones medida sobre procesos vivos consecutivos a partir de uno al azar;
+// después se vuelven a cargar sin medir (el que ya no entra deja de contarse como vivo)
+static uint64_t benchFreeBatch(BenchState* state, uint64_t* ops) {
+    size_t count = state->live < BENCH_BATCH ? state->live : BENCH_BATCH;
+    size_t first = (state->live > 0) ? (size_t) (benchRandom(state) % state->live) : 0;
+    
+    uint64_t start = monotonicNanos();
+    for (size_t k = 0; k < count; k++) {
+        deallocateProcess(state->sim, state->names[(first + k) % state->live]);
+    }
+    uint64_t elapsed = monotonicNanos() - start;
+    
+    size_t lost = 0;
+    for (size_t k = 0; k < count; k++) {
+        size_t i = (first + k) % state->live;
+        if (allocateProcess(state->sim, state->names[i], state->sizes[i]) != SIM_OK) {
+            state->sizes[i] = 0;
+            lost++;
+        }
+    }
+    if (lost > 0) {
+        size_t kept = 0;
+        for (size_t i = 0; i < state->live; i++) {
+            if (state->sizes[i] != 0) {
+                memmove(state->names[kept], state->names[i], MAX_PROCESS_NAME);
+                state->sizes[kept++] = state->sizes[i];
+            }
+        }
+        state->live = kept;
+    }
+    
+    *ops = count;
+    return elapsed;
+}
+
+// Una compactación medida sobre un caso recién preparado (compactar deshace los huecos)
+static uint64_t benchCompactOnce(const BenchConfig* config, const BenchResult* result, uint64_t* ops) {
+    BenchState fresh;
+    CompactionResult compaction;
+    
+    *ops = 0;
+    if (!benchSetup(&fresh, result->mode, config->placement, result->blocks, result->fragmentation)) {
+        return 0;
+    }
+    
+    uint64_t start = monotonicNanos();
+    compactMemory(fresh.sim, &compaction);
+    uint64_t elapsed = monotonicNanos() - start;
+    
+    benchTeardown(&fresh);
+    *ops = 1;
+    return elapsed;
+}
+
+// Orden de dos tiempos para qsort
+static int compareDouble(const void* a, const void* b) {
+    double x = *(const double*) a;
+    double y = *(const double*) b;
+    return (x > y) - (x < y);
+}
+
+// Mide el tiempo de un trabajo fijo que no depende del simulador: un recorrido
+// dependiente de los datos sobre buffer (BENCH_CALIBRATION_WORDS palabras). Sirve para
+// separar los cambios de velocidad de la máquina entre corridas de los del código
+static double benchCalibrate(const uint64_t* buffer) {
+    uint64_t index = 0;
+    uint64_t sum = 0;
+    uint64_t start = monotonicNanos();
+    
+    for (int i = 0; i < BENCH_CALIBRATION_STEPS; i++) {
+        index = (buffer[index] ^ sum) & (BENCH_CALIBRATION_WORDS - 1);
+        sum += index * 0x9E3779B97F4A7C15ULL;
+    }
+    
+    uint64_t elapsed = monotonicNanos() - start;
+    __asm__ volatile("" : : "r"(sum));  // Que el compilador no descarte el recorrido
+    return (double) elapsed;
+}
+
+// Mide una repetición de un caso: tandas hasta juntar BENCH_TARGET_NS medidos (o
+// BENCH_MAX_WALL_NS en total). Deja en ns_per_op el tiempo por operación y en result->ops
+// las operaciones medidas. Devuelve false si no midió nada
+static bool benchRunRepetition(const BenchConfig* config, BenchState* state, BenchResult* result, double* ns_per_op) {
+    uint64_t measured = 0;
+    uint64_t ops = 0;
+    uint64_t wall_start = monotonicNanos();
+    
+    do {
+        uint64_t batch_ops = 0;
+        
+        switch (result->op) {
+            case BENCH_ALLOC:
+                measured += benchAllocBatch(state, &batch_ops);
+                break;
+            case BENCH_FREE:
+                measured += benchFreeBatch(state, &batch_ops);
+                break;
+            case BENCH_COMPACT:
+                measured += benchCompactOnce(config, result, &batch_ops);
+                break;
+            case BENCH_FRAGMENTATION: {
+                MemSize internal_frag, external_frag;
+                uint64_t start = monotonicNanos();
+                for (int i = 0; i < BENCH_BATCH; i++) {
+                    calculateFragmentation(state->sim, &internal_frag, &external_frag);
+                }
+                measured += monotonicNanos() - start;
+                batch_ops = BENCH_BATCH;
+                break;
+            }
+            case BENCH_MAP: {
+                // El texto se arma igual que displayMemoryMap pero no se escribe
+                TextBuffer buf = { NULL, 0, 0, false };
+                uint64_t start = monotonicNanos();
+                renderMemoryMap(state->sim, &buf);
+                measured += monotonicNanos() - start;
+                textBufferFree(&buf);
+                batch_ops = 1;
+                break;
+            }
+            default:
+                break;
+        }
+        
+        if (batch_ops == 0) {
+            return false;
+        }
+        ops += batch_ops;
+    } while (measured < BENCH_TARGET_NS && monotonicNanos() - wall_start < BENCH_MAX_WALL_NS);
+    
+    *ns_per_op = (double) measured / (double) ops;
+    result->ops = ops;
+    return true;
+}
+
+// Resume los n tiempos por operación de un caso (los ordena)
+static void benchSummarize(BenchResult* result, double* samples, int n) {
+    double sum = 0, squares = 0;
+    
+    qsort(samples, (size_t) n, sizeof(double), compareDouble);
+    for (int i = 0; i < n; i++) {
+        sum += samples[i];
+    }
+    result->mean_ns = sum / n;
+    for (int i = 0; i < n; i++) {
+        squares += (samples[i] - result->mean_ns) * (samples[i] - result->mean_ns);
+    }
+    result->stddev_ns = (n > 1) ? sqrt(squares / (n - 1)) : 0.0;
+    result->median_ns = (n % 2 == 1) ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+    result->min_ns = samples[0];
+    result->max_ns = samples[n - 1];
+}
+
+// Escribe los resultados en JSON: un caso por línea con las claves siempre en el mismo
+// orden, para que los archivos se puedan comparar con diff y leer con benchCompare
+static bool benchWriteJson(const BenchConfig* config, const BenchResult* results, size_t count, double calibration) {
+    FILE* out = fopen(config->json_path, "w");
+    
+    if (out == NULL) {
+        printf("Error: No se pudo crear '%s': %s\n", config->json_path, strerror(errno));
+        return false;
+    }
+    
+#ifdef INSTRUMENTATION
+    const char* instrumentation = "true";
+#else
+    const char* instrumentation = "false";
+#endif
+    fprintf(out, "{\"format\":\"memsim-bench\",\"version\":1,\"policy\":\"%s\",\"instrumentation\":%s,"
+            "\"repetitions\":%d,\"warmup\":%d,\"unit\":\"ns\",\"calibration_ns\":%.2f,\"results\":[\n",
+            placementPolicyName(config->placement), instrumentation, config->repetitions, BENCH_WARMUP, calibration);
+    
+    for (size_t i = 0; i < count; i++) {
+        const BenchResult* r = &results[i];
+        fprintf(out, "{\"op\":\"%s\",\"mode\":\"%s\",\"blocks\":%llu,\"fragmentation\":%.2f,\"ops\":%llu,"
+                "\"median_ns\":%.2f,\"mean_ns\":%.2f,\"stddev_ns\":%.2f,\"min_ns\":%.2f,\"max_ns\":%.2f}%s\n",
+                benchOpName(r->op), partitionTypeName(r->mode), (unsigned long long) r->blocks,
+                r->fragmentation, (unsigned long long) r->ops, r->median_ns, r->mean_ns, r->stddev_ns,
+                r->min_ns, r->max_ns, i + 1 < count ? "," : "");
+    }
+    fprintf(out, "]}\n");
+    
+    bool ok = !ferror(out);
+    if (fclose(out) != 0 || !ok) {
+        printf("Error: No se pudo escribir '%s'.\n", config->json_path);
+        return false;
+    }
+    return true;
+}
+
+// Valor que sigue a "clave": en una línea del JSON de resultados (NULL si no está)
+static const char* benchJsonValue(const char* line, const char* key) {
+    char pattern[32];
+    
+    snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+    const char* found = strstr(line, pattern);
+    return found != NULL ? found + strlen(pattern) : NULL;
+}
+
+// Indica si el texto entre comillas de la clave es igual a expected
+static bool benchJsonEquals(const char* line, const char* key, const char* expected) {
+    const char* value = benchJsonValue(line, key);
+    size_t length = strlen(expected);
+    
+    return value != NULL && value[0] == '"' && strncmp(value + 1, expected, length) == 0 &&
+           value[length + 1] == '"';
+}
+
+// Compara las medianas con las de un JSON de resultados anterior. Un caso es regresión
+// (o mejora) solo si el cambio supera el umbral y además el ruido: las repeticiones de
+// las dos mediciones no se superponen y la diferencia de medianas es mayor que
+// BENCH_NOISE_SIGMAS desvíos combinados. Los que superan solo el umbral se marcan como
+// ruido. Devuelve la cantidad de regresiones o -1 si no se pudo leer la referencia
+static long benchCompare(const BenchConfig* config, const BenchResult* results, size_t count, double calibration) {
+    FILE* in = fopen(config->baseline_path, "r");
+    char line[4 * MAX_TRACE_LINE];
+    
+    if (in == NULL || fgets(line, sizeof(line), in) == NULL || !benchJsonEquals(line, "format", "memsim-bench")) {
+        printf("Error: '%s' no es un archivo de resultados de la batería.\n", config->baseline_path);
+        if (in != NULL) fclose(in);
+        return -1;
+    }
+    
+    printf("\n=== Comparación con '%s' (umbral %.0f%% y %.0f desvíos) ===\n", config->baseline_path,
+           100.0 * config->threshold, BENCH_NOISE_SIGMAS);
+    if (!benchJsonEquals(line, "policy", placementPolicyName(config->placement))) {
+        printf("Aviso: la referencia se midió con otra política de ubicación.\n");
+    }
+#ifdef INSTRUMENTATION
+    const char* instrumentation = "true";
+#else
+    const char* instrumentation = "false";
+#endif
+    const char* value = benchJsonValue(line, "instrumentation");
+    if (value == NULL || strncmp(value, instrumentation, strlen(instrumentation)) != 0) {
+        printf("Aviso: la referencia se compiló con otra configuración de instrumentación.\n");
+    }
+    
+    // La referencia se lleva a la velocidad actual de la máquina con la calibración
+    const char* calibration_text = benchJsonValue(line, "calibration_ns");
+    double baseline_calibration = (calibration_text != NULL) ? strtod(calibration_text, NULL) : 0.0;
+    double scale = 1.0;
+    if (baseline_calibration > 0 && calibration > 0) {
+        scale = calibration / baseline_calibration;
+        printf("Calibración: %.0f ns (referencia %.0f ns); la referencia se escala por %.3f\n", calibration,
+               baseline_calibration, scale);
+    } else {
+        printf("Aviso: la referencia no tiene calibración; se compara sin escalar.\n");
+    }
+    
+    printf("%-14s %-8s %8s %6s %14s %14s %9s\n", "Operación", "Modo", "Bloques", "Huecos", "Referencia(ns)",
+           "Actual(ns)", "Cambio");
+    printf("-------------------------------------------------------------------------------\n");
+    
+    long regressions = 0;
+    size_t compared = 0;
+    
+    while (fgets(line, sizeof(line), in) != NULL) {
+        const char* blocks_text = benchJsonValue(line, "blocks");
+        const char* fragmentation_text = benchJsonValue(line, "fragmentation");
+        const char* median_text = benchJsonValue(line, "median_ns");
+        const char* stddev_text = benchJsonValue(line, "stddev_ns");
+        const char* min_text = benchJsonValue(line, "min_ns");
+        const char* max_text = benchJsonValue(line, "max_ns");
+        
+        if (blocks_text == NULL || fragmentation_text == NULL || median_text == NULL || stddev_text == NULL ||
+            min_text == NULL || max_text == NULL) {
+            continue;
+        }
+        
+        uint64_t blocks = strtoull(blocks_text, NULL, 10);
+        double fragmentation = strtod(fragmentation_text, NULL);
+        double baseline = scale * strtod(median_text, NULL);
+        double baseline_stddev = scale * strtod(stddev_text, NULL);
+        double baseline_min = scale * strtod(min_text, NULL);
+        double baseline_max = scale * strtod(max_text, NULL);
+        
+        for (size_t i = 0; i < count; i++) {
+            const BenchResult* r = &results[i];
+            
+            if (r->blocks != blocks || fabs(r->fragmentation - fragmentation) > 0.005 ||
+                !benchJsonEquals(line, "op", benchOpName(r->op)) ||
+                !benchJsonEquals(line, "mode", partitionTypeName(r->mode))) {
+                continue;
+            }
+            
+            double change = baseline > 0 ? r->median_ns / baseline - 1.0 : 0.0;
+            double noise = BENCH_NOISE_SIGMAS * sqrt(baseline_stddev * baseline_stddev + r->stddev_ns * r->stddev_ns);
+            const char* verdict = "";
+            
+            if (change > config->threshold) {
+                if (r->min_ns > baseline_max && r->median_ns - baseline > noise) {
+                    verdict = "  REGRESIÓN";
+                    regressions++;
+                } else {
+                    verdict = "  (ruido)";
+                }
+            } else if (change < -config->threshold) {
+                verdict = (r->max_ns < baseline_min && baseline - r->median_ns > noise) ? "  mejora" : "  (ruido)";
+            }
+            
+            printf("%-14s %-8s %8llu %5.0f%% %14.1f %14.1f %+8.1f%%%s\n", benchOpName(r->op),
+                   partitionTypeName(r->mode), (unsigned long long) r->blocks, 100.0 * r->fragmentation,
+                   baseline, r->median_ns, 100.0 * change, verdict);
+            compared++;
+            break;
+        }
+    }
+    fclose(in);
+    
+    printf("Casos comparados: %zu de %zu, regresiones: %ld\n", compared, count, regressions);
+    return regressions;
+}
+
+// Batería de microbenchmarks del motor: asignar, liberar, compactar, calcular la
+// fragmentación y armar el mapa, en cada modo de partición, con 10 a max_blocks bloques
+// y distintas fracciones de huecos. Las repeticiones se hacen por rondas sobre toda la
+// batería (cada ronda vuelve a preparar los casos), así su dispersión incluye la
+// variación de la máquina a lo largo de la corrida y no solo la de unos milisegundos.
+// Reporta mediana, media, desvío y extremos del tiempo por operación; opcionalmente los
+// guarda en JSON y los compara con una referencia. Devuelve false si algún caso falló o
+// hubo regresiones
+bool runBenchmarkSuite(const BenchConfig* config) {
+    static const PartitionType modes[] = { FIXED_PARTITIONS, DYNAMIC_PARTITIONS, BUDDY_PARTITIONS, BITMAP_PARTITIONS };
+    static const double levels[] = { 0.0, 0.25, 0.5 };
+    size_t mode_count = sizeof(modes) / sizeof(modes[0]);
+    size_t level_count = sizeof(levels) / sizeof(levels[0]);
+    int reps = config->repetitions;
+    
+    size_t decades = 0;
+    for (uint64_t blocks = 10; blocks <= config->max_blocks; blocks *= 10) {
+        decades++;
+    }
+    
+    size_t capacity = mode_count * level_count * decades * BENCH_OP_COUNT;
+    BenchResult* results = (BenchResult*) malloc(capacity * sizeof(BenchResult));
+    double* samples = (double*) malloc(capacity * (size_t) reps * sizeof(double));
+    bool* failed = (bool*) calloc(capacity, sizeof(bool));
+    uint64_t* calibration_buffer = (uint64_t*) malloc(BENCH_CALIBRATION_WORDS * sizeof(uint64_t));
+    double* calibration = (double*) malloc(capacity * (size_t) reps * sizeof(double));
+    size_t calibration_count = 0;
+    size_t count = 0;
+    bool ok = true;
+    
+    if (results == NULL || samples == NULL || failed == NULL || calibration_buffer == NULL || calibration == NULL) {
+        fprintf(stderr, "Error: No se pudo asignar memoria para la medición.\n");
+        free(results);
+        free(samples);
+        free(failed);
+        free(calibration_buffer);
+        free(calibration);
+        return false;
+    }
+    
+    uint64_t rng = 0x2545F4914F6CDD1DULL;
+    for (size_t i = 0; i < BENCH_CALIBRATION_WORDS; i++) {
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        calibration_buffer[i] = rng;
+    }
+    
+    // Casos en el orden del reporte; los de una misma preparación quedan contiguos
+    for (size_t m = 0; m < mode_count; m++) {
+        for (uint64_t blocks = 10; blocks <= config->max_blocks; blocks *= 10) {
+            for (size_t l = 0; l < level_count; l++) {
+                for (int op = 0; op < BENCH_OP_COUNT; op++) {
+                    // Solo las particiones dinámicas se compactan
+                    if (op == BENCH_COMPACT && modes[m] != DYNAMIC_PARTITIONS) {
+                        continue;
+                    }
+                    
+                    BenchResult* r = &results[count++];
+                    memset(r, 0, sizeof(BenchResult));
+                    r->op = (BenchOp) op;
+                    r->mode = modes[m];
+                    r->blocks = blocks;
+                    r->fragmentation = levels[l];
+                }
+            }
+        }
+    }
+    
+    printf("\n=== Microbenchmarks del motor ===\n");
+    printf("%d repeticiones (más %d de calentamiento) en rondas sobre toda la batería, política %s, "
+           "procesos de 1 a %d bytes\n", reps, BENCH_WARMUP, placementPolicyName(config->placement), BENCH_SLOT);
+    
+    for (int round = 0; round < BENCH_WARMUP + reps; round++) {
+        printf("Ronda %d de %d%s...\n", round + 1, BENCH_WARMUP + reps, round < BENCH_WARMUP ? " (calentamiento)" : "");
+        fflush(stdout);
+        
+        for (size_t first = 0; first < count;) {
+            size_t last = first;
+            while (last < count && results[last].mode == results[first].mode &&
+                   results[last].blocks == results[first].blocks &&
+                   results[last].fragmentation == results[first].fragmentation) {
+                last++;
+            }
+            
+            // Una calibración por preparación, repartidas como las mediciones
+            double calibration_ns = benchCalibrate(calibration_buffer);
+            if (round >= BENCH_WARMUP) {
+                calibration[calibration_count++] = calibration_ns;
+            }
+            
+            BenchState state;
+            if (!benchSetup(&state, results[first].mode, config->placement, results[first].blocks,
+                            results[first].fragmentation)) {
+                for (size_t i = first; i < last; i++) {
+                    failed[i] = true;
+                }
+                first = last;
+                continue;
+            }
+            
+            for (size_t i = first; i < last; i++) {
+                double ns_per_op;
+                
+                if (!failed[i] && !benchRunRepetition(config, &state, &results[i], &ns_per_op)) {
+                    failed[i] = true;
+                }
+                if (!failed[i] && round >= BENCH_WARMUP) {
+                    samples[i * (size_t) reps + (size_t) (round - BENCH_WARMUP)] = ns_per_op;
+                }
+            }
+            
+            benchTeardown(&state);
+            first = last;
+        }
+    }
+    
+    printf("%-14s %-8s %8s %6s %8s %12s %12s %6s %12s %12s\n", "Operación", "Modo", "Bloques", "Huecos",
+           "ops/rep", "Mediana(ns)", "Media(ns)", "CV", "Mín(ns)", "Máx(ns)");
+    printf("------------------------------------------------------------------------------------------------------\n");
+    
+    // Los casos que fallaron se informan y se quitan antes de comparar y guardar
+    size_t kept = 0;
+    for (size_t i = 0; i < count; i++) {
+        BenchResult* r = &results[i];
+        
+        if (failed[i]) {
+            fprintf(stderr, "Error: No se pudo medir %s en modo %s con %llu bloques.\n",
+                    benchOpName(r->op), partitionTypeName(r->mode), (unsigned long long) r->blocks);
+            ok = false;
+            continue;
+        }
+        
+        benchSummarize(r, &samples[i * (size_t) reps], reps);
+        printf("%-14s %-8s %8llu %5.0f%% %8llu %12.1f %12.1f %5.1f%% %12.1f %12.1f\n",
+               benchOpName(r->op), partitionTypeName(r->mode), (unsigned long long) r->blocks,
+               100.0 * r->fragmentation, (unsigned long long) r->ops, r->median_ns, r->mean_ns,
+               r->mean_ns > 0 ? 100.0 * r->stddev_ns / r->mean_ns : 0.0, r->min_ns, r->max_ns);
+        results[kept++] = *r;
+    }
+    count = kept;
+    
+    // Mediana de las calibraciones: la velocidad de la máquina durante esta corrida
+    qsort(calibration, calibration_count, sizeof(double), compareDouble);
+    double machine = (calibration_count > 0) ? calibration[calibration_count / 2] : 0.0;
+    printf("Calibración de la máquina: %.0f ns por recorrido\n", machine);
+    
+    // Primero comparar: la referencia puede ser el mismo archivo que se va a escribir
+    if (config->baseline_path != NULL) {
+        long regressions = benchCompare(config, results, count, machine);
+        ok = ok && regressions == 0;
+    }
+    if (config->json_path != NULL) {
+        if (benchWriteJson(config, results, count, machine)) {
+            printf("Resultados guardados en '%s'.\n", config->json_path);
+        } else {
+            ok = false;
+        }
+    }
+    
+    free(results);
+    free(samples);
+    free(failed);
+    free(calibration_buffer);
+    free(calibration);
+    return ok;
+}
+
+// Interpreta el nombre de un modo de partición
+static bool parsePartitionType(const char* text, PartitionType* type) {
+    for (int i = FIXED_PARTITIONS; i <= BITMAP_PARTITIONS; i++) {
+        if (strcmp(text, partitionTypeName((PartitionType) i)) == 0) {
+            *type = (PartitionType) i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Interpreta la grilla "memory=...;partitions=...;mode=...;policy=..." y genera el producto
+// cartesiano de configuraciones. Las dimensiones omitidas toman un solo valor por defecto
+// y las particiones solo multiplican las configuraciones en modo fijo
+bool parseSweepGrid(const char* spec, MemoryUnit unit, MemSize default_memory, PlacementPolicy default_policy,
+                    SweepConfig** configs, size_t* count) {
+    MemSize memories[SWEEP_MAX_VALUES] = { default_memory };
+    int partitions[SWEEP_MAX_VALUES] = { SWEEP_DEFAULT_PARTITIONS };
+    PartitionType modes[SWEEP_MAX_VALUES] = { DYNAMIC_PARTITIONS };
+    PlacementPolicy policies[SWEEP_MAX_VALUES] = { default_policy };
+    size_t memory_count = 1, partition_count = 1, mode_count = 1, policy_count = 1;
+    
+    char* copy = strdup(spec);
+    if (copy == NULL) {
+        return false;
+    }
+    
+    char* dimension_state;
+    for (char* dimension = strtok_r(copy, ";", &dimension_state); dimension != NULL;
+         dimension = strtok_r(NULL, ";", &dimension_state)) {
+        char* values = strchr(dimension, '=');
+        if (values == NULL) {
+            fprintf(stderr, "Error: Dimensión de la grilla sin valores: '%s'.\n", dimension);
+            free(copy);
+            return false;
+        }
+        *values++ = '\0';
+        
+        size_t n = 0;
+        char* value_state;
+        for (char* value = strtok_r(values, ",", &value_state); value != NULL;
+             value = strtok_r(NULL, ",", &value_state)) {
+            bool valid;
+            
+            if (n == SWEEP_MAX_VALUES) {
+                fprintf(stderr, "Error: Demasiados valores para '%s' (máximo %d).\n", dimension, SWEEP_MAX_VALUES);
+                free(copy);
+                return false;
+            }
+            
+            if (strcmp(dimension, "memory") == 0) {
+                valid = parseMemorySize(value, unit, &memories[n]) && memories[n] > 0;
+            } else if (strcmp(dimension, "partitions") == 0) {
+                partitions[n] = atoi(value);
+                valid = partitions[n] > 0;
+            } else if (strcmp(dimension, "mode") == 0) {
+                valid = parsePartitionType(value, &modes[n]);
+            } else if (strcmp(dimension, "policy") == 0) {
+                valid = parsePlacementPolicy(value, &policies[n]);
+            } else {
+                fprintf(stderr, "Error: Dimensión de la grilla desconocida '%s'.\n", dimension);
+                free(copy);
+                return false;
+            }
+            
+            if (!valid) {
+                fprintf(stderr, "Error: Valor inválido '%s' para '%s'.\n", value, dimension);
+                free(copy);
+                return false;
+            }
+            n++;
+        }
+        
+        if (n == 0) {
+            fprintf(stderr, "Error: Dimensión de la grilla sin valores: '%s'.\n", dimension);
+            free(copy);
+            return false;
+        }
+        
+        if (strcmp(dimension, "memory") == 0) memory_count = n;
+        else if (strcmp(dimension, "partitions") == 0) partition_count = n;
+        else if (strcmp(dimension, "mode") == 0) mode_count = n;
+        else policy_count = n;
+    }
+    free(copy);
+    
+    size_t capacity = memory_count * partition_count * mode_count * policy_count;
+    *configs = (SweepConfig*) malloc(capacity * sizeof(SweepConfig));
+    if (*configs == NULL) {
+        return false;
+    }
+    
+    *count = 0;
+    for (size_t m = 0; m < memory_count; m++) {
+        for (size_t t = 0; t < mode_count; t++) {
+            // Las particiones solo tienen sentido en modo fijo: los demás modos usan una sola
+            size_t used_partitions = (modes[t] == FIXED_PARTITIONS) ? partition_count : 1;
+            
+            for (size_t k = 0; k < used_partitions; k++) {
+                for (size_t p = 0; p < policy_count; p++) {
+                    SweepConfig* config = &(*configs)[(*count)++];
+                    config->memory_size = memories[m];
+                    config->mode = modes[t];
+                    config->partitions = (modes[t] == FIXED_PARTITIONS) ? partitions[k] : 0;
+                    config->placement = policies[p];
+                }
+            }
+        }
+    }
+    
+    return true;
+}
+
+// Reproduce la traza compartida sobre un simulador nuevo con la configuración indicada
+// y resume los resultados. report es un espacio de trabajo del hilo que la ejecuta
+void runSweepConfig(const TraceProgram* trace, const SweepConfig* config, bool compact_on_fail,
+                    TraceReport* report, SweepResult* result) {
+    MemorySimulator* sim = initSimulator(config->memory_size, trace->unit);
+    
+    // Una configuración que no se pudo armar queda como inválida en el CSV
+    memset(result, 0, sizeof(SweepResult));
+    if (sim == NULL) {
+        return;
+    }
+    if ((config->mode != DYNAMIC_PARTITIONS && setPartitionMode(sim, config->mode, config->partitions) != SIM_OK) ||
+        setPlacementPolicy(sim, config->placement) != SIM_OK) {
+        freeSimulator(sim);
+        return;
+    }
+    
+    memset(report, 0, sizeof(TraceReport));
+    uint64_t wall_start = monotonicNanos();
+    for (size_t i = 0; i < trace->count; i++) {
+        executeTraceOp(sim, &trace->ops[i], compact_on_fail, report);
+    }
+    report->wall_ns = monotonicNanos() - wall_start;
+    
+    for (int i = 0; i < TRACE_OP_COUNT; i++) {
+        result->operations += report->latency[i].count;
+        result->failures += report->failures[i];
+    }
+    result->sim_ns = report->sim_ns;
+    result->alloc_p50_ns = latencyPercentile(&report->latency[TRACE_ALLOC], 50.0);
+    result->alloc_p99_ns = latencyPercentile(&report->latency[TRACE_ALLOC], 99.0);
+    calculateFragmentation(sim, &result->internal_frag, &result->external_frag);
+    result->mean_external_ratio = report->samples > 0
+        ? report->sum_external_ratio / (double) report->samples : 0.0;
+    result->max_external_ratio = report->max_external_ratio;
+    result->max_free_blocks = report->max_free_blocks;
+    result->compaction_moved = sim->compaction_moved;
+    char problem[SIM_ERROR_TEXT];
+    result->valid = validateSimulator(sim, problem, sizeof(problem));
+    if (!result->valid) {
+        fprintf(stderr, "Inconsistencia: %s\n", problem);
+    }
+    
+    freeSimulator(sim);
+}
+
+// Toma la próxima configuración: primero de la cola propia (desde el final) y, si está
+// vacía, robando desde el principio de la cola de otro hilo. Devuelve false si no queda
+static bool sweepTakeJob(SweepWorker* worker, size_t* job) {
+    SweepPool* pool = worker->pool;
+    
+    for (int attempt = 0; attempt < pool->worker_count; attempt++) {
+        int victim = (worker->id + attempt) % pool->worker_count;
+        WorkDeque* deque = &pool->deques[victim];
+        bool found = false;
+        
+        pthread_mutex_lock(&deque->lock);
+        if (deque->top < deque->bottom) {
+            *job = (attempt == 0) ? --deque->bottom : deque->top++;
+            found = true;
+        }
+        pthread_mutex_unlock(&deque->lock);
+        
+        if (found) {
+            if (attempt > 0) worker->stolen++;
+            return true;
+        }
+    }
+    
+    // Nadie agrega trabajo nuevo: si todas las colas están vacías, el barrido terminó
+    return false;
+}
+
+// Cuerpo de cada hilo del pool: ejecuta configuraciones hasta que no quede ninguna
+static void* sweepWorkerMain(void* argument) {
+    SweepWorker* worker = (SweepWorker*) argument;
+    SweepPool* pool = worker->pool;
+    TraceReport* report = (TraceReport*) malloc(sizeof(TraceReport));
+    size_t job;
+    
+    if (report == NULL) {
+        return NULL;  // Los demás hilos roban sus configuraciones
+    }
+    
+    while (sweepTakeJob(worker, &job)) {
+        runSweepConfig(pool->trace, &pool->configs[job], pool->compact_on_fail, report, &pool->results[job]);
+        worker->executed++;
+    }
+    
+    free(report);
+    return NULL;
+}
+
+// Escribe una fila de CSV por configuración, en el orden de la grilla
+static void writeSweepCsv(FILE* out, const TraceProgram* trace, const SweepConfig* configs,
+                          const SweepResult* results, size_t count) {
+    fprintf(out, "memory,unit,mode,partitions,policy,operations,failures,failure_rate,invalid_lines,"
+                 "sim_seconds,ops_per_second,alloc_p50_ns,alloc_p99_ns,internal_frag,external_frag,"
+                 "mean_external_ratio,max_external_ratio,max_free_blocks,compaction_moved,valid\n");
+    
+    for (size_t i = 0; i < count; i++) {
+        const SweepConfig* config = &configs[i];
+        const SweepResult* result = &results[i];
+        double seconds = (double) result->sim_ns / 1e9;
+        
+        fprintf(out, "%llu,%s,%s,%d,%s,%llu,%llu,%.6f,%llu,%.6f,%.0f,%llu,%llu,%llu,%llu,%.6f,%.6f,%llu,%llu,%d\n",
+                (unsigned long long) config->memory_size, memoryUnitName(trace->unit),
+                partitionTypeName(config->mode), config->partitions, placementPolicyName(config->placement),
+                (unsigned long long) result->operations, (unsigned long long) result->failures,
+                result->operations > 0 ? (double) result->failures / (double) result->operations : 0.0,
+                (unsigned long long) trace->invalid_lines, seconds,
+                seconds > 0 ? (double) result->operations / seconds : 0.0,
+                (unsigned long long) result->alloc_p50_ns, (unsigned long long) result->alloc_p99_ns,
+                (unsigned long long) result->internal_frag, (unsigned long long) result->external_frag,
+                result->mean_external_ratio, result->max_external_ratio,
+                (unsigned long long) result->max_free_blocks, (unsigned long long) result->compaction_moved,
+                result->valid ? 1 : 0);
+    }
+}
+
+// Reproduce una traza con todas las configuraciones de la grilla repartidas entre jobs
+// hilos (0 = uno por CPU) y escribe un CSV con una fila por configuración (stdout si
+// csv_path es NULL). La traza se interpreta una sola vez y todos los hilos la comparten
+bool runSweep(const char* trace_path, const char* grid, MemoryUnit unit, MemSize default_memory,
+              PlacementPolicy default_policy, bool compact_on_fail, int jobs, const char* csv_path) {
+    TraceProgram trace;
+    SweepConfig* configs = NULL;
+    size_t count = 0;
+    
+    if (!parseSweepGrid(grid, unit, default_memory, default_policy, &configs, &count)) {
+        return false;
+    }
+    
+    uint64_t load_start = monotonicNanos();
+    if (!loadTrace(trace_path, unit, &trace)) {
+        free(configs);
+        return false;
+    }
+    double load_seconds = (double) (monotonicNanos() - load_start) / 1e9;
+    
+    if (jobs <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        jobs = (cpus > 0) ? (int) cpus : 1;
+    }
+    if ((size_t) jobs > count) {
+        jobs = (int) count;
+    }
+    
+    SweepResult* results = (SweepResult*) calloc(count, sizeof(SweepResult));
+    WorkDeque* deques = (WorkDeque*) calloc((size_t) jobs, sizeof(WorkDeque));
+    SweepWorker* workers = (SweepWorker*) calloc((size_t) jobs, sizeof(SweepWorker));
+    pthread_t* threads = (pthread_t*) calloc((size_t) jobs, sizeof(pthread_t));
+    FILE* out = (csv_path != NULL) ? fopen(csv_path, "w") : stdout;
+    bool ok = results != NULL && deques != NULL && workers != NULL && threads != NULL && out != NULL;
+    
+    if (ok) {
+        SweepPool pool = { &trace, configs, results, deques, jobs, compact_on_fail };
+        
+        // Repartir la grilla en rangos contiguos; el robo equilibra las configuraciones lentas
+        for (int w = 0; w < jobs; w++) {
+            pthread_mutex_init(&deques[w].lock, NULL);
+            deques[w].top = count * (size_t) w / (size_t) jobs;
+            deques[w].bottom = count * (size_t) (w + 1) / (size_t) jobs;
+            workers[w].pool = &pool;
+            workers[w].id = w;
+        }
+        
+        uint64_t start = monotonicNanos();
+        int started = 0;
+        for (int w = 0; w < jobs; w++) {
+            if (pthread_create(&threads[w], NULL, sweepWorkerMain, &workers[w]) != 0) {
+                break;
+            }
+            started++;
+        }
+        // Si algún hilo no arrancó, el propio hilo principal ayuda con lo que quede
+        if (started < jobs) {
+            SweepWorker helper = { &pool, 0, 0, 0 };
+            sweepWorkerMain(&helper);
+        }
+        for (int w = 0; w < started; w++) {
+            pthread_join(threads[w], NULL);
+        }
+        double seconds = (double) (monotonicNanos() - start) / 1e9;
+        
+        writeSweepCsv(out, &trace, configs, results, count);
+        
+        uint64_t stolen = 0;
+        size_t invalid = 0;
+        for (int w = 0; w < jobs; w++) {
+            stolen += workers[w].stolen;
+            pthread_mutex_destroy(&deques[w].lock);
+        }
+        for (size_t i = 0; i < count; i++) {
+            if (!results[i].valid) invalid++;
+        }
+        
+        fprintf(stderr, "Barrido: %zu configuraciones x %zu operaciones en %.3f s con %d hilos "
+                        "(%llu robadas; traza leída en %.3f s)\n",
+                count, trace.count, seconds, jobs, (unsigned long long) stolen, load_seconds);
+        if (invalid > 0) {
+            fprintf(stderr, "Error: %zu configuraciones terminaron con invariantes rotas.\n", invalid);
+            ok = false;
+        }
+    } else {
+        fprintf(stderr, "Error: No se pudo preparar el barrido.\n");
+    }
+    
+    if (out != NULL && out != stdout) {
+        fclose(out);
+    }
+    free(threads);
+    free(workers);
+    free(deques);
+    free(results);
+    free(configs);
+    freeTrace(&trace);
+    return ok;
+}
+
+// Muestra el menú de opciones
+void displayMenu() {
+    printf("\n=== Simulador de Administración de Memoria ===\n");
+    printf("1. Establecer modo de partición\n");
+    printf("2. Cargar proceso\n");
+    printf("3. Liberar proceso\n");
+    printf("4. Calcular fragmentación\n");
+    printf("5. Compactar memoria\n");
+    printf("6. Mostrar estado de memoria\n");
+    printf("7. Seleccionar política de ubicación\n");
+    printf("8. Activar/desactivar el mapa después de cada operación\n");
+    printf("9. Exportar mapa de memoria (CSV o JSON)\n");
+    printf("10. Estadísticas de instrumentación\n");
+    printf("0. Salir\n");
+}
+
+// Describe el modo de partición recién establecido
+void printPartitionMode(MemorySimulator* sim) {
+    if (sim->partition_type == FIXED_PARTITIONS) {
+        const PartitionIndex* index = &sim->partitions;
+        const char* unit_name = memoryUnitName(sim->unit);
+        
+        if (index->count == 1) {
+            printf("Modo de particiones fijas establecido con %d particiones de %llu %s cada una.\n",
+                   sim->num_fixed_partitions, (unsigned long long) sim->fixed_partition_size, unit_name);
+        } else {
+            printf("Modo de particiones fijas establecido con %d particiones de %zu tamaños (de %llu a %llu %s).\n",
+                   sim->num_fixed_partitions, index->count, (unsigned long long) index->sizes[0],
+                   (unsigned long long) index->sizes[index->count - 1], unit_name);
+        }
+        
+        // Lo que sigue a la última partición no se puede asignar
+        if (sim->usable_memory < sim->total_memory) {
+            printf("Quedan %llu %s sin particionar.\n",
+                   (unsigned long long) (sim->total_memory - sim->usable_memory), unit_name);
+        }
+    } else if (sim->partition_type == BUDDY_PARTITIONS) {
+        printf("Modo buddy establecido (bloques de %llu a %llu %s en potencias de dos).\n",
+               1ULL << sim->buddy_min_order, 1ULL << sim->buddy_max_order, memoryUnitName(sim->unit));
+    } else if (sim->partition_type == BITMAP_PARTITIONS) {
+        printf("Modo mapa de bits establecido (%zu bits de %llu %s cada uno).\n",
+               sim->bitmap_bits, (unsigned long long) sim->bitmap_chunk, memoryUnitName(sim->unit));
+    } else {
+        printf("Modo de particiones dinámicas establecido.\n");
+    }
+}
+
+// Explica por qué el motor rechazó una asignación pedida desde el menú
+void printAllocationError(MemorySimulator* sim, SimStatus status, const char* process_name) {
+    if (status == SIM_ERR_DUPLICATE) {
+        printf("Error: Ya existe un proceso con el nombre '%s'.\n", process_name);
+    } else if (status == SIM_ERR_FRAGMENTATION && sim->partition_type == FIXED_PARTITIONS) {
+        printf("Error: No se encontró una partición libre lo suficientemente grande.\n");
+    } else if (status == SIM_ERR_FRAGMENTATION && sim->partition_type == BUDDY_PARTITIONS) {
+        printf("Error: No se encontró un bloque buddy libre lo suficientemente grande.\n");
+    } else {
+        printf("Error: %s.\n", simStatusMessage(status));
+    }
+}
+
+// Lee una disposición de particiones fijas del texto o, si empieza con '@', del archivo que
+// nombra (entradas separadas por comas, espacios o líneas; '#' inicia un comentario).
+// Informa el error si no se pudo
+bool readPartitionLayout(const char* text, MemoryUnit unit, MemSize** sizes, size_t* count) {
+    if (text[0] != '@') {
+        if (!parsePartitionLayout(text, unit, sizes, count)) {
+            fprintf(stderr, "Error: Disposición de particiones inválida '%s'.\n", text);
+            return false;
+        }
+        return true;
+    }
+    
+    const char* path = text + 1;
+    FILE* file = fopen(path, "r");
+    
+    if (file == NULL) {
+        fprintf(stderr, "Error: No se pudo abrir el archivo de particiones '%s'.\n", path);
+        return false;
+    }
+    
+    char line[MAX_TRACE_LINE];
+    uint64_t line_number = 0;
+    MemSize* result = NULL;
+    size_t used = 0;
+    bool ok = true;
+    
+    while (ok && fgets(line, sizeof(line), file) != NULL) {
+        line_number++;
+        if (strchr(line, '\n') == NULL && !feof(file)) {
+            fprintf(stderr, "Error: Línea %llu demasiado larga en '%s'.\n", (unsigned long long) line_number, path);
+            ok = false;
+            break;
+        }
+        
+        line[strcspn(line, "#")] = '\0';
+        if (line[strspn(line, ", \t\r\n")] == '\0') {
+            continue;
+        }
+        
+        MemSize* line_sizes;
+        size_t line_count;
+        if (!parsePartitionLayout(line, unit, &line_sizes, &line_count)) {
+            fprintf(stderr, "Error: Línea %llu inválida en '%s'.\n", (unsigned long long) line_number, path);
+            ok = false;
+            break;
+        }
+        
+        MemSize* grown = (line_count <= INT32_MAX - used)
+            ? (MemSize*) realloc(result, (used + line_count) * sizeof(MemSize))
+            : NULL;
+        if (grown == NULL) {
+            fprintf(stderr, "Error: Demasiadas particiones en '%s'.\n", path);
+            free(line_sizes);
+            ok = false;
+            break;
+        }
+        
+        memcpy(grown + used, line_sizes, line_count * sizeof(MemSize));
+        result = grown;
+        used += line_count;
+        free(line_sizes);
+    }
+    fclose(file);
+    
+    if (ok && used == 0) {
+        fprintf(stderr, "Error: El archivo de particiones '%s' no define ninguna partición.\n", path);
+        ok = false;
+    }
+    if (!ok) {
+        free(result);
+        return false;
+    }
+    
+    *sizes = result;
+    *count = used;
+    return true;
+}
+
+// Establece las particiones fijas que describe el texto (ver readPartitionLayout)
+bool applyPartitionLayout(MemorySimulator* sim, const char* text) {
+    MemSize* sizes;
+    size_t count;
+    
+    if (!readPartitionLayout(text, sim->unit, &sizes, &count)) {
+        return false;
+    }
+    
+    SimStatus status = setFixedPartitions(sim, sizes, count);
+    free(sizes);
+    
+    if (status == SIM_ERR_INVALID_ARGUMENT) {
+        fprintf(stderr, "Error: Las particiones no caben en %llu %s de memoria.\n",
+                (unsigned long long) sim->total_memory, memoryUnitName(sim->unit));
+    } else if (status != SIM_OK) {
+        fprintf(stderr, "Error: %s.\n", simStatusMessage(status));
+    }
+    return status == SIM_OK;
+}
+
+// Guarda un snapshot e informa el motivo si no se pudo
+bool writeSnapshot(MemorySimulator* sim, const char* path, uint64_t trace_line) {
+    SimStatus status = saveSnapshot(sim, path, trace_line);
+    
+    if (status != SIM_OK) {
+        fprintf(stderr, "Error: No se pudo guardar el snapshot '%s': %s.\n", path, simStatusMessage(status));
+    }
+    return status == SIM_OK;
+}
+
+// Muestra la forma de uso del programa
+void printUsage(const char* program) {
+    fprintf(stderr, "Uso: %s [--memory tamaño] [--unit mb|kb|page|byte]\n", program);
+    fprintf(stderr, "          [--policy first|next|best|worst|segregated|scan]\n");
+    fprintf(stderr, "          [--compact-on-fail] [--trace archivo] [--scale-check bloques]\n");
+    fprintf(stderr, "          [--bench-scan] [--bench-threads N [--arenas A]]\n");
+    fprintf(stderr, "          [--bench-suite [--bench-json archivo] [--bench-baseline archivo] [--bench-reps N]\n");
+    fprintf(stderr, "           [--bench-max-blocks N] [--bench-threshold porcentaje]]\n");
+    fprintf(stderr, "          [--sweep traza --grid especificación [--jobs N] [--csv archivo]]\n");
+    fprintf(stderr, "          [--generate eventos [--sizes dist] [--lifetime dist] [--seed N]]\n");
+    fprintf(stderr, "          [--des eventos | --horizon tiempo] [--interarrival dist] [--arrivals archivo]\n");
+    fprintf(stderr, "          [--queue fifo|smallest|priority [--priorities dist]]\n");
+    fprintf(stderr, "          [--layout particiones|@archivo]\n");
+    fprintf(stderr, "          [--restore snapshot [--resume]] [--save snapshot] [--export-map archivo]\n");
+    fprintf(stderr, "          [--stats-dump archivo]\n");
+    fprintf(stderr, "          [--paging referencias [--page-size tamaño] [--frames N] [--tlb entradas]\n");
+    fprintf(stderr, "           [--replace fifo,lru,clock,aging] [--aging-interval referencias]]\n");
+    fprintf(stderr, "          [--checkpoint-every operaciones [--checkpoint-prefix prefijo]]\n");
+    fprintf(stderr, "  Sin --trace se ejecuta el menú interactivo (--no-map: sin el mapa después de cada operación).\n");
+    fprintf(stderr, "  Los tamaños se expresan en la unidad elegida (MB por defecto) o con sufijo\n");
+    fprintf(stderr, "  B, K, M, G o T (por ejemplo 512K o 4G); se redondean hacia arriba a unidades.\n");
+    fprintf(stderr, "  Formato de la traza (una operación por línea, '#' inicia un comentario):\n");
+    fprintf(stderr, "    alloc <nombre> <tamaño>\n");
+    fprintf(stderr, "    free <nombre>\n");
+    fprintf(stderr, "    compact [blocks <K> | mb <tamaño> | fit <tamaño>]\n");
+    fprintf(stderr, "    mode fixed <particiones> | mode dynamic | mode buddy | mode bitmap [unidades por bit]\n");
+    fprintf(stderr, "    policy first|next|best|worst|segregated|scan\n");
+    fprintf(stderr, "  Particiones fijas de --layout: tamaños separados por ',' con repetición opcional\n");
+    fprintf(stderr, "    NxTAMAÑO (por ejemplo 4x16M,2x64M,128M); con @archivo se leen de un archivo.\n");
+    fprintf(stderr, "  Grilla del barrido (dimensiones separadas por ';', valores por ','):\n");
+    fprintf(stderr, "    memory=64,256;partitions=4,8;mode=fixed,dynamic,buddy,bitmap;policy=first,best\n");
+    fprintf(stderr, "  Distribuciones del generador (--sizes en unidades, --lifetime en asignaciones):\n");
+    fprintf(stderr, "    fixed:V | uniform:MIN:MAX | exp:MEDIA | pareto:FORMA:MIN | bimodal:CHICO:GRANDE:PROB\n");
+    fprintf(stderr, "  En la simulación por eventos --lifetime es la duración en unidades de tiempo y el\n");
+    fprintf(stderr, "  archivo de llegadas tiene líneas \"<llegada> <tamaño> <duración> [prioridad]\" ordenadas.\n");
+    fprintf(stderr, "  Con --queue las llegadas que no caben esperan y entran al liberarse memoria.\n");
+    fprintf(stderr, "  La traza de referencias tiene líneas \"<proceso> <dirección> [r|w]\" (dirección\n");
+    fprintf(stderr, "  decimal o con prefijo 0x); sin --frames, los marcos salen de --memory.\n");
+}
+
+// Imprime los contadores y las latencias del camino crítico
+void printInstrumentation(FILE* out, MemorySimulator* sim) {
+#ifdef INSTRUMENTATION
+    static const char* op_names[INSTR_OP_COUNT] = { "asignar", "liberar", "compactar", "fragm." };
+    const InstrStats* instr = &sim->instr;
+    double ticks_per_ns = instrTicksPerNs();
+    
+    fprintf(out, "\n=== Instrumentación del camino crítico ===\n");
+    fprintf(out, "%-10s %10s %8s %8s %8s %8s %10s\n",
+            "Operación", "Llamadas", "Media", "p50", "p90", "p99", "Máx (ns)");
+    fprintf(out, "--------------------------------------------------------------------\n");
+    
+    for (int i = 0; i < INSTR_OP_COUNT; i++) {
+        const LatencyHistogram* hist = &instr->latency[i];
+        
+        fprintf(out, "%-10s %10llu %8.0f %8.0f %8.0f %8.0f %10.0f\n", op_names[i],
+                (unsigned long long) hist->count,
+                hist->count > 0 ? (double) hist->total_ns / (double) hist->count / ticks_per_ns : 0.0,
+                (double) latencyPercentile(hist, 50.0) / ticks_per_ns,
+                (double) latencyPercentile(hist, 90.0) / ticks_per_ns,
+                (double) latencyPercentile(hist, 99.0) / ticks_per_ns,
+                (double) hist->max_ns / ticks_per_ns);
+    }
+    
+    fprintf(out, "\nBúsquedas de bloque libre: %llu (examinados: %llu, media %.1f, máximo %llu)\n",
+            (unsigned long long) instr->searches, (unsigned long long) instr->blocks_visited,
+            instr->searches > 0 ? (double) instr->blocks_visited / (double) instr->searches : 0.0,
+            (unsigned long long) instr->max_visited);
+    fprintf(out, "Divisiones: %llu, fusiones: %llu\n",
+            (unsigned long long) instr->splits, (unsigned long long) instr->coalesces);
+    fprintf(out, "Asignaciones fallidas: sin espacio %llu, fragmentación %llu, nombre duplicado %llu, "
+                 "tamaño inválido %llu, sin nodos %llu\n",
+            (unsigned long long) instr->failures[SIM_ERR_NO_SPACE],
+            (unsigned long long) instr->failures[SIM_ERR_FRAGMENTATION],
+            (unsigned long long) instr->failures[SIM_ERR_DUPLICATE],
+            (unsigned long long) instr->failures[SIM_ERR_INVALID_SIZE],
+            (unsigned long long) instr->failures[SIM_ERR_NO_MEMORY]);
+    fprintf(out, "Liberaciones fallidas: proceso inexistente %llu\n",
+            (unsigned long long) instr->failures[SIM_ERR_NOT_FOUND]);
+#else
+    (void) sim;
+    fprintf(out, "\nInstrumentación deshabilitada en esta compilación (NO_INSTRUMENTATION).\n");
+#endif
+}
+
+// Escribe el reporte de instrumentación en un archivo (al terminar el programa)
+bool dumpInstrumentation(MemorySimulator* sim, const char* path) {
+    FILE* out = fopen(path, "w");
+    if (out == NULL) {
+        printf("Error: No se pudo crear '%s': %s\n", path, strerror(errno));
+        return false;
+    }
+    
+    printInstrumentation(out, sim);
+    
+    bool ok = !ferror(out);
+    if (fclose(out) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        printf("Error: No se pudo escribir '%s'.\n", path);
+    }
+    return ok;
+}
+
+// Lee una cantidad entera en decimal, sin sufijos de unidad ni caracteres sobrantes
+bool parseCount(const char* text, uint64_t* value) {
+    if (!isdigit((unsigned char) text[0])) {
+        return false;
+    }
+    
+    char* end;
+    errno = 0;
+    unsigned long long parsed = strtoull(text, &end, 10);
+    if (errno == ERANGE || *end != '\0') {
+        return false;
+    }
+    
+    *value = parsed;
+    return true;
+}
+
+// Interpreta una línea de traza. Devuelve 1 si produjo una operación, 0 si la línea está
+// vacía o es un comentario y -1 si es inválida (después de advertirlo por stderr)
+int parseTraceLine(char* line, MemoryUnit unit, uint64_t line_number, TraceOp* op) {
+    // Ignorar comentarios
+    char* comment = strchr(line, '#');
+    if (comment != NULL) {
+        *comment = '\0';
+    }
+    
+    char command[16];
+    char arg1[MAX_TRACE_LINE];
+    char arg2[MAX_TRACE_LINE];
+    int fields = sscanf(line, "%15s %255s %255s", command, arg1, arg2);
+    
+    if (fields <= 0) {
+        return 0;  // Línea vacía
+    }
+    
+    memset(op, 0, sizeof(TraceOp));
+    
+    if ((strcmp(command, "alloc") == 0 || strcmp(command, "a") == 0) && fields == 3) {
+        if (strlen(arg1) >= MAX_PROCESS_NAME) {
+            fprintf(stderr, "Advertencia: línea %llu: nombre de proceso demasiado largo.\n",
+                    (unsigned long long) line_number);
+            return -1;
+        }
+        if (!parseMemorySize(arg2, unit, &op->amount)) {
+            fprintf(stderr, "Advertencia: línea %llu: tamaño inválido.\n",
+                    (unsigned long long) line_number);
+            return -1;
+        }
+        
+        op->type = TRACE_ALLOC;
+        strcpy(op->name, arg1);
+    } else if ((strcmp(command, "free") == 0 || strcmp(command, "f") == 0) && fields == 2) {
+        op->type = TRACE_FREE;
+        // Un nombre demasiado largo no puede estar cargado: el free fallará siempre
+        if (strlen(arg1) >= MAX_PROCESS_NAME) {
+            op->variant = TRACE_FREE_UNKNOWN;
+        } else {
+            strcpy(op->name, arg1);
+        }
+    } else if ((strcmp(command, "compact") == 0 || strcmp(command, "c") == 0) && fields == 1) {
+        op->type = TRACE_COMPACT;
+        op->variant = TRACE_COMPACT_ALL;
+    } else if ((strcmp(command, "compact") == 0 || strcmp(command, "c") == 0) && fields == 3) {
+        // Variantes: compact blocks <K> | compact mb <tamaño> | compact fit <tamaño>
+        // ("mb" limita lo movido; el tamaño va en la unidad de la simulación o con sufijo;
+        // la cantidad de bloques es un número sin sufijo)
+        bool valid = (strcmp(arg1, "blocks") == 0) ? parseCount(arg2, &op->amount)
+                                                   : parseMemorySize(arg2, unit, &op->amount);
+        if (!valid || op->amount == 0 || (strcmp(arg1, "blocks") != 0 && strcmp(arg1, "mb") != 0 &&
+                                          strcmp(arg1, "fit") != 0)) {
+            fprintf(stderr, "Advertencia: línea %llu: compactación inválida.\n",
+                    (unsigned long long) line_number);
+            return -1;
+        }
+        
+        op->type = TRACE_COMPACT;
+        op->variant = (strcmp(arg1, "blocks") == 0) ? TRACE_COMPACT_BLOCKS
+                    : (strcmp(arg1, "mb") == 0) ? TRACE_COMPACT_SIZE : TRACE_COMPACT_FIT;
+    } else if ((strcmp(command, "mode") == 0 || strcmp(command, "m") == 0) && fields >= 2) {
+        op->type = TRACE_MODE;
+        
+        // Cantidad de particiones fijas o trozo del mapa de bits: un número sin sufijo que
+        // setPartitionMode recibe como int
+        uint64_t count = 0;
+        bool count_valid = fields == 3 && parseCount(arg2, &count) && count > 0 && count <= INT_MAX;
+        
+        if (strcmp(arg1, "fixed") == 0 && count_valid) {
+            op->variant = FIXED_PARTITIONS;
+            op->amount = count;
+        } else if (strcmp(arg1, "dynamic") == 0 && fields == 2) {
+            op->variant = DYNAMIC_PARTITIONS;
+        } else if (strcmp(arg1, "buddy") == 0 && fields == 2) {
+            op->variant = BUDDY_PARTITIONS;
+        } else if (strcmp(arg1, "bitmap") == 0 && (fields == 2 || count_valid)) {
+            op->variant = BITMAP_PARTITIONS;
+            op->amount = count;
+        } else {
+            fprintf(stderr, "Advertencia: línea %llu: modo inválido.\n",
+                    (unsigned long long) line_number);
+            return -1;
+        }
+    } else if (strcmp(command, "policy") == 0 && fields == 2) {
+        PlacementPolicy policy;
+        
+        if (!parsePlacementPolicy(arg1, &policy)) {
+            fprintf(stderr, "Advertencia: línea %llu: política inválida.\n",
+                    (unsigned long long) line_number);
+            return -1;
+        }
+        
+        op->type = TRACE_POLICY;
+        op->variant = (uint8_t) policy;
+    } else {
+        fprintf(stderr, "Advertencia: línea %llu: operación inválida.\n",
+                (unsigned long long) line_number);
+        return -1;
+    }
+    
+    return 1;
+}
+
+// Ejecuta una operación de traza sobre el simulador midiendo su latencia y muestreando
+// la fragmentación. Con compact_on_fail, un alloc que falla por fragmentación compacta
+// solo hasta que quepa y se reintenta. Devuelve si la operación tuvo éxito
+bool executeTraceOp(MemorySimulator* sim, const TraceOp* op, bool compact_on_fail, TraceReport* report) {
+    CompactionResult result;
+    SimStatus status;
+    bool ok = true;
+    uint64_t start = monotonicNanos();
+    
+    switch (op->type) {
+        case TRACE_ALLOC:
+            status = allocateProcess(sim, (char*) op->name, op->amount);
+            
+            // Si el espacio libre alcanza pero está fragmentado, compactar lo justo y reintentar
+            if (status == SIM_ERR_FRAGMENTATION && compact_on_fail) {
+                if (compactUntilFits(sim, op->amount, &result)) {
+                    report->fit_compactions++;
+                    status = allocateProcess(sim, (char*) op->name, op->amount);
+                }
+            }
+            ok = status == SIM_OK;
+            break;
+        
+        case TRACE_FREE:
+            ok = (op->variant != TRACE_FREE_UNKNOWN) && deallocateProcess(sim, (char*) op->name) == SIM_OK;
+            break;
+        
+        case TRACE_COMPACT:
+            // Fuera del modo dinámico compactar no hace nada, pero no cuenta como fallo
+            if (op->variant == TRACE_COMPACT_ALL) {
+                compactMemory(sim, &result);
+            } else if (op->variant == TRACE_COMPACT_BLOCKS) {
+                compactMemoryStep(sim, op->amount, 0, &result);
+            } else if (op->variant == TRACE_COMPACT_SIZE) {
+                compactMemoryStep(sim, 0, op->amount, &result);
+            } else {
+                ok = compactUntilFits(sim, op->amount, &result);
+            }
+            break;
+            
+        case TRACE_MODE:
+            ok = setPartitionMode(sim, (PartitionType) op->variant, (int) op->amount) == SIM_OK;
+            break;
+        
+        case TRACE_POLICY:
+            ok = setPlacementPolicy(sim, (PlacementPolicy) op->variant) == SIM_OK;
+            break;
+            
+        default:
+            break;
+    }
+    
+    uint64_t elapsed = monotonicNanos() - start;
+    latencyRecord(&report->latency[op->type], elapsed);
+    report->sim_ns += elapsed;
+    
+    if (!ok) {
+        report->failures[op->type]++;
+    }
+    
+    // Muestrear la fragmentación después de cada operación (fuera del tiempo medido; el
+    // mayor bloque libre sale del índice de la política, sin recorrer el mapa)
+    MemoryStats stats;
+    getMemoryStats(sim, &stats);
+    report->samples++;
+    report->sum_external_ratio += stats.external_ratio;
+    report->sum_free_blocks += stats.free_blocks;
+    if (stats.external_ratio > report->max_external_ratio) {
+        report->max_external_ratio = stats.external_ratio;
+    }
+    if (stats.free_blocks > report->max_free_blocks) {
+        report->max_free_blocks = stats.free_blocks;
+    }
+    
+    return ok;
+}
+
+// Reproduce un archivo de traza sobre el simulador midiendo cada operación
+// Con compact_on_fail, un alloc que falla por fragmentación compacta solo hasta que quepa.
+// Con checkpoint (puede ser NULL) se saltean las líneas ya aplicadas y se guarda un
+// snapshot cada checkpoint->every operaciones
+bool runTraceFile(MemorySimulator* sim, const char* path, bool compact_on_fail, TraceReport* report,
+                  TraceCheckpoint* checkpoint) {
+    FILE* file = fopen(path, "r");
+    
+    if (file == NULL) {
+        fprintf(stderr, "Error: No se pudo abrir la traza '%s'.\n", path);
+        return false;
+    }
+    
+    char line[MAX_TRACE_LINE];
+    uint64_t line_number = 0;
+    uint64_t wall_start = monotonicNanos();
+    TraceOp op;
+    uint64_t executed = 0;
+    
+    while (fgets(line, sizeof(line), file) != NULL) {
+        line_number++;
+        
+        // Al reanudar, el estado ya incluye estas líneas
+        if (checkpoint != NULL && line_number <= checkpoint->skip_lines) {
+            continue;
+        }
+        
+        // El tamaño se interpreta en la unidad actual de la simulación
+        int parsed = parseTraceLine(line, sim->unit, line_number, &op);
+        if (parsed < 0) {
+            report->invalid_lines++;
+        } else if (parsed > 0) {
+            executeTraceOp(sim, &op, compact_on_fail, report);
+            executed++;
+            
+            if (checkpoint != NULL && checkpoint->every > 0 && executed % checkpoint->every == 0) {
+                char snapshot_path[MAX_TRACE_LINE + 32];
+                snprintf(snapshot_path, sizeof(snapshot_path), "%s.%llu.snap", checkpoint->prefix,
+                         (unsigned long long) line_number);
+                if (writeSnapshot(sim, snapshot_path, line_number)) {
+                    checkpoint->written++;
+                }
+            }
+        }
+    }
+    
+    report->wall_ns = monotonicNanos() - wall_start;
+    if (checkpoint != NULL) {
+        checkpoint->last_line = line_number;
+    }
+    fclose(file);
+    
+    return true;
+}
+
+// Lee una traza completa a memoria para reproducirla varias veces sin volver a
+// interpretarla. Devuelve false si no se pudo abrir o si faltó memoria
+bool loadTrace(const char* path, MemoryUnit unit, TraceProgram* program) {
+    FILE* file = fopen(path, "r");
+    
+    memset(program, 0, sizeof(TraceProgram));
+    program->unit = unit;
+    
+    if (file == NULL) {
+        fprintf(stderr, "Error: No se pudo abrir la traza '%s'.\n", path);
+        return false;
+    }
+    
+    char line[MAX_TRACE_LINE];
+    uint64_t line_number = 0;
+    TraceOp op;
+    
+    while (fgets(line, sizeof(line), file) != NULL) {
+        line_number++;
+        
+        int parsed = parseTraceLine(line, unit, line_number, &op);
+        if (parsed < 0) {
+            program->invalid_lines++;
+            continue;
+        }
+        if (parsed == 0) {
+            continue;
+        }
+        
+        if (program->count == program->capacity) {
+            size_t capacity = program->capacity == 0 ? 1024 : program->capacity * 2;
+            TraceOp* ops = (TraceOp*) realloc(program->ops, capacity * sizeof(TraceOp));
+            
+            if (ops == NULL) {
+                fprintf(stderr, "Error: No se pudo asignar memoria para la traza.\n");
+                fclose(file);
+                freeTrace(program);
+                return false;
+            }
+            program->ops = ops;
+            program->capacity = capacity;
+        }
+        program->ops[program->count++] = op;
+    }
+    
+    fclose(file);
+    return true;
+}
+
+// Libera las operaciones de una traza cargada en memoria
+void freeTrace(TraceProgram* program) {
+    free(program->ops);
+    program->ops = NULL;
+    program->count = 0;
+    program->capacity = 0;
+}
+
+// Número aleatorio de 64 bits (xorshift64*)
+static uint64_t nextRandom(uint64_t* state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1DULL;
+}
+
+// Número aleatorio uniforme en [0, 1)
+static double nextRandomUnit(uint64_t* state) {
+    return (double) (nextRandom(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Interpreta una distribución "tipo:parámetros". Los tamaños aceptan sufijos:
+//   fixed:V | uniform:MIN:MAX | exp:MEDIA | pareto:FORMA:MIN | bimodal:CHICO:GRANDE:PROB
+// max acota los valores generados; se rechazan los valores y cotas mayores que max
+bool parseDistribution(const char* spec, MemoryUnit unit, MemSize max, Distribution* dist) {
+    char kind[16] = "";
+    char p1[64] = "", p2[64] = "", p3[64] = "";
+    MemSize v1 = 0, v2 = 0;
+    
+    int fields = sscanf(spec, "%15[^:]:%63[^:]:%63[^:]:%63s", kind, p1, p2, p3);
+    memset(dist, 0, sizeof(Distribution));
+    dist->max = max;
+    
+    if (strcmp(kind, "fixed") == 0 && fields == 2 && parseMemorySize(p1, unit, &v1) && v1 > 0 && v1 <= max) {
+        dist->kind = DIST_FIXED;
+        dist->a = (double) v1;
+    } else if (strcmp(kind, "uniform") == 0 && fields == 3 && parseMemorySize(p1, unit, &v1) &&
+               parseMemorySize(p2, unit, &v2) && v1 > 0 && v1 <= v2 && v2 <= max) {
+        dist->kind = DIST_UNIFORM;
+        dist->low = v1;
+        dist->high = v2;
+    } else if (strcmp(kind, "exp") == 0 && fields == 2 && parseMemorySize(p1, unit, &v1) && v1 > 0) {
+        dist->kind = DIST_EXPONENTIAL;
+        dist->a = (double) v1;
+    } else if (strcmp(kind, "pareto") == 0 && fields == 3 && atof(p1) > 0 &&
+               parseMemorySize(p2, unit, &v2) && v2 > 0 && v2 <= max) {
+        dist->kind = DIST_PARETO;
+        dist->a = atof(p1);
+        dist->b = (double) v2;
+    } else if (strcmp(kind, "bimodal") == 0 && fields == 4 && parseMemorySize(p1, unit, &v1) &&
+               parseMemorySize(p2, unit, &v2) && v1 > 0 && v2 > 0 && v1 <= max && v2 <= max &&
+               atof(p3) >= 0 && atof(p3) <= 1) {
+        dist->kind = DIST_BIMODAL;
+        dist->a = (double) v1;
+        dist->b = (double) v2;
+        dist->c = atof(p3);
+    } else {
+        return false;
+    }
+    
+    return true;
+}
+
+// Genera un valor de la distribución, redondeado hacia arriba y acotado a [1, max]
+uint64_t sampleDistribution(const Distribution* dist, uint64_t* rng) {
+    double value;
+    
+    switch (dist->kind) {
+        case DIST_UNIFORM: {
+            // El rango se calcula en enteros; si abarca los 2^64 valores no hace falta el módulo
+            uint64_t span = dist->high - dist->low;
+            uint64_t offset = (span == UINT64_MAX) ? nextRandom(rng) : nextRandom(rng) % (span + 1);
+            return dist->low + offset;  // parseDistribution garantiza 1 <= low <= high <= max
+        }
+        case DIST_EXPONENTIAL:
+            value = -dist->a * log(1.0 - nextRandomUnit(rng));
+            break;
+        case DIST_PARETO:
+            value = dist->b / pow(1.0 - nextRandomUnit(rng), 1.0 / dist->a);
+            break;
+        case DIST_BIMODAL:
+            value = (nextRandomUnit(rng) < dist->c) ? dist->b : dist->a;
+            break;
+        default:
+            value = dist->a;
+            break;
+    }
+    
+    if (!(value < (double) dist->max)) {
+        return dist->max;  // También cubre valores enormes de la cola de Pareto
+    }
+    return value <= 1.0 ? 1 : (uint64_t) ceil(value);
+}
+
+// Escribe el nombre único del proceso número id: "g" seguido del número en base 36
+// (a lo sumo 14 caracteres, siempre cabe en MAX_PROCESS_NAME)
+void formatProcessName(uint64_t id, char* name) {
+    static const char digits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+    char buffer[16];
+    int length = 0;
+    
+    do {
+        buffer[length++] = digits[id % 36];
+        id /= 36;
+    } while (id > 0);
+    
+    name[0] = 'g';
+    for (int i = 0; i < length; i++) {
+        name[i + 1] = buffer[length - 1 - i];
+    }
+    name[length + 1] = '\0';
+}
+
+// Agrega una salida al heap. Devuelve false si no hay memoria
+bool departureHeapPush(DepartureHeap* heap, uint64_t time, uint64_t name_id) {
+    if (heap->count == heap->capacity) {
+        size_t capacity = heap->capacity == 0 ? DEPARTURE_HEAP_INITIAL_CAPACITY : heap->capacity * 2;
+        Departure* entries = (Departure*) realloc(heap->entries, capacity * sizeof(Departure));
+        
+        if (entries == NULL) {
+            return false;
+        }
+        heap->entries = entries;
+        heap->capacity = capacity;
+    }
+    
+    // Subir el hueco hasta la posición del nuevo elemento
+    size_t i = heap->count++;
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (heap->entries[parent].time <= time) {
+            break;
+        }
+        heap->entries[i] = heap->entries[parent];
+        i = parent;
+    }
+    heap->entries[i].time = time;
+    heap->entries[i].name_id = name_id;
+    return true;
+}
+
+// Quita y devuelve la salida más próxima (el heap no debe estar vacío)
+Departure departureHeapPop(DepartureHeap* heap) {
+    Departure top = heap->entries[0];
+    Departure last = heap->entries[--heap->count];
+    size_t i = 0;
+    
+    // Bajar el hueco de la raíz eligiendo siempre el hijo menor
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= heap->count) {
+            break;
+        }
+        if (child + 1 < heap->count && heap->entries[child + 1].time < heap->entries[child].time) {
+            child++;
+        }
+        if (last.time <= heap->entries[child].time) {
+            break;
+        }
+        heap->entries[i] = heap->entries[child];
+        i = child;
+    }
+    if (heap->count > 0) {
+        heap->entries[i] = last;
+    }
+    
+    return top;
+}
+
+// Libera el heap de salidas
+void departureHeapFree(DepartureHeap* heap) {
+    free(heap->entries);
+    memset(heap, 0, sizeof(DepartureHeap));
+}
+
+// Prepara el generador con las distribuciones y la semilla indicadas
+void generatorInit(WorkloadGenerator* gen, const Distribution* sizes, const Distribution* lifetimes, uint64_t seed) {
+    memset(gen, 0, sizeof(WorkloadGenerator));
+    gen->sizes = *sizes;
+    gen->lifetimes = *lifetimes;
+    gen->rng = seed != 0 ? seed : 0x9E3779B97F4A7C15ULL;  // xorshift no admite estado cero
+}
+
+// Produce el próximo evento: la salida de un proceso cuya vida terminó o, si no hay
+// ninguna pendiente, la llegada de un proceso nuevo (que avanza el reloj)
+void generatorNext(WorkloadGenerator* gen, TraceOp* op) {
+    op->variant = 0;
+    op->amount = 0;
+    
+    if (gen->departures.count > 0 && gen->departures.entries[0].time <= gen->clock) {
+        Departure departure = departureHeapPop(&gen->departures);
+        op->type = TRACE_FREE;
+        formatProcessName(departure.name_id, op->name);
+        gen->frees++;
+        return;
+    }
+    
+    op->type = TRACE_ALLOC;
+    op->amount = sampleDistribution(&gen->sizes, &gen->rng);
+    formatProcessName(gen->next_name_id++, op->name);
+    gen->clock++;
+    gen->allocations++;
+}
+
+// Programa la salida del proceso recién asignado (solo los que entraron tienen salida)
+bool generatorAdmit(WorkloadGenerator* gen, const TraceOp* op) {
+    (void) op;  // El proceso admitido es siempre el último generado
+    uint64_t lifetime = sampleDistribution(&gen->lifetimes, &gen->rng);
+    return departureHeapPush(&gen->departures, gen->clock + lifetime, gen->next_name_id - 1);
+}
+
+// Libera la memoria del generador
+void generatorFree(WorkloadGenerator* gen) {
+    departureHeapFree(&gen->departures);
+}
+
+// Ejecuta events eventos generados sobre el simulador, midiendo como en una traza
+bool runGeneratedWorkload(MemorySimulator* sim, WorkloadGenerator* gen, uint64_t events,
+                          bool compact_on_fail, TraceReport* report) {
+    uint64_t wall_start = monotonicNanos();
+    TraceOp op;
+    
+    for (uint64_t i = 0; i < events; i++) {
+        generatorNext(gen, &op);
+        
+        bool ok = executeTraceOp(sim, &op, compact_on_fail, report);
+        if (ok && op.type == TRACE_ALLOC && !generatorAdmit(gen, &op)) {
+            fprintf(stderr, "Error: No se pudo asignar memoria para el heap de salidas.\n");
+            return false;
+        }
+    }
+    
+    report->wall_ns = monotonicNanos() - wall_start;
+    return true;
+}
+
+// Obtiene la próxima llegada (instante, tamaño, duración y prioridad). Devuelve false si
+// no hay más
+bool arrivalNext(ArrivalSource* source, uint64_t* time, MemSize* size, uint64_t* duration, uint32_t* priority) {
+    if (source->file == NULL) {
+        uint64_t gap = sampleDistribution(&source->interarrival, &source->rng);
+        source->clock = (gap > UINT64_MAX - source->clock) ? UINT64_MAX : source->clock + gap;
+        *time = source->clock;
+        *size = sampleDistribution(&source->sizes, &source->rng);
+        *duration = sampleDistribution(&source->durations, &source->rng);
+        *priority = source->has_priorities ? (uint32_t) sampleDistribution(&source->priorities, &source->rng) : 0;
+        return true;
+    }
+    
+    char line[MAX_TRACE_LINE];
+    while (fgets(line, sizeof(line), source->file) != NULL) {
+        source->line_number++;
+        
+        char* comment = strchr(line, '#');
+        if (comment != NULL) {
+            *comment = '\0';
+        }
+        
+        if (line[strspn(line, " \t\r\n")] == '\0') {
+            continue;  // Línea vacía o solo con comentario
+        }
+        
+        unsigned long long arrival, length;
+        unsigned long rank = 0;
+        char size_text[64];
+        int fields = sscanf(line, "%llu %63s %llu %lu", &arrival, size_text, &length, &rank);
+        
+        // La salida (llegada + duración) tiene que caber en el reloj de 64 bits
+        if (fields < 3 || !parseMemorySize(size_text, source->unit, size) || length == 0 ||
+            length > UINT64_MAX - arrival || arrival < source->clock || rank > UINT32_MAX) {
+            fprintf(stderr, "Advertencia: línea %llu: llegada inválida o fuera de orden.\n",
+                    (unsigned long long) source->line_number);
+            source->invalid_lines++;
+            continue;
+        }
+        
+        source->clock = arrival;
+        *time = arrival;
+        *duration = length;
+        *priority = (uint32_t) rank;
+        return true;
+    }
+    
+    return false;
+}
+
+// Agranda los intervalos del perfil de la cola (uniendo pares vecinos y duplicando el
+// ancho) hasta que los BACKLOG_PROFILE_SLOTS intervalos cubran hasta el instante until
+static void backlogProfileCover(TimedReport* report, uint64_t until) {
+    uint64_t span = until - report->start_time;
+    
+    // Equivale a span > ancho * intervalos sin desbordar cerca del final del reloj
+    while (span / BACKLOG_PROFILE_SLOTS + (span % BACKLOG_PROFILE_SLOTS != 0) > report->profile_width) {
+        for (int i = 0; i < BACKLOG_PROFILE_SLOTS / 2; i++) {
+            report->backlog_profile[i] = report->backlog_profile[2 * i] + report->backlog_profile[2 * i + 1];
+        }
+        for (int i = BACKLOG_PROFILE_SLOTS / 2; i < BACKLOG_PROFILE_SLOTS; i++) {
+            report->backlog_profile[i] = 0;
+        }
+        report->profile_width *= 2;
+    }
+}
+
+// Acumula las métricas ponderadas por tiempo del intervalo [report->end_time, now) en que
+// el estado no cambió (con backlog solicitudes en espera) y avanza el reloj
+static void timedAdvance(MemorySimulator* sim, TimedReport* report, const MemoryStats* stats, size_t backlog,
+                         uint64_t now) {
+    if (now <= report->end_time) {
+        return;  // El reloj nunca retrocede
+    }
+    
+    double elapsed = (double) (now - report->end_time);
+    
+    report->used_area += elapsed * (double) (sim->usable_memory - sim->available_memory);
+    report->external_ratio_area += elapsed * stats->external_ratio;
+    report->free_blocks_area += elapsed * (double) stats->free_blocks;
+    report->backlog_area += elapsed * (double) backlog;
+    
+    // Repartir la espera entre los intervalos del perfil que toca el tramo
+    backlogProfileCover(report, now);
+    for (uint64_t t = report->end_time; backlog > 0 && t < now;) {
+        uint64_t offset = t - report->start_time;
+        uint64_t slot = offset / report->profile_width;
+        uint64_t slot_left = report->profile_width - offset % report->profile_width;
+        uint64_t piece_end = (now - t <= slot_left) ? now : t + slot_left;
+        
+        report->backlog_profile[slot] += (double) (piece_end - t) * (double) backlog;
+        t = piece_end;
+    }
+    report->end_time = now;
+}
+
+// Programa la salida de un proceso cargado en now que dura duration (si la suma no cabe
+// en 64 bits sale al final del reloj). Devuelve false si no hay memoria
+static bool timedScheduleDeparture(DepartureHeap* departures, uint64_t now, uint64_t duration, uint64_t name_id,
+                                   TimedReport* report) {
+    uint64_t time = (duration > UINT64_MAX - now) ? UINT64_MAX : now + duration;
+    
+    if (!departureHeapPush(departures, time, name_id)) {
+        fprintf(stderr, "Error: No se pudo asignar memoria para el heap de salidas.\n");
+        return false;
+    }
+    if (departures->count > report->max_live) {
+        report->max_live = departures->count;
+    }
+    return true;
+}
+
+// Admite las solicitudes en espera que caben en un hueco de hole unidades y programa sus
+// salidas. Devuelve false si no hay memoria para el heap de salidas
+static bool timedAdmitWaiting(AdmissionQueue* queue, MemorySimulator* sim, MemSize hole, uint64_t now,
+                              DepartureHeap* departures, TimedReport* report) {
+    QueuedRequest request;
+    
+    while (admissionQueueAdmit(queue, sim, &hole, now, &request)) {
+        if (!timedScheduleDeparture(departures, now, request.duration, request.tag, report)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Simula en orden de tiempo las llegadas del origen y las salidas programadas en un heap.
+// Se detiene al llegar a max_events eventos o al pasar el instante horizon (0 = sin límite).
+// Con una cola de admisión, las llegadas que no caben esperan en ella en lugar de
+// rechazarse, y cada salida o compactación admite las que entran en el hueco que dejó
+bool runTimedSimulation(MemorySimulator* sim, ArrivalSource* source, uint64_t max_events, uint64_t horizon,
+                        bool compact_on_fail, AdmissionQueue* queue, TimedReport* report) {
+    DepartureHeap departures = { NULL, 0, 0 };
+    uint64_t next_name_id = 0;
+    uint64_t arrival_time = 0, duration = 0;
+    uint32_t priority = 0;
+    MemSize size = 0;
+    char name[MAX_PROCESS_NAME];
+    MemoryStats stats;
+    bool ok = true;
+    
+    memset(report, 0, sizeof(TimedReport));
+    bool pending = arrivalNext(source, &arrival_time, &size, &duration, &priority);
+    report->start_time = report->end_time = pending ? arrival_time : 0;
+    report->profile_width = 1;
+    getMemoryStats(sim, &stats);
+    
+    uint64_t wall_start = monotonicNanos();
+    uint64_t events = 0;
+    
+    while ((max_events == 0 || events < max_events) && (pending || departures.count > 0)) {
+        // A igual instante se procesan primero las salidas: liberan memoria para la llegada
+        bool departure_first = departures.count > 0 &&
+                               (!pending || departures.entries[0].time <= arrival_time);
+        uint64_t now = departure_first ? departures.entries[0].time : arrival_time;
+        
+        if (horizon > 0 && now > horizon) {
+            break;
+        }
+        timedAdvance(sim, report, &stats, queue != NULL ? queue->count : 0, now);
+        
+        if (departure_first) {
+            Departure departure = departureHeapPop(&departures);
+            formatProcessName(departure.name_id, name);
+            deallocateProcess(sim, name);
+            report->departures++;
+            
+            // Solo el hueco que dejó la salida puede admitir a las que esperan
+            if (queue != NULL && !timedAdmitWaiting(queue, sim, freedHoleSize(sim), now, &departures, report)) {
+                ok = false;
+                break;
+            }
+        } else {
+            formatProcessName(next_name_id, name);
+            SimStatus status = allocateProcess(sim, name, size);
+            bool compacted = false;
+            
+            // Si el espacio libre alcanza pero está fragmentado, compactar lo justo y reintentar
+            if (status == SIM_ERR_FRAGMENTATION && compact_on_fail) {
+                CompactionResult result;
+                if (compactUntilFits(sim, size, &result)) {
+                    report->fit_compactions++;
+                    status = allocateProcess(sim, name, size);
+                    compacted = true;
+                }
+            }
+            
+            if (status == SIM_OK) {
+                if (!timedScheduleDeparture(&departures, now, duration, next_name_id, report)) {
+                    ok = false;
+                    break;
+                }
+            } else if (queue != NULL && (status == SIM_ERR_NO_SPACE || status == SIM_ERR_FRAGMENTATION)) {
+                QueuedRequest request;
+                request.size = size;
+                request.enqueued_at = now;
+                request.duration = duration;
+                request.tag = next_name_id;
+                request.priority = priority;
+                strcpy(request.process_name, name);
+                
+                // Las que no cabrían ni con la memoria vacía se rechazan en lugar de esperar
+                if (admissionQueuePush(queue, sim, &request) == SIM_OK) {
+                    report->queued++;
+                } else {
+                    report->rejected++;
+                }
+            } else {
+                report->rejected++;
+            }
+            
+            // Lo que sobró del hueco que armó la compactación puede admitir a otras
+            if (compacted && queue != NULL &&
+                !timedAdmitWaiting(queue, sim, largestFreeBlock(sim), now, &departures, report)) {
+                ok = false;
+                break;
+            }
+            
+            next_name_id++;
+            report->arrivals++;
+            pending = arrivalNext(source, &arrival_time, &size, &duration, &priority);
+        }
+        
+        getMemoryStats(sim, &stats);
+        events++;
+    }
+    
+    // Sin límite de tiempo la simulación termina con el último evento; con límite, en él
+    if (horizon > 0 && report->end_time < horizon && ok) {
+        timedAdvance(sim, report, &stats, queue != NULL ? queue->count : 0, horizon);
+    }
+    
+    report->wall_ns = monotonicNanos() - wall_start;
+    departureHeapFree(&departures);
+    return ok;
+}
+
+// Imprime el reporte de la simulación por eventos discretos (queue puede ser NULL)
+void printTimedReport(MemorySimulator* sim, const TimedReport* report, const AdmissionQueue* queue) {
+    uint64_t events = report->arrivals + report->departures;
+    double seconds = (double) report->wall_ns / 1e9;
+    double span = (double) (report->end_time - report->start_time);
+    const char* unit_name = memoryUnitName(sim->unit);
+    
+    printf("\n=== Resultados de la simulación por eventos discretos ===\n");
+    printf("Eventos: %llu (llegadas: %llu, rechazadas: %llu = %.2f%%, salidas: %llu)\n",
+           (unsigned long long) events, (unsigned long long) report->arrivals,
+           (unsigned long long) report->rejected,
+           report->arrivals > 0 ? 100.0 * (double) report->rejected / (double) report->arrivals : 0.0,
+           (unsigned long long) report->departures);
+    printf("Tiempo real: %.6f s (%.0f eventos/s)\n", seconds, seconds > 0 ? (double) events / seconds : 0.0);
+    printf("Tiempo simulado: de %llu a %llu (%.0f unidades de tiempo)\n",
+           (unsigned long long) report->start_time, (unsigned long long) report->end_time, span);
+    
+    if (span > 0) {
+        double used = report->used_area / span;
+        printf("Promedios ponderados por tiempo:\n");
+        printf("- Memoria ocupada: %.2f %s (utilización %.2f%%)\n",
+               used, unit_name, sim->usable_memory > 0 ? 100.0 * used / (double) sim->usable_memory : 0.0);
+        printf("- Índice de fragmentación externa: %.3f\n", report->external_ratio_area / span);
+        printf("- Bloques libres: %.1f\n", report->free_blocks_area / span);
+    }
+    
+    printf("Procesos cargados: %llu al final (máximo %llu); %llu compactaciones parciales\n",
+           (unsigned long long) sim->name_index_count, (unsigned long long) report->max_live,
+           (unsigned long long) report->fit_compactions);
+    
+    if (queue == NULL) {
+        return;
+    }
+    
+    const LatencyHistogram* wait = &queue->wait;
+    printf("\nCola de admisión (%s): %llu llegadas esperaron (%.2f%%), %llu admitidas, "
+           "%llu descartadas, %zu esperando al final\n",
+           queueDisciplineName(queue->discipline), (unsigned long long) report->queued,
+           report->arrivals > 0 ? 100.0 * (double) report->queued / (double) report->arrivals : 0.0,
+           (unsigned long long) queue->admitted, (unsigned long long) queue->dropped, queue->count);
+    printf("Espera de las admitidas: media %.1f, p50 %llu, p99 %llu, máxima %llu unidades de tiempo\n",
+           wait->count > 0 ? (double) wait->total_ns / (double) wait->count : 0.0,
+           (unsigned long long) latencyPercentile(wait, 50.0),
+           (unsigned long long) latencyPercentile(wait, 99.0), (unsigned long long) wait->max_ns);
+    printf("Solicitudes en espera: %.2f en promedio ponderado por tiempo, máximo %zu; "
+           "%.1f comparadas por admisión\n",
+           span > 0 ? report->backlog_area / span : 0.0, queue->max_count,
+           queue->admitted > 0 ? (double) queue->examined / (double) queue->admitted : 0.0);
+    
+    if (span <= 0) {
+        return;
+    }
+    
+    // Perfil: promedio de solicitudes en espera en cada intervalo, hasta el último evento
+    printf("Solicitudes en espera por intervalo de %llu unidades de tiempo:\n",
+           (unsigned long long) report->profile_width);
+    for (int i = 0; i < BACKLOG_PROFILE_SLOTS; i++) {
+        uint64_t offset = (uint64_t) i * report->profile_width;
+        if (offset >= report->end_time - report->start_time) {
+            break;
+        }
+        uint64_t from = report->start_time + offset;
+        uint64_t to = (report->end_time - from <= report->profile_width) ? report->end_time : from + report->profile_width;
+        printf("- [%llu, %llu): %.2f\n", (unsigned long long) from, (unsigned long long) to,
+               report->backlog_profile[i] / (double) (to - from));
+    }
+}
+
+// Imprime el reporte de rendimiento de una traza reproducida
+void printTraceReport(MemorySimulator* sim, const TraceReport* report) {
+    static const char* op_names[TRACE_OP_COUNT] = { "alloc", "free", "compact", "mode", "policy" };
+    
+    uint64_t total_ops = 0;
+    uint64_t total_failures = 0;
+    for (int i = 0; i < TRACE_OP_COUNT; i++) {
+        total_ops += report->latency[i].count;
+        total_failures += report->failures[i];
+    }
+    
+    double sim_seconds = (double) report->sim_ns / 1e9;
+    double wall_seconds = (double) report->wall_ns / 1e9;
+    
+    printf("\n=== Resultados de la reproducción de traza ===\n");
+    printf("Operaciones ejecutadas: %llu (fallidas: %llu, líneas inválidas: %llu)\n",
+           (unsigned long long) total_ops, (unsigned long long) total_failures,
+           (unsigned long long) report->invalid_lines);
+    printf("Tiempo en el simulador: %.6f s (total con lectura: %.6f s)\n", sim_seconds, wall_seconds);
+    printf("Rendimiento: %.0f ops/s\n", sim_seconds > 0 ? (double) total_ops / sim_seconds : 0.0);
+    
+    printf("\nLatencia por operación (ns):\n");
+    printf("%-8s %10s %8s %8s %8s %8s %8s %8s %10s\n",
+           "Tipo", "Cantidad", "Fallos", "Media", "p50", "p90", "p99", "p99.9", "Máx");
+    printf("--------------------------------------------------------------------------------\n");
+    
+    for (int i = 0; i < TRACE_OP_COUNT; i++) {
+        const LatencyHistogram* hist = &report->latency[i];
+        if (hist->count == 0) {
+            continue;
+        }
+        
+        printf("%-8s %10llu %8llu %8llu %8llu %8llu %8llu %8llu %10llu\n",
+               op_names[i],
+               (unsigned long long) hist->count,
+               (unsigned long long) report->failures[i],
+               (unsigned long long) (hist->total_ns / hist->count),
+               (unsigned long long) latencyPercentile(hist, 50.0),
+               (unsigned long long) latencyPercentile(hist, 90.0),
+               (unsigned long long) latencyPercentile(hist, 99.0),
+               (unsigned long long) latencyPercentile(hist, 99.9),
+               (unsigned long long) hist->max_ns);
+    }
+    
+    MemSize internal_frag, external_frag;
+    calculateFragmentation(sim, &internal_frag, &external_frag);
+    
+    const char* unit_name = memoryUnitName(sim->unit);
+    printf("\nEstado final: %llu %s total, ", (unsigned long long) sim->total_memory, unit_name);
+    if (sim->usable_memory < sim->total_memory) {
+        printf("%llu %s asignables, ", (unsigned long long) sim->usable_memory, unit_name);
+    }
+    printf("%llu %s disponible (política: %s)\n", (unsigned long long) sim->available_memory, unit_name,
+           placementPolicyName(sim->placement));
+    printf("- Fragmentación interna: %llu %s\n", (unsigned long long) internal_frag, unit_name);
+    printf("- Fragmentación externa: %llu %s\n", (unsigned long long) external_frag, unit_name);
+    
+    MemoryStats stats;
+    getMemoryStats(sim, &stats);
+    printf("- Bloques libres: %llu (mayor: %llu %s, índice de fragmentación: %.3f)\n",
+           (unsigned long long) stats.free_blocks, (unsigned long long) stats.largest_free_block,
+           unit_name, stats.external_ratio);
+    
+    if (report->samples > 0) {
+        printf("- Durante la traza: índice de fragmentación medio %.3f (máx %.3f), "
+               "bloques libres medio %.1f (máx %llu)\n",
+               report->sum_external_ratio / (double) report->samples, report->max_external_ratio,
+               (double) report->sum_free_blocks / (double) report->samples,
+               (unsigned long long) report->max_free_blocks);
+    }
+    printf("Compactación: %llu %s movidos en %llu bloques (%llu compactaciones parciales)\n",
+           (unsigned long long) sim->compaction_moved, unit_name,
+           (unsigned long long) sim->compaction_blocks_moved,
+           (unsigned long long) report->fit_compactions);
+    printf("Nodos de bloque: %zu en uso, %zu reservados en el pool\n",
+           sim->pool.live_nodes, sim->pool.total_nodes);
+}
+
+// Nombre corto de una política de reemplazo
+const char* replacementPolicyName(ReplacementPolicy policy) {
+    switch (policy) {
+        case REPLACE_FIFO:  return "fifo";
+        case REPLACE_LRU:   return "lru";
+        case REPLACE_CLOCK: return "clock";
+        case REPLACE_AGING: return "aging";
+        case REPLACE_POLICY_COUNT: break;
+    }
+    return "?";
+}
+
+// Interpreta una lista de políticas separadas por comas ("all" = todas)
+bool parseReplacementPolicies(const char* text, bool* policies) {
+    char buffer[64];
+    bool any = false;
+    
+    if (strlen(text) >= sizeof(buffer)) {
+        return false;
+    }
+    strcpy(buffer, text);
+    memset(policies, 0, REPLACE_POLICY_COUNT * sizeof(bool));
+    
+    for (char* name = strtok(buffer, ","); name != NULL; name = strtok(NULL, ",")) {
+        bool known = false;
+        
+        for (int i = 0; i < REPLACE_POLICY_COUNT; i++) {
+            if (strcmp(name, "all") == 0 || strcmp(name, replacementPolicyName((ReplacementPolicy) i)) == 0) {
+                policies[i] = true;
+                known = true;
+            }
+        }
+        if (!known) {
+            return false;
+        }
+        any = true;
+    }
+    return any;
+}
+
+// Entrada de la página vpn en la tabla, o NULL si nunca se tocó. Con insert se crea la
+// entrada (sin marco) y *created indica si es nueva; NULL solo si falla la memoria
+static PageTableEntry* pageTableFind(PageTable* table, uint64_t vpn, bool insert, bool* created) {
+    if (insert && (table->count + 1) * 2 > table->capacity) {
+        // Mantener la ocupación por debajo de 1/2 para que los sondeos sean cortos
+        size_t capacity = table->capacity > 0 ? table->capacity * 2 : PAGE_TABLE_INITIAL_CAPACITY;
+        PageTableEntry* entries = (PageTableEntry*) calloc(capacity, sizeof(PageTableEntry));
+        if (entries == NULL) {
+            return NULL;
+        }
+        
+        int shift = 64 - __builtin_ctzll(capacity);
+        for (size_t i = 0; i < table->capacity; i++) {
+            if (table->entries[i].key != 0) {
+                size_t slot = (size_t) ((table->entries[i].key * 0x9E3779B97F4A7C15ULL) >> shift);
+                while (entries[slot].key != 0) {
+                    slot = (slot + 1) & (capacity - 1);
+                }
+                entries[slot] = table->entries[i];
+            }
+        }
+        
+        free(table->entries);
+        table->entries = entries;
+        table->capacity = capacity;
+        table->shift = shift;
+    }
+    
+    if (table->capacity == 0) {
+        return NULL;
+    }
+    
+    uint64_t key = vpn + 1;
+    size_t slot = (size_t) ((key * 0x9E3779B97F4A7C15ULL) >> table->shift);
+    
+    while (table->entries[slot].key != 0) {
+        if (table->entries[slot].key == key) {
+            if (created != NULL) *created = false;
+            return &table->entries[slot];
+        }
+        slot = (slot + 1) & (table->capacity - 1);
+    }
+    
+    if (!insert) {
+        return NULL;
+    }
+    
+    table->entries[slot].key = key;
+    table->entries[slot].frame = -1;
+    table->count++;
+    if (created != NULL) *created = true;
+    return &table->entries[slot];
+}
+
+// Prepara la memoria física, la TLB y el estado de la política de reemplazo
+bool pagerInit(Pager* pager, ReplacementPolicy policy, const PagingConfig* config) {
+    memset(pager, 0, sizeof(Pager));
+    pager->policy = policy;
+    pager->frame_count = config->frame_count;
+    pager->list_head = -1;
+    pager->list_tail = -1;
+    pager->aging_interval = config->aging_interval;
+    pager->aging_countdown = config->aging_interval;
+    
+    // La TLB se redondea hacia abajo a una potencia de dos de conjuntos de TLB_WAYS vías
+    if (config->tlb_entries >= TLB_WAYS) {
+        uint32_t sets = config->tlb_entries / TLB_WAYS;
+        pager->tlb_sets = 1U << (31 - __builtin_clz(sets));
+    }
+    
+    pager->frames = (PageFrame*) malloc((size_t) pager->frame_count * sizeof(PageFrame));
+    pager->tlb = (TlbEntry*) malloc((size_t) (pager->tlb_sets > 0 ? pager->tlb_sets : 1) * TLB_WAYS * sizeof(TlbEntry));
+    if (pager->frames == NULL || pager->tlb == NULL) {
+        pagerFree(pager);
+        return false;
+    }
+    
+    for (uint32_t i = 0; i < pager->tlb_sets * TLB_WAYS; i++) {
+        pager->tlb[i].frame = -1;
+    }
+    return true;
+}
+
+// Conjunto de la TLB donde puede estar la página: el proceso se mezcla con el número de
+// página para que procesos distintos no compitan siempre por los mismos conjuntos
+static inline TlbEntry* tlbSet(Pager* pager, uint32_t pid, uint64_t vpn) {
+    uint64_t mixed = vpn ^ ((uint64_t) pid * 0x9E3779B97F4A7C15ULL >> 32);
+    return &pager->tlb[(mixed & (pager->tlb_sets - 1)) * TLB_WAYS];
+}
+
+// Anota la traducción en la TLB reemplazando la entrada inválida o la menos usada del conjunto
+static void tlbInsert(Pager* pager, uint32_t pid, uint64_t vpn, int32_t frame) {
+    TlbEntry* set = tlbSet(pager, pid, vpn);
+    TlbEntry* victim = &set[0];
+    
+    for (int way = 0; way < TLB_WAYS; way++) {
+        if (set[way].frame < 0) {
+            victim = &set[way];
+            break;
+        }
+        if (set[way].last_use < victim->last_use) {
+            victim = &set[way];
+        }
+    }
+    
+    victim->pid = pid;
+    victim->vpn = vpn;
+    victim->frame = frame;
+    victim->last_use = ++pager->tlb_clock;
+}
+
+// Invalida la traducción de una página desalojada
+static void tlbInvalidate(Pager* pager, uint32_t pid, uint64_t vpn) {
+    TlbEntry* set = tlbSet(pager, pid, vpn);
+    
+    for (int way = 0; way < TLB_WAYS; way++) {
+        if (set[way].frame >= 0 && set[way].vpn == vpn && set[way].pid == pid) {
+            set[way].frame = -1;
+            return;
+        }
+    }
+}
+
+// Quita un marco de la lista de carga o de uso
+static inline void frameListUnlink(Pager* pager, int32_t index) {
+    PageFrame* frame = &pager->frames[index];
+    
+    if (frame->prev >= 0) pager->frames[frame->prev].next = frame->next;
+    else pager->list_head = frame->next;
+    if (frame->next >= 0) pager->frames[frame->next].prev = frame->prev;
+    else pager->list_tail = frame->prev;
+}
+
+// Pone un marco al frente de la lista (el más reciente)
+static inline void frameListPush(Pager* pager, int32_t index) {
+    PageFrame* frame = &pager->frames[index];
+    
+    frame->prev = -1;
+    frame->next = pager->list_head;
+    if (pager->list_head >= 0) pager->frames[pager->list_head].prev = index;
+    else pager->list_tail = index;
+    pager->list_head = index;
+}
+
+// Elige el marco a desalojar según la política (todos los marcos están ocupados)
+static int32_t pagerVictim(Pager* pager) {
+    switch (pager->policy) {
+        case REPLACE_FIFO:
+        case REPLACE_LRU:
+            // El final de la lista: el cargado o el usado hace más tiempo
+            return pager->list_tail;
+        
+        case REPLACE_CLOCK:
+            // Las páginas referenciadas pierden el bit y reciben una segunda oportunidad
+            while (pager->frames[pager->clock_hand].referenced) {
+                pager->frames[pager->clock_hand].referenced = false;
+                pager->clock_hand = (pager->clock_hand + 1) % pager->frame_count;
+            }
+            {
+                int32_t victim = (int32_t) pager->clock_hand;
+                pager->clock_hand = (pager->clock_hand + 1) % pager->frame_count;
+                return victim;
+            }
+        
+        case REPLACE_AGING: {
+            // Menor contador, contando el bit de referencia pendiente como el más reciente.
+            // La búsqueda retoma donde quedó la anterior y termina en la primera página sin
+            // referencias recientes, así que solo recorre todos los marcos si no hay ninguna
+            int32_t victim = (int32_t) pager->clock_hand;
+            uint32_t lowest = UINT32_MAX;
+            uint32_t index = pager->clock_hand;
+            
+            for (uint32_t scanned = 0; scanned < pager->frame_count; scanned++) {
+                const PageFrame* frame = &pager->frames[index];
+                uint32_t age = (frame->age >> 1) | ((uint32_t) frame->referenced << 31);
+                if (age < lowest) {
+                    lowest = age;
+                    victim = (int32_t) index;
+                    if (age == 0) break;
+                }
+                index = (index + 1 == pager->frame_count) ? 0 : index + 1;
+            }
+            
+            pager->clock_hand = ((uint32_t) victim + 1) % pager->frame_count;
+            return victim;
+        }
+        
+        case REPLACE_POLICY_COUNT:
+            break;
+    }
+    return 0;
+}
+
+// Desplaza los contadores de aging e incorpora los bits de referencia
+static void pagerAgingTick(Pager* pager) {
+    for (uint32_t i = 0; i < pager->frames_used; i++) {
+        PageFrame* frame = &pager->frames[i];
+        frame->age = (frame->age >> 1) | ((uint32_t) frame->referenced << 31);
+        frame->referenced = false;
+    }
+}
+
+// Tabla de páginas del proceso pid (se crea al ver el proceso por primera vez)
+static PageTable* pagerTable(Pager* pager, uint32_t pid) {
+    if (pid >= pager->table_count) {
+        size_t count = pager->table_count > 0 ? pager->table_count : 16;
+        while (count <= pid) {
+            count *= 2;
+        }
+        
+        PageTable* tables = (PageTable*) realloc(pager->tables, count * sizeof(PageTable));
+        if (tables == NULL) {
+            return NULL;
+        }
+        memset(tables + pager->table_count, 0, (count - pager->table_count) * sizeof(PageTable));
+        pager->tables = tables;
+        pager->table_count = count;
+    }
+    return &pager->tables[pid];
+}
+
+// Resuelve una referencia: TLB, tabla de páginas y, si la página no está cargada, un
+// fallo que ocupa un marco libre o desaloja a la víctima de la política. Todo es O(1)
+// salvo las búsquedas de víctima de CLOCK y aging, que recorren marcos hasta encontrarla.
+// Devuelve false si falta memoria
+bool pagerAccess(Pager* pager, uint32_t pid, uint64_t vpn, bool write) {
+    PagingStats* stats = &pager->stats;
+    int32_t index = -1;
+    
+    stats->references++;
+    stats->writes += write;
+    
+    if (pager->tlb_sets > 0) {
+        TlbEntry* set = tlbSet(pager, pid, vpn);
+        for (int way = 0; way < TLB_WAYS; way++) {
+            if (set[way].frame >= 0 && set[way].vpn == vpn && set[way].pid == pid) {
+                set[way].last_use = ++pager->tlb_clock;
+                index = set[way].frame;
+                stats->tlb_hits++;
+                break;
+            }
+        }
+    }
+    
+    if (index < 0) {
+        PageTable* table = pagerTable(pager, pid);
+        bool created = false;
+        PageTableEntry* entry = table != NULL ? pageTableFind(table, vpn, true, &created) : NULL;
+        
+        if (entry == NULL) {
+            return false;
+        }
+        
+        if (entry->frame < 0) {
+            stats->faults++;
+            stats->cold_faults += created;
+            
+            if (pager->frames_used < pager->frame_count) {
+                index = (int32_t) pager->frames_used++;
+            } else {
+                // Desalojar: la página víctima pierde su marco y su traducción en la TLB
+                index = pagerVictim(pager);
+                PageFrame* victim = &pager->frames[index];
+                PageTableEntry* owner = pageTableFind(&pager->tables[victim->pid], victim->vpn, false, NULL);
+                
+                owner->frame = -1;
+                if (pager->tlb_sets > 0) {
+                    tlbInvalidate(pager, victim->pid, victim->vpn);
+                }
+                stats->evictions++;
+                stats->writebacks += victim->dirty;
+                
+                if (pager->policy == REPLACE_FIFO || pager->policy == REPLACE_LRU) {
+                    frameListUnlink(pager, index);
+                }
+            }
+            
+            PageFrame* frame = &pager->frames[index];
+            frame->pid = pid;
+            frame->vpn = vpn;
+            frame->age = 0;
+            frame->referenced = false;
+            frame->dirty = false;
+            entry->frame = index;
+            
+            if (pager->policy == REPLACE_FIFO || pager->policy == REPLACE_LRU) {
+                frameListPush(pager, index);
+            }
+        } else {
+            index = entry->frame;
+        }
+        
+        if (pager->tlb_sets > 0) {
+            tlbInsert(pager, pid, vpn, index);
+        }
+    }
+    
+    // Actualizar lo que la política observa de cada referencia
+    PageFrame* frame = &pager->frames[index];
+    frame->dirty |= write;
+    
+    if (pager->policy == REPLACE_LRU) {
+        if (pager->list_head != index) {
+            frameListUnlink(pager, index);
+            frameListPush(pager, index);
+        }
+    } else if (pager->policy != REPLACE_FIFO) {
+        frame->referenced = true;
+        
+        if (pager->policy == REPLACE_AGING && --pager->aging_countdown == 0) {
+            pagerAgingTick(pager);
+            pager->aging_countdown = pager->aging_interval;
+        }
+    }
+    
+    return true;
+}
+
+// Libera los marcos, la TLB y las tablas de páginas
+void pagerFree(Pager* pager) {
+    for (size_t i = 0; i < pager->table_count; i++) {
+        free(pager->tables[i].entries);
+    }
+    free(pager->tables);
+    free(pager->frames);
+    free(pager->tlb);
+    memset(pager, 0, sizeof(Pager));
+}
+
+// Identificadores de los procesos de una traza de referencias (hash abierto por nombre)
+typedef struct {
+    char (*names)[MAX_PROCESS_NAME];
+    int32_t* slots;             // Índice en names, o -1 si está vacío
+    size_t capacity;            // Potencia de dos, el doble de PAGING_MAX_PROCESSES
+    uint32_t count;
+} PagingProcesses;
+
+// Identificador del proceso con ese nombre; lo crea si es nuevo. -1 si hay demasiados
+static int64_t pagingProcessId(PagingProcesses* processes, const char* name, size_t length) {
+    uint64_t hash = 1469598103934665603ULL;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ (unsigned char) name[i]) * 1099511628211ULL;
+    }
+    
+    size_t slot = (size_t) hash & (processes->capacity - 1);
+    while (processes->slots[slot] >= 0) {
+        const char* known = processes->names[processes->slots[slot]];
+        if (strncmp(known, name, length) == 0 && known[length] == '\0') {
+            return processes->slots[slot];
+        }
+        slot = (slot + 1) & (processes->capacity - 1);
+    }
+    
+    if (processes->count == PAGING_MAX_PROCESSES) {
+        return -1;
+    }
+    
+    memcpy(processes->names[processes->count], name, length);
+    processes->names[processes->count][length] = '\0';
+    processes->slots[slot] = (int32_t) processes->count;
+    return processes->count++;
+}
+
+// Interpreta la línea "<proceso> <dirección> [r|w]" que empieza en p, en una sola pasada y
+// sin funciones de <ctype.h>. Deja en *next el comienzo de la línea siguiente. Devuelve 1
+// si es una referencia, 0 si está vacía o es un comentario y -1 si no se puede interpretar
+static int parseReferenceLine(const char* p, const char* end, const char** next, const char** name,
+                              size_t* name_length, uint64_t* address, bool* write) {
+    int result = -1;
+    
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    if (p == end || *p == '\n' || *p == '\r' || *p == '#') {
+        result = 0;
+        goto skip;
+    }
+    
+    *name = p;
+    while (p < end && *p != ' ' && *p != '\t' && *p != '\n' && *p != '\r' && *p != '#') p++;
+    *name_length = (size_t) (p - *name);
+    if (*name_length >= MAX_PROCESS_NAME) {
+        goto skip;
+    }
+    
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    
+    // Dirección decimal o hexadecimal con prefijo 0x, sin desborde
+    uint64_t value = 0;
+    const char* digits;
+    if (end - p > 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) {
+        p += 2;
+        digits = p;
+        for (; p < end; p++) {
+            unsigned digit = (unsigned) (*p - '0');
+            if (digit > 9) {
+                digit = (unsigned) ((*p | 0x20) - 'a');
+                if (digit > 5) break;
+                digit += 10;
+            }
+            if (value >> 60) goto skip;
+            value = (value << 4) | digit;
+        }
+    } else {
+        digits = p;
+        for (; p < end && (unsigned) (*p - '0') <= 9; p++) {
+            uint64_t digit = (uint64_t) (*p - '0');
+            if (value > (UINT64_MAX - digit) / 10) goto skip;
+            value = value * 10 + digit;
+        }
+    }
+    if (p == digits) {
+        goto skip;
+    }
+    
+    *write = false;
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    if (p < end && (*p == 'r' || *p == 'R' || *p == 'w' || *p == 'W')) {
+        *write = (*p == 'w' || *p == 'W');
+        p++;
+        while (p < end && (*p == ' ' || *p == '\t')) p++;
+    }
+    
+    if (p < end && *p == '\r') p++;
+    if (p == end || *p == '\n') {
+        *address = value;
+        *next = p + 1;
+        return 1;
+    }
+    if (*p == '#') {
+        *address = value;
+        result = 1;
+    }
+    
+skip:
+    // Resto de la línea (comentario o texto inválido)
+    p = memchr(p, '\n', (size_t) (end - p));
+    *next = (p != NULL) ? p + 1 : end;
+    return result;
+}
+
+// Reproduce una traza de referencias sobre todas las políticas de reemplazo elegidas a
+// la vez: el archivo se mapea en memoria y cada línea se interpreta una sola vez
+bool runPagingTrace(const char* path, const PagingConfig* config) {
+    int fd = open(path, O_RDONLY);
+    struct stat info;
+    
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        printf("Error: No se pudo abrir la traza de referencias '%s'.\n", path);
+        if (fd >= 0) close(fd);
+        return false;
+    }
+    
+    size_t length = (size_t) info.st_size;
+    const char* data = NULL;
+    if (length > 0) {
+        void* mapped = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            printf("Error: No se pudo mapear la traza de referencias '%s'.\n", path);
+            close(fd);
+            return false;
+        }
+        madvise(mapped, length, MADV_SEQUENTIAL);
+        data = (const char*) mapped;
+    }
+    close(fd);
+    
+    Pager pagers[REPLACE_POLICY_COUNT];
+    int pager_count = 0;
+    PagingProcesses processes = { NULL, NULL, 2 * PAGING_MAX_PROCESSES, 0 };
+    bool ok = true;
+    
+    processes.names = malloc(PAGING_MAX_PROCESSES * sizeof(*processes.names));
+    processes.slots = (int32_t*) malloc(processes.capacity * sizeof(int32_t));
+    ok = processes.names != NULL && processes.slots != NULL;
+    if (ok) {
+        memset(processes.slots, 0xff, processes.capacity * sizeof(int32_t));
+    }
+    
+    for (int i = 0; ok && i < REPLACE_POLICY_COUNT; i++) {
+        if (config->policies[i]) {
+            ok = pagerInit(&pagers[pager_count], (ReplacementPolicy) i, config);
+            pager_count += ok;
+        }
+    }
+    if (!ok) {
+        printf("Error: No se pudo asignar memoria para la simulación paginada.\n");
+    }
+    
+    int page_shift = __builtin_ctzll(config->page_size);
+    uint64_t line_number = 0;
+    uint64_t invalid_lines = 0;
+    const char* last_name = NULL;   // Las referencias seguidas suelen ser del mismo proceso
+    size_t last_length = 0;
+    uint32_t last_pid = 0;
+    uint64_t start_ns = monotonicNanos();
+    
+    for (const char* p = data; ok && p != NULL && p < data + length; ) {
+        const char* name;
+        size_t name_length;
+        uint64_t address;
+        bool write;
+        int parsed = parseReferenceLine(p, data + length, &p, &name, &name_length, &address, &write);
+        line_number++;
+        
+        if (parsed < 0) {
+            if (invalid_lines++ < 10) {
+                printf("Advertencia: línea %llu: referencia inválida.\n", (unsigned long long) line_number);
+            }
+            continue;
+        }
+        if (parsed == 0) {
+            continue;
+        }
+        
+        if (last_name == NULL || name_length != last_length || memcmp(name, last_name, name_length) != 0) {
+            int64_t pid = pagingProcessId(&processes, name, name_length);
+            if (pid < 0) {
+                printf("Error: línea %llu: más de %d procesos distintos.\n",
+                       (unsigned long long) line_number, PAGING_MAX_PROCESSES);
+                ok = false;
+                break;
+            }
+            last_name = name;
+            last_length = name_length;
+            last_pid = (uint32_t) pid;
+        }
+        
+        uint64_t vpn = address >> page_shift;
+        for (int i = 0; i < pager_count; i++) {
+            if (!pagerAccess(&pagers[i], last_pid, vpn, write)) {
+                printf("Error: No se pudo asignar memoria para las tablas de páginas.\n");
+                ok = false;
+                break;
+            }
+        }
+    }
+    
+    uint64_t elapsed_ns = monotonicNanos() - start_ns;
+    
+    if (ok) {
+        uint64_t references = pager_count > 0 ? pagers[0].stats.references : 0;
+        uint64_t pages = 0;
+        for (size_t i = 0; pager_count > 0 && i < pagers[0].table_count; i++) {
+            pages += pagers[0].tables[i].count;
+        }
+        
+        printf("\n=== Memoria paginada: %llu referencias de %u procesos (%llu páginas distintas) ===\n",
+               (unsigned long long) references, processes.count, (unsigned long long) pages);
+        printf("Marcos: %u de %llu bytes; TLB: %u entradas (%d vías)\n", config->frame_count,
+               (unsigned long long) config->page_size, pagers[0].tlb_sets * TLB_WAYS, TLB_WAYS);
+        if (invalid_lines > 0) {
+            printf("Líneas inválidas: %llu\n", (unsigned long long) invalid_lines);
+        }
+        printf("Tiempo: %.3f s (%.0f referencias/s; políticas simuladas: %d)\n\n", (double) elapsed_ns / 1e9,
+               elapsed_ns > 0 ? (double) references / ((double) elapsed_ns / 1e9) : 0.0, pager_count);
+        
+        printf("%-8s %12s %9s %12s %12s %12s %9s\n",
+               "Política", "Fallos", "Tasa", "En frío", "Reemplazos", "Escrituras", "TLB");
+        printf("--------------------------------------------------------------------------------\n");
+        for (int i = 0; i < pager_count; i++) {
+            const PagingStats* stats = &pagers[i].stats;
+            double total = stats->references > 0 ? (double) stats->references : 1.0;
+            
+            printf("%-8s %12llu %8.3f%% %12llu %12llu %12llu %8.2f%%\n",
+                   replacementPolicyName(pagers[i].policy),
+                   (unsigned long long) stats->faults, 100.0 * (double) stats->faults / total,
+                   (unsigned long long) stats->cold_faults, (unsigned long long) stats->evictions,
+                   (unsigned long long) stats->writebacks, 100.0 * (double) stats->tlb_hits / total);
+        }
+        printf("(Escrituras: desalojos de páginas modificadas; TLB: referencias resueltas por la TLB)\n");
+    }
+    
+    for (int i = 0; i < pager_count; i++) {
+        pagerFree(&pagers[i]);
+    }
+    free(processes.names);
+    free(processes.slots);
+    if (data != NULL) {
+        munmap((void*) data, length);
+    }
+    return ok;
+}
@@ -0,0 +1,3598 @@
+/**
+ * Motor del simulador de administración de memoria (ver memsim.h)
+ *
+ * - Particiones fijas, dinámicas, por sistema buddy o con un mapa de bits
+ * - Políticas de ubicación sobre un treap, listas segregadas (TLSF) o una tabla contigua
+ *   con escaneo vectorizado
+ * - Fragmentación interna y externa en O(1) con contadores incrementales
+ * - Compactación completa, incremental o hasta que quepa un proceso
+ * - Arenas protegidas por locks para el modo concurrente
+ * - Cola de admisión FIFO, de menor tamaño o por prioridad, indexada por clase de tamaño
+ * - Snapshots binarios versionados del estado, restaurados con mmap
+ */
+
+
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <ctype.h>
+ #include <errno.h>
+ #include <limits.h>
+ #include <time.h>
+ #include <unistd.h>
+ #include <fcntl.h>
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+ #include "memsim.h"
+
+#ifdef FREE_TABLE_SIMD
+ #include <immintrin.h>
+#endif
+
+#define NAME_INDEX_INITIAL_CAPACITY 64 // Cubetas iniciales del índice por nombre (potencia de dos)
+#define BLOCK_POOL_FIRST_CHUNK 64     // Nodos del primer trozo del pool de bloques
+#define BLOCK_POOL_MAX_CHUNK 65536    // Tope de nodos por trozo (cada trozo duplica al anterior)
+#define FREE_TABLE_INITIAL_CAPACITY 64 // Filas iniciales de la tabla contigua de bloques libres
+#define SNAPSHOT_MAGIC "MEMSNAP"      // Firma de los archivos de snapshot (8 bytes con el '\0')
+#define SNAPSHOT_VERSION 2            // Versión del formato; cambia si cambia el diseño
+#define SNAPSHOT_BYTE_ORDER 0x01020304U // Se escribe en orden nativo para detectar el orden de bytes
+#define SNAPSHOT_WRITE_BATCH 4096     // Registros por escritura al guardar
+#define BUDDY_MAX_LEAVES (1ULL << 26) // Tope de bloques del orden mínimo (acota el mapa de bits a 16 MB)
+#define BITMAP_MAX_BITS (1ULL << 28)  // Tope de bits del modo mapa de bits (32 MB de mapa)
+#define REQUEST_HEAP_INITIAL_CAPACITY 16 // Entradas iniciales del heap de cada clase de la cola de admisión
+
+// Encabezado de un snapshot: configuración y contadores del simulador. Le siguen
+// block_count registros SnapshotBlock ordenados por dirección y free_list_count
+// direcciones con el orden de las listas libres (modos buddy y segregated)
+typedef struct {
+    char magic[8];              // SNAPSHOT_MAGIC
+    uint32_t version;           // SNAPSHOT_VERSION
+    uint32_t byte_order;        // SNAPSHOT_BYTE_ORDER
+    uint64_t header_size;       // sizeof(SnapshotHeader)
+    uint64_t block_count;       // Registros de bloque que siguen
+    uint64_t free_list_count;   // Direcciones del orden de las listas libres (tras los bloques)
+    uint64_t checksum;          // Suma de verificación de todo lo que sigue al encabezado
+    uint64_t trace_line;        // Última línea de traza aplicada (0 si no viene de una traza)
+    MemSize total_memory;
+    MemSize available_memory;
+    MemSize fixed_partition_size;
+    MemSize next_fit_cursor;
+    MemSize compaction_moved;
+    MemSize bitmap_chunk;
+    MemSize internal_waste;
+    uint64_t compaction_blocks_moved;
+    uint64_t next_block_id;
+    uint64_t tree_seed;
+    uint32_t unit;
+    uint32_t partition_type;
+    uint32_t placement;
+    int32_t num_fixed_partitions;
+} SnapshotHeader;
+
+// Registro de un bloque en el snapshot (sin punteros; 56 bytes sin relleno)
+typedef struct {
+    uint64_t id;
+    MemSize start_address;
+    MemSize size;
+    MemSize requested_size;
+    uint32_t status;
+    char process_name[MAX_PROCESS_NAME];
+} SnapshotBlock;
+
+// Inicializa el simulador con un tamaño de memoria dado. Devuelve NULL si falta memoria
+MemorySimulator* initSimulator(MemSize memory_size, MemoryUnit unit) {
+    MemorySimulator* sim = (MemorySimulator*) malloc(sizeof(MemorySimulator));
+    
+    if (sim == NULL) {
+        return NULL;
+    }
+
+    // Inicializar el primer bloque como libre, con el tamaño total de memoria
+    memset(&sim->pool, 0, sizeof(BlockPool));
+#ifdef INSTRUMENTATION
+    memset(&sim->instr, 0, sizeof(InstrStats));
+#endif
+    MemoryBlock* initial_block = blockAlloc(sim);
+    
+    if (initial_block == NULL) {
+        free(sim);
+        return NULL;
+    }
+
+    initial_block->id = 0;
+    initial_block->start_address = 0;
+    initial_block->size = memory_size;
+    initial_block->status = FREE;
+    strcpy(initial_block->process_name, "");
+    initial_block->next = NULL;
+    initial_block->prev = NULL;
+    
+    sim->memory_map = initial_block;
+    sim->total_memory = memory_size;
+    sim->available_memory = memory_size;
+    sim->usable_memory = memory_size;
+    sim->unit = unit;
+    sim->partition_type = DYNAMIC_PARTITIONS;  // Por defecto
+    sim->num_fixed_partitions = 0;
+    sim->fixed_partition_size = 0;
+    memset(&sim->partitions, 0, sizeof(PartitionIndex));
+    sim->placement = PLACEMENT_FIRST_FIT;
+    memset(&sim->bins, 0, sizeof(SegregatedBins));
+    sim->free_tree = NULL;
+    memset(&sim->free_table, 0, sizeof(FreeTable));
+    sim->tree_seed = 0x9E3779B97F4A7C15ULL;
+    sim->next_fit_cursor = 0;
+    sim->next_block_id = 1;
+    sim->buddy_bitmap = NULL;
+    memset(sim->buddy_free, 0, sizeof(sim->buddy_free));
+    sim->buddy_order_mask = 0;
+    sim->buddy_min_order = 0;
+    sim->bitmap = NULL;
+    sim->bitmap_summary = NULL;
+    sim->bitmap_bits = 0;
+    sim->bitmap_chunk = 0;
+    sim->compact_cursor = NULL;
+    sim->compaction_moved = 0;
+    sim->compaction_blocks_moved = 0;
+    sim->internal_waste = 0;
+    sim->freed_start = 0;
+    sim->freed_size = 0;
+    freeIndexRebuild(sim);
+    
+    if (!nameIndexInit(sim, NAME_INDEX_INITIAL_CAPACITY)) {
+        blockPoolDestroy(sim);
+        free(sim);
+        return NULL;
+    }
+
+    return sim;
+}
+
+// Deja el simulador sin bloques cuando no se pudo armar el modo pedido: toda asignación
+// falla con SIM_ERR_NO_SPACE hasta que otro setPartitionMode tenga éxito
+static SimStatus partitionModeFailed(MemorySimulator* sim, SimStatus status) {
+    sim->memory_map = NULL;
+    blockPoolReset(sim);
+    nameIndexClear(sim);
+    buddyRelease(sim);
+    bitmapRelease(sim);
+    partitionIndexRelease(sim);
+    
+    sim->partition_type = DYNAMIC_PARTITIONS;
+    sim->available_memory = 0;
+    sim->usable_memory = 0;
+    sim->next_block_id = 0;
+    freeIndexRebuild(sim);
+    return status;
+}
+
+// Descarta los bloques y las estructuras del modo anterior antes de armar el nuevo
+static void partitionModeReset(MemorySimulator* sim, PartitionType type) {
+    // Liberar todos los nodos de una vez y volver a inicializar con la nueva configuración
+    sim->memory_map = NULL;
+    blockPoolReset(sim);
+    nameIndexClear(sim);
+    buddyRelease(sim);
+    bitmapRelease(sim);
+    partitionIndexRelease(sim);
+    
+    sim->partition_type = type;
+    sim->available_memory = sim->total_memory;
+    sim->usable_memory = sim->total_memory;
+    sim->next_fit_cursor = 0;
+    sim->compact_cursor = NULL;
+    sim->internal_waste = 0;
+    sim->freed_size = 0;
+}
+
+// Crea las particiones fijas contiguas desde la dirección 0: las de sizes en ese orden o,
+// si sizes es NULL, count particiones de equal_size. El resto de la memoria queda fuera
+// de toda partición y no cuenta como disponible
+static SimStatus fixedPartitionsCreate(MemorySimulator* sim, const MemSize* sizes, size_t count, MemSize equal_size) {
+    partitionModeReset(sim, FIXED_PARTITIONS);
+    sim->num_fixed_partitions = (int) count;
+    sim->fixed_partition_size = 0;
+    
+    MemoryBlock* prev_block = NULL;
+    MemSize address = 0;
+    
+    for (size_t i = 0; i < count; i++) {
+        MemoryBlock* block = blockAlloc(sim);
+        
+        if (block == NULL) {
+            return partitionModeFailed(sim, SIM_ERR_NO_MEMORY);
+        }
+        
+        block->id = i;
+        block->start_address = address;
+        block->size = (sizes != NULL) ? sizes[i] : equal_size;
+        block->status = FREE;
+        strcpy(block->process_name, "");
+        block->next = NULL;
+        block->prev = prev_block;
+        
+        if (prev_block == NULL) {
+            sim->memory_map = block;
+        } else {
+            prev_block->next = block;
+        }
+        
+        if (block->size > sim->fixed_partition_size) {
+            sim->fixed_partition_size = block->size;
+        }
+        address += block->size;
+        prev_block = block;
+    }
+    
+    sim->available_memory = address;
+    sim->usable_memory = address;
+    sim->next_block_id = count;
+    
+    if (!freeIndexRebuild(sim)) {
+        return partitionModeFailed(sim, SIM_ERR_NO_MEMORY);
+    }
+    return SIM_OK;
+}
+
+// Establece el modo de partición. num_partitions es la cantidad de particiones fijas (todas
+// del mismo tamaño) o, en modo mapa de bits, las unidades de memoria que representa cada
+// bit (0 = automático)
+SimStatus setPartitionMode(MemorySimulator* sim, PartitionType type, int num_partitions) {
+    if (type == FIXED_PARTITIONS) {
+        if (num_partitions <= 0 || (MemSize) num_partitions > sim->total_memory) {
+            return SIM_ERR_INVALID_ARGUMENT;
+        }
+        return fixedPartitionsCreate(sim, NULL, (size_t) num_partitions, sim->total_memory / num_partitions);
+    }
+    
+    partitionModeReset(sim, type);
+    
+    if (type == BUDDY_PARTITIONS) {
+        if (!buddySetup(sim)) {
+            return partitionModeFailed(sim, SIM_ERR_NO_MEMORY);
+        }
+    } else if (type == BITMAP_PARTITIONS) {
+        if (!bitmapSetup(sim, (MemSize) num_partitions)) {
+            return partitionModeFailed(sim, SIM_ERR_NO_MEMORY);
+        }
+    } else {
+        // Crear un único bloque libre con todo el espacio
+        MemoryBlock* block = blockAlloc(sim);
+        
+        if (block == NULL) {
+            return partitionModeFailed(sim, SIM_ERR_NO_MEMORY);
+        }
+        
+        block->id = 0;
+        block->start_address = 0;
+        block->size = sim->total_memory;
+        block->status = FREE;
+        strcpy(block->process_name, "");
+        block->next = NULL;
+        block->prev = NULL;
+        
+        sim->memory_map = block;
+        sim->next_block_id = 1;
+    }
+    
+    if (!freeIndexRebuild(sim)) {
+        return partitionModeFailed(sim, SIM_ERR_NO_MEMORY);
+    }
+    return SIM_OK;
+}
+
+// Establece particiones fijas de tamaños arbitrarios, contiguas desde la dirección 0 en el
+// orden dado. Si no cubren toda la memoria el resto queda sin particionar
+SimStatus setFixedPartitions(MemorySimulator* sim, const MemSize* sizes, size_t count) {
+    if (count == 0 || count > INT_MAX) {
+        return SIM_ERR_INVALID_ARGUMENT;
+    }
+    
+    MemSize covered = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (sizes[i] == 0 || sizes[i] > sim->total_memory - covered) {
+            return SIM_ERR_INVALID_ARGUMENT;
+        }
+        covered += sizes[i];
+    }
+    
+    return fixedPartitionsCreate(sim, sizes, count, 0);
+}
+
+// Texto que explica un código de estado (sin punto final, para componerlo en mensajes)
+const char* simStatusMessage(SimStatus status) {
+    switch (status) {
+        case SIM_OK:                   return "Operación exitosa";
+        case SIM_ERR_INVALID_SIZE:     return "El tamaño del proceso debe ser mayor que cero";
+        case SIM_ERR_NO_SPACE:         return "No hay suficiente memoria disponible para el proceso";
+        case SIM_ERR_FRAGMENTATION:    return "No se encontró un bloque libre lo suficientemente grande";
+        case SIM_ERR_DUPLICATE:        return "Ya existe un proceso con ese nombre";
+        case SIM_ERR_NOT_FOUND:        return "No existe un proceso con ese nombre";
+        case SIM_ERR_NO_MEMORY:        return "No se pudo asignar memoria para los metadatos del simulador";
+        case SIM_ERR_INVALID_ARGUMENT: return "Parámetro de configuración inválido";
+        case SIM_ERR_UNSUPPORTED:      return "La operación no es aplicable al modo de partición actual";
+        case SIM_ERR_IO:               return "No se pudo leer o escribir el archivo";
+        case SIM_ERR_BAD_SNAPSHOT:     return "El archivo no es un snapshot compatible o está dañado";
+        default:                       return "Error desconocido";
+    }
+}
+
+#ifdef INSTRUMENTATION
+// Elementos examinados por la búsqueda en curso. Es por hilo porque las funciones de
+// búsqueda no reciben el simulador; cada hilo usa un solo simulador a la vez
+static _Thread_local uint64_t instr_visited;
+static _Thread_local bool instr_searching;  // La asignación en curso llegó a buscar un bloque
+
+// Marca de tiempo barata: contador de ciclos en x86, reloj monótono en otras arquitecturas
+static inline uint64_t instrNow(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return monotonicNanos();
+#endif
+}
+
+// Cierra la búsqueda en curso (si la hubo) y acumula lo que examinó
+static inline void instrSearchDone(MemorySimulator* sim) {
+    if (!instr_searching) {
+        return;
+    }
+    instr_searching = false;
+    sim->instr.searches++;
+    sim->instr.blocks_visited += instr_visited;
+    if (instr_visited > sim->instr.max_visited) {
+        sim->instr.max_visited = instr_visited;
+    }
+}
+
+// Unidades de instrNow() por nanosegundo, medidas una vez contra el reloj monótono
+double instrTicksPerNs(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    static double ticks_per_ns = 0.0;
+    
+    if (ticks_per_ns == 0.0) {
+        uint64_t start_ns = monotonicNanos();
+        uint64_t start_ticks = instrNow();
+        uint64_t elapsed_ns;
+        
+        do {
+            elapsed_ns = monotonicNanos() - start_ns;
+        } while (elapsed_ns < 10000000ULL);
+        
+        ticks_per_ns = (double) (instrNow() - start_ticks) / (double) elapsed_ns;
+    }
+    return ticks_per_ns;
+#else
+    return 1.0;
+#endif
+}
+
+ #define INSTR_START(var) uint64_t var = instrNow()
+ #define INSTR_STOP(sim, op, var) latencyRecord(&(sim)->instr.latency[(op)], instrNow() - (var))
+ #define INSTR_FAIL(sim, reason) ((sim)->instr.failures[(reason)]++)
+ #define INSTR_COUNT(sim, field, n) ((sim)->instr.field += (uint64_t) (n))
+ #define INSTR_SEARCH_BEGIN() (instr_visited = 0, instr_searching = true)
+ #define INSTR_SEARCH_END(sim) instrSearchDone(sim)
+ #define INSTR_VISIT(n) (instr_visited += (uint64_t) (n))
+#else
+ #define INSTR_START(var) ((void) 0)
+ #define INSTR_STOP(sim, op, var) ((void) 0)
+ #define INSTR_FAIL(sim, reason) ((void) 0)
+ #define INSTR_COUNT(sim, field, n) ((void) 0)
+ #define INSTR_SEARCH_BEGIN() ((void) 0)
+ #define INSTR_SEARCH_END(sim) ((void) 0)
+ #define INSTR_VISIT(n) ((void) 0)
+#endif
+
+// Ubica un proceso según el modo de partición; cada rechazo anota su motivo
+static SimStatus placeProcess(MemorySimulator* sim, char* process_name, MemSize process_size) {
+    if (process_size == 0) {
+        INSTR_FAIL(sim, SIM_ERR_INVALID_SIZE);
+        return SIM_ERR_INVALID_SIZE;
+    }
+    
+    if (process_size > sim->available_memory) {
+        INSTR_FAIL(sim, SIM_ERR_NO_SPACE);
+        return SIM_ERR_NO_SPACE;
+    }
+    
+    // Verificar si el proceso ya existe
+    if (nameIndexFind(sim, process_name) != NULL) {
+        INSTR_FAIL(sim, SIM_ERR_DUPLICATE);
+        return SIM_ERR_DUPLICATE;
+    }
+
+    INSTR_SEARCH_BEGIN();
+    if (sim->partition_type == BUDDY_PARTITIONS) {
+        return buddyAllocate(sim, process_name, process_size);
+    }
+    if (sim->partition_type == BITMAP_PARTITIONS) {
+        return bitmapAllocate(sim, process_name, process_size);
+    }
+    
+    // Buscar un bloque libre según la política de ubicación actual (en particiones fijas,
+    // la menor partición que alcanza)
+    MemoryBlock* current = findFreeBlock(sim, process_size);
+    
+    if (current == NULL) {
+        INSTR_FAIL(sim, SIM_ERR_FRAGMENTATION);
+        return SIM_ERR_FRAGMENTATION;
+    }
+
+    if (sim->partition_type == FIXED_PARTITIONS) {
+        freeIndexRemove(sim, current);
+        current->status = OCCUPIED;
+        current->requested_size = process_size;
+        strcpy(current->process_name, process_name);
+        nameIndexInsert(sim, current);
+        sim->available_memory -= current->size;  // Reservamos toda la partición
+        sim->internal_waste += current->size - process_size;
+        return SIM_OK;
+    }
+    
+    if (current->size > process_size) {
+        // El bloque es más grande de lo necesario: el proceso ocupa el inicio
+        // y el resto queda como un bloque libre insertado justo después
+        MemoryBlock* remainder = blockAlloc(sim);
+        
+        if (remainder == NULL || !freeTableReserve(sim)) {
+            if (remainder != NULL) {
+                blockRelease(sim, remainder);
+            }
+            INSTR_FAIL(sim, SIM_ERR_NO_MEMORY);
+            return SIM_ERR_NO_MEMORY;
+        }
+
+        freeIndexRemove(sim, current);
+        INSTR_COUNT(sim, splits, 1);
+        
+        remainder->id = sim->next_block_id++;
+        remainder->start_address = current->start_address + process_size;
+        remainder->size = current->size - process_size;
+        remainder->status = FREE;
+        strcpy(remainder->process_name, "");
+        
+        current->size = process_size;
+        listInsertAfter(current, remainder);
+        
+        freeIndexInsert(sim, remainder);
+    } else {
+        // El bloque es exactamente del tamaño necesario
+        freeIndexRemove(sim, current);
+    }
+    
+    current->status = OCCUPIED;
+    current->requested_size = process_size;
+    strcpy(current->process_name, process_name);
+    nameIndexInsert(sim, current);
+    sim->available_memory -= process_size;
+    return SIM_OK;
+}
+
+// Asigna memoria para un proceso según el modo de partición
+SimStatus allocateProcess(MemorySimulator* sim, char* process_name, MemSize process_size) {
+    INSTR_START(start);
+    SimStatus status = placeProcess(sim, process_name, process_size);
+    
+    INSTR_SEARCH_END(sim);
+    INSTR_STOP(sim, INSTR_ALLOCATE, start);
+    return status;
+}
+
+// Libera la memoria ocupada por un proceso
+SimStatus deallocateProcess(MemorySimulator* sim, char* process_name) {
+    INSTR_START(start);
+    MemoryBlock* current = nameIndexFind(sim, process_name);
+    
+    if (current == NULL) {
+        INSTR_FAIL(sim, SIM_ERR_NOT_FOUND);
+        INSTR_STOP(sim, INSTR_DEALLOCATE, start);
+        return SIM_ERR_NOT_FOUND;
+    }
+
+    // Liberar el bloque
+    nameIndexRemove(sim, current);
+    sim->internal_waste -= current->size - current->requested_size;
+    current->status = FREE;
+    strcpy(current->process_name, "");
+    
+    if (sim->partition_type == FIXED_PARTITIONS) {
+        sim->available_memory += current->size;
+        sim->freed_start = current->start_address;
+        sim->freed_size = current->size;
+        freeIndexInsert(sim, current);
+    } else if (sim->partition_type == BUDDY_PARTITIONS) {
+        sim->available_memory += current->size;
+        buddyFreeBlock(sim, current);
+    } else if (sim->partition_type == BITMAP_PARTITIONS) {
+        sim->available_memory += current->size;
+        sim->freed_start = current->start_address;
+        sim->freed_size = current->size;
+        bitmapFreeBlock(sim, current);
+    } else {
+        sim->available_memory += current->size;
+        
+        // El nuevo hueco puede estar antes del punto donde retoma la compactación
+        if (sim->compact_cursor != NULL && current->start_address < sim->compact_cursor->start_address) {
+            sim->compact_cursor = current;
+        }
+        
+        // Intentar fusionar con bloques adyacentes (coalescing)
+        MemoryBlock* next_block = current->next;
+        
+        // Fusionar con el bloque siguiente si está libre
+        if (next_block != NULL && next_block->status == FREE) {
+            freeIndexRemove(sim, next_block);
+            current->size += next_block->size;
+            listUnlink(sim, next_block);
+            blockRelease(sim, next_block);
+            INSTR_COUNT(sim, coalesces, 1);
+        }
+        
+        // Fusionar con el bloque anterior si está libre
+        MemoryBlock* prev = current->prev;
+        if (prev != NULL && prev->status == FREE) {
+            INSTR_COUNT(sim, coalesces, 1);
+            freeIndexRemove(sim, prev);
+            prev->size += current->size;
+            if (sim->compact_cursor == current) {
+                sim->compact_cursor = prev;
+            }
+            listUnlink(sim, current);
+            blockRelease(sim, current);
+            current = prev;
+        }
+        
+        sim->freed_start = current->start_address;
+        sim->freed_size = current->size;
+        freeIndexInsert(sim, current);
+    }
+    
+    INSTR_STOP(sim, INSTR_DEALLOCATE, start);
+    return SIM_OK;
+}
+
+// Calcula la fragmentación interna y externa a partir de los contadores (O(1))
+void calculateFragmentation(MemorySimulator* sim, MemSize* internal_frag, MemSize* external_frag) {
+    INSTR_START(start);
+    
+    // Interna: espacio asignado que el proceso no pidió (particiones fijas y buddy);
+    // en particiones dinámicas cada bloque mide exactamente lo solicitado
+    *internal_frag = sim->internal_waste;
+    
+    // Externa: memoria libre en huecos; en particiones fijas es cero
+    *external_frag = (sim->partition_type == FIXED_PARTITIONS) ? 0 : sim->free_memory;
+    
+    INSTR_STOP(sim, INSTR_FRAGMENTATION, start);
+}
+
+// Tamaño del mayor bloque libre, consultado al índice de la política actual
+MemSize largestFreeBlock(MemorySimulator* sim) {
+    if (sim->partition_type == FIXED_PARTITIONS) {
+        return partitionIndexLargest(&sim->partitions);
+    }
+    if (sim->partition_type == BUDDY_PARTITIONS) {
+        return sim->buddy_order_mask == 0 ? 0 : 1ULL << (63 - __builtin_clzll(sim->buddy_order_mask));
+    }
+    if (sim->partition_type == BITMAP_PARTITIONS) {
+        return bitmapLargestRun(sim);
+    }
+    
+    if (sim->placement != PLACEMENT_SEGREGATED_FIT) {
+        // Cada nodo del treap guarda el máximo de su subárbol (con la tabla contigua el
+        // treap por dirección se mantiene solo para esto)
+        return sim->free_tree == NULL ? 0 : sim->free_tree->tree_max_size;
+    }
+    
+    // TLSF: la clase no vacía más alta contiene al mayor; solo se recorre esa clase
+    if (sim->bins.fl_bitmap == 0) {
+        return 0;
+    }
+    
+    int fl = 63 - __builtin_clzll(sim->bins.fl_bitmap);
+    int sl = 31 - __builtin_clz(sim->bins.sl_bitmap[fl]);
+    MemSize largest = 0;
+    
+    for (MemoryBlock* block = sim->bins.heads[fl][sl]; block != NULL; block = block->free_next) {
+        if (block->size > largest) {
+            largest = block->size;
+        }
+    }
+    
+    return largest;
+}
+
+// Tamaño del hueco que dejó la última liberación, ya unido a los huecos vecinos. Vale
+// hasta la siguiente operación; en modo mapa de bits la racha se mide recién aquí
+MemSize freedHoleSize(MemorySimulator* sim) {
+    if (sim->partition_type != BITMAP_PARTITIONS || sim->freed_size == 0) {
+        return sim->freed_size;
+    }
+    
+    size_t start = (size_t) (sim->freed_start / sim->bitmap_chunk);
+    size_t end = start + (size_t) (sim->freed_size / sim->bitmap_chunk);
+    return (MemSize) bitmapRunAround(sim, start, end) * sim->bitmap_chunk;
+}
+
+// Obtiene las estadísticas de ocupación sin recorrer el mapa de memoria
+void getMemoryStats(MemorySimulator* sim, MemoryStats* stats) {
+    stats->free_memory = sim->free_memory;
+    stats->free_blocks = sim->free_block_count;
+    stats->largest_free_block = largestFreeBlock(sim);
+    stats->occupied_blocks = sim->name_index_count;
+    stats->internal_waste = sim->internal_waste;
+    stats->external_ratio = (sim->free_memory > 0)
+        ? 1.0 - (double) stats->largest_free_block / (double) sim->free_memory
+        : 0.0;
+}
+
+// Compacta la memoria (solo para particiones dinámicas); result recibe lo que se movió
+SimStatus compactMemory(MemorySimulator* sim, CompactionResult* result) {
+    compactMemoryStep(sim, 0, 0, result);
+    return sim->partition_type == DYNAMIC_PARTITIONS ? SIM_OK : SIM_ERR_UNSUPPORTED;
+}
+
+// Desplaza el primer bloque ocupado que sigue a un hueco hacia el inicio del hueco.
+// El hueco pasa a quedar detrás del bloque y se fusiona con el siguiente si está libre.
+// Devuelve el hueco resultante.
+static MemoryBlock* compactSlide(MemorySimulator* sim, MemoryBlock* hole) {
+    MemoryBlock* block = hole->next;
+    
+    freeIndexRemove(sim, hole);
+    
+    // Intercambiar posiciones: el bloque ocupado baja y el hueco sube
+    block->start_address = hole->start_address;
+    hole->start_address = block->start_address + block->size;
+    listUnlink(sim, hole);
+    listInsertAfter(block, hole);
+    
+    sim->compaction_moved += block->size;
+    sim->compaction_blocks_moved++;
+    
+    // Absorber el bloque libre que ahora queda a continuación
+    MemoryBlock* next_block = hole->next;
+    if (next_block != NULL && next_block->status == FREE) {
+        freeIndexRemove(sim, next_block);
+        hole->size += next_block->size;
+        listUnlink(sim, next_block);
+        blockRelease(sim, next_block);
+        INSTR_COUNT(sim, coalesces, 1);
+    }
+    
+    freeIndexInsert(sim, hole);
+    return hole;
+}
+
+// Primer hueco a partir del cursor de compactación (avanza el cursor hasta él)
+static MemoryBlock* compactFirstHole(MemorySimulator* sim) {
+    MemoryBlock* hole = (sim->compact_cursor != NULL) ? sim->compact_cursor : sim->memory_map;
+    
+    while (hole != NULL && hole->status == OCCUPIED) {
+        hole = hole->next;
+    }
+    
+    if (hole != NULL) {
+        sim->compact_cursor = hole;
+    }
+    return hole;
+}
+
+// Compactación incremental en el lugar: mueve como máximo max_blocks bloques o max_size unidades
+// (0 = sin límite). Siempre mueve al menos un bloque si queda algún hueco, para avanzar.
+// Devuelve true cuando ya no quedan huecos entre bloques ocupados.
+bool compactMemoryStep(MemorySimulator* sim, uint64_t max_blocks, MemSize max_size, CompactionResult* result) {
+    result->blocks_moved = 0;
+    result->size_moved = 0;
+    result->completed = true;
+    
+    // La llamada se cuenta aunque el modo no admita compactación
+    INSTR_START(start);
+    
+    if (sim->partition_type != DYNAMIC_PARTITIONS) {
+        INSTR_STOP(sim, INSTR_COMPACT, start);
+        return true;
+    }
+    
+    MemoryBlock* hole = compactFirstHole(sim);
+    
+    while (hole != NULL && hole->next != NULL) {
+        MemSize block_size = hole->next->size;
+        
+        if (result->blocks_moved > 0) {
+            if (max_blocks > 0 && result->blocks_moved >= max_blocks) break;
+            if (max_size > 0 && result->size_moved + block_size > max_size) break;
+        }
+        
+        hole = compactSlide(sim, hole);
+        sim->compact_cursor = hole;
+        result->blocks_moved++;
+        result->size_moved += block_size;
+    }
+    
+    result->completed = (hole == NULL || hole->next == NULL);
+    INSTR_STOP(sim, INSTR_COMPACT, start);
+    return result->completed;
+}
+
+// Compacta solo lo necesario para que un proceso del tamaño dado quepa en el hueco que
+// se va desplazando. Pensada para llamarse cuando una asignación acaba de fallar.
+bool compactUntilFits(MemorySimulator* sim, MemSize process_size, CompactionResult* result) {
+    result->blocks_moved = 0;
+    result->size_moved = 0;
+    result->completed = true;
+    
+    // Como en compactMemoryStep, la llamada se cuenta aunque no pueda compactar
+    INSTR_START(start);
+    
+    if (sim->partition_type != DYNAMIC_PARTITIONS || process_size > sim->available_memory) {
+        INSTR_STOP(sim, INSTR_COMPACT, start);
+        return false;
+    }
+    
+    MemoryBlock* hole = compactFirstHole(sim);
+    
+    while (hole != NULL && hole->size < process_size && hole->next != NULL) {
+        result->size_moved += hole->next->size;
+        result->blocks_moved++;
+        hole = compactSlide(sim, hole);
+        sim->compact_cursor = hole;
+    }
+    
+    result->completed = (hole == NULL || hole->next == NULL);
+    INSTR_STOP(sim, INSTR_COMPACT, start);
+    return hole != NULL && hole->size >= process_size;
+}
+
+// Libera la memoria utilizada por el simulador
+void freeSimulator(MemorySimulator* sim) {
+    // Los nodos viven en el pool: se liberan junto con sus trozos
+    blockPoolDestroy(sim);
+    free(sim->name_index);
+    buddyRelease(sim);
+    bitmapRelease(sim);
+    partitionIndexRelease(sim);
+    freeTableRelease(sim);
+    free(sim);
+}
+
+// Inserta un bloque inmediatamente después de otro en O(1)
+void listInsertAfter(MemoryBlock* position, MemoryBlock* block) {
+    block->prev = position;
+    block->next = position->next;
+    
+    if (position->next != NULL) {
+        position->next->prev = block;
+    }
+    position->next = block;
+}
+
+// Quita un bloque de la lista en O(1) (no lo devuelve al pool)
+void listUnlink(MemorySimulator* sim, MemoryBlock* block) {
+    if (block->prev != NULL) {
+        block->prev->next = block->next;
+    } else {
+        sim->memory_map = block->next;
+    }
+    
+    if (block->next != NULL) {
+        block->next->prev = block->prev;
+    }
+    
+    block->prev = NULL;
+    block->next = NULL;
+}
+
+// Entrega un nodo del pool: primero reutiliza devueltos y luego toma nodos nuevos
+MemoryBlock* blockAlloc(MemorySimulator* sim) {
+    BlockPool* pool = &sim->pool;
+    MemoryBlock* block;
+    
+    if (pool->free_list != NULL) {
+        block = pool->free_list;
+        pool->free_list = block->next;
+    } else {
+        // Avanzar al siguiente trozo ya reservado o reservar uno nuevo
+        if (pool->current_chunk == NULL || pool->current_used == pool->current_chunk->capacity) {
+            if (pool->current_chunk != NULL && pool->current_chunk->next != NULL) {
+                pool->current_chunk = pool->current_chunk->next;
+            } else {
+                size_t capacity = (pool->last_chunk == NULL) ? BLOCK_POOL_FIRST_CHUNK : pool->last_chunk->capacity * 2;
+                if (capacity > BLOCK_POOL_MAX_CHUNK) capacity = BLOCK_POOL_MAX_CHUNK;
+                
+                BlockChunk* chunk = (BlockChunk*) malloc(sizeof(BlockChunk) + capacity * sizeof(MemoryBlock));
+                if (chunk == NULL) {
+                    return NULL;
+                }
+                
+                chunk->next = NULL;
+                chunk->capacity = capacity;
+                
+                if (pool->last_chunk == NULL) {
+                    pool->first_chunk = chunk;
+                } else {
+                    pool->last_chunk->next = chunk;
+                }
+                pool->last_chunk = chunk;
+                pool->current_chunk = chunk;
+                pool->total_nodes += capacity;
+            }
+            pool->current_used = 0;
+        }
+        
+        block = &pool->current_chunk->nodes[pool->current_used++];
+    }
+    
+    pool->live_nodes++;
+    return block;
+}
+
+// Devuelve un nodo al pool para reutilizarlo
+void blockRelease(MemorySimulator* sim, MemoryBlock* block) {
+    block->next = sim->pool.free_list;
+    sim->pool.free_list = block;
+    sim->pool.live_nodes--;
+}
+
+// Da por libres todos los nodos a la vez, conservando los trozos reservados
+void blockPoolReset(MemorySimulator* sim) {
+    BlockPool* pool = &sim->pool;
+    
+    pool->current_chunk = pool->first_chunk;
+    pool->current_used = 0;
+    pool->free_list = NULL;
+    pool->live_nodes = 0;
+}
+
+// Libera todos los trozos del pool
+void blockPoolDestroy(MemorySimulator* sim) {
+    BlockChunk* chunk = sim->pool.first_chunk;
+    
+    while (chunk != NULL) {
+        BlockChunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    
+    memset(&sim->pool, 0, sizeof(BlockPool));
+}
+
+// Garantiza que los nodos aún no entregados alcancen para count bloques más, agregando
+// a lo sumo un trozo del tamaño justo (una sola reserva para cargas masivas)
+bool blockPoolReserve(MemorySimulator* sim, size_t count) {
+    BlockPool* pool = &sim->pool;
+    size_t remaining = 0;
+    
+    if (pool->current_chunk != NULL) {
+        remaining = pool->current_chunk->capacity - pool->current_used;
+        for (BlockChunk* chunk = pool->current_chunk->next; chunk != NULL; chunk = chunk->next) {
+            remaining += chunk->capacity;
+        }
+    }
+    if (remaining >= count) {
+        return true;
+    }
+    
+    size_t capacity = count - remaining;
+    BlockChunk* chunk = (BlockChunk*) malloc(sizeof(BlockChunk) + capacity * sizeof(MemoryBlock));
+    if (chunk == NULL) {
+        return false;
+    }
+    
+    chunk->next = NULL;
+    chunk->capacity = capacity;
+    if (pool->last_chunk == NULL) {
+        pool->first_chunk = chunk;
+        pool->current_chunk = chunk;
+        pool->current_used = 0;
+    } else {
+        pool->last_chunk->next = chunk;
+    }
+    pool->last_chunk = chunk;
+    pool->total_nodes += capacity;
+    return true;
+}
+
+// Función hash FNV-1a sobre el nombre del proceso
+static size_t hashProcessName(const char* process_name) {
+    uint64_t hash = 14695981039346656037ULL;
+    
+    while (*process_name != '\0') {
+        hash ^= (unsigned char) *process_name++;
+        hash *= 1099511628211ULL;
+    }
+    
+    return (size_t) hash;
+}
+
+// Reserva la tabla del índice por nombre con la capacidad dada (potencia de dos)
+bool nameIndexInit(MemorySimulator* sim, size_t capacity) {
+    sim->name_index = (MemoryBlock**) calloc(capacity, sizeof(MemoryBlock*));
+    
+    if (sim->name_index == NULL) {
+        return false;
+    }
+    
+    sim->name_index_capacity = capacity;
+    sim->name_index_count = 0;
+    return true;
+}
+
+// Busca el bloque ocupado por un proceso en O(1) promedio
+MemoryBlock* nameIndexFind(MemorySimulator* sim, const char* process_name) {
+    size_t bucket = hashProcessName(process_name) & (sim->name_index_capacity - 1);
+    MemoryBlock* current = sim->name_index[bucket];
+    
+    while (current != NULL) {
+        if (strcmp(current->process_name, process_name) == 0) {
+            return current;
+        }
+        current = current->hash_next;
+    }
+    
+    return NULL;
+}
+
+// Duplica el número de cubetas cuando el factor de carga supera 3/4
+static void nameIndexGrow(MemorySimulator* sim) {
+    size_t new_capacity = sim->name_index_capacity * 2;
+    MemoryBlock** new_table = (MemoryBlock**) calloc(new_capacity, sizeof(MemoryBlock*));
+    
+    if (new_table == NULL) {
+        return;  // Se sigue operando con la tabla actual, solo más cargada
+    }
+    
+    for (size_t i = 0; i < sim->name_index_capacity; i++) {
+        MemoryBlock* current = sim->name_index[i];
+        
+        while (current != NULL) {
+            MemoryBlock* next = current->hash_next;
+            size_t bucket = hashProcessName(current->process_name) & (new_capacity - 1);
+            current->hash_next = new_table[bucket];
+            new_table[bucket] = current;
+            current = next;
+        }
+    }
+    
+    free(sim->name_index);
+    sim->name_index = new_table;
+    sim->name_index_capacity = new_capacity;
+}
+
+// Agrega un bloque ocupado al índice (el nombre ya debe estar copiado en el bloque)
+void nameIndexInsert(MemorySimulator* sim, MemoryBlock* block) {
+    if (sim->name_index_count + 1 > sim->name_index_capacity - sim->name_index_capacity / 4) {
+        nameIndexGrow(sim);
+    }
+    
+    size_t bucket = hashProcessName(block->process_name) & (sim->name_index_capacity - 1);
+    block->hash_next = sim->name_index[bucket];
+    sim->name_index[bucket] = block;
+    sim->name_index_count++;
+}
+
+// Quita un bloque del índice (antes de borrar su nombre)
+void nameIndexRemove(MemorySimulator* sim, MemoryBlock* block) {
+    size_t bucket = hashProcessName(block->process_name) & (sim->name_index_capacity - 1);
+    MemoryBlock** link = &sim->name_index[bucket];
+    
+    while (*link != NULL) {
+        if (*link == block) {
+            *link = block->hash_next;
+            block->hash_next = NULL;
+            sim->name_index_count--;
+            return;
+        }
+        link = &(*link)->hash_next;
+    }
+}
+
+// Vacía el índice sin liberar la tabla (los bloques se liberan aparte)
+void nameIndexClear(MemorySimulator* sim) {
+    memset(sim->name_index, 0, sim->name_index_capacity * sizeof(MemoryBlock*));
+    sim->name_index_count = 0;
+}
+
+// Nombre legible de una política de ubicación
+const char* placementPolicyName(PlacementPolicy policy) {
+    switch (policy) {
+        case PLACEMENT_FIRST_FIT:      return "first";
+        case PLACEMENT_NEXT_FIT:       return "next";
+        case PLACEMENT_BEST_FIT:       return "best";
+        case PLACEMENT_WORST_FIT:      return "worst";
+        case PLACEMENT_SEGREGATED_FIT: return "segregated";
+        case PLACEMENT_FIRST_FIT_SCAN: return "scan";
+    }
+    return "?";
+}
+
+// Interpreta el nombre de una política de ubicación
+bool parsePlacementPolicy(const char* text, PlacementPolicy* policy) {
+    if (strcmp(text, "first") == 0 || strcmp(text, "first-fit") == 0) {
+        *policy = PLACEMENT_FIRST_FIT;
+    } else if (strcmp(text, "next") == 0 || strcmp(text, "next-fit") == 0) {
+        *policy = PLACEMENT_NEXT_FIT;
+    } else if (strcmp(text, "best") == 0 || strcmp(text, "best-fit") == 0) {
+        *policy = PLACEMENT_BEST_FIT;
+    } else if (strcmp(text, "worst") == 0 || strcmp(text, "worst-fit") == 0) {
+        *policy = PLACEMENT_WORST_FIT;
+    } else if (strcmp(text, "segregated") == 0 || strcmp(text, "tlsf") == 0) {
+        *policy = PLACEMENT_SEGREGATED_FIT;
+    } else if (strcmp(text, "scan") == 0 || strcmp(text, "simd") == 0) {
+        *policy = PLACEMENT_FIRST_FIT_SCAN;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Cambia la política de ubicación y reconstruye el índice de bloques libres. Si no hay
+// memoria para el índice nuevo se conserva la política anterior
+SimStatus setPlacementPolicy(MemorySimulator* sim, PlacementPolicy policy) {
+    PlacementPolicy previous = sim->placement;
+    
+    sim->placement = policy;
+    if (!freeIndexRebuild(sim)) {
+        sim->placement = previous;
+        freeIndexRebuild(sim);
+        return SIM_ERR_NO_MEMORY;
+    }
+    return SIM_OK;
+}
+
+// Calcula la clase (primer y segundo nivel) a la que pertenece un tamaño
+static void tlsfMapping(uint64_t size, int* fl, int* sl) {
+    if (size < TLSF_SL_COUNT) {
+        // Tamaños pequeños: una clase por valor dentro del nivel 0
+        *fl = 0;
+        *sl = (int) size;
+    } else {
+        int log2 = 63 - __builtin_clzll(size);
+        *fl = log2 - TLSF_SL_BITS + 1;
+        *sl = (int) ((size >> (log2 - TLSF_SL_BITS)) - TLSF_SL_COUNT);
+    }
+}
+
+// Busca la primera clase no vacía cuyos bloques garantizan alcanzar para el tamaño
+static MemoryBlock* tlsfSearch(SegregatedBins* bins, uint64_t size) {
+    int fl, sl;
+    
+    // Redondear al inicio de la siguiente clase para que cualquier bloque de ella alcance
+    uint64_t rounded = size;
+    if (size >= TLSF_SL_COUNT) {
+        int log2 = 63 - __builtin_clzll(size);
+        rounded += (1ULL << (log2 - TLSF_SL_BITS)) - 1;
+    }
+    tlsfMapping(rounded, &fl, &sl);
+    
+    // Cerca de 2^64 el redondeo desborda: solo queda la búsqueda en la clase exacta
+    if (rounded >= size && fl < TLSF_FL_COUNT) {
+        uint32_t sl_map = bins->sl_bitmap[fl] & (~0U << sl);
+        
+        if (sl_map == 0) {
+            // Ninguna clase adecuada en este nivel: subir al siguiente nivel no vacío
+            uint64_t fl_map = (fl + 1 < TLSF_FL_COUNT) ? bins->fl_bitmap & (~0ULL << (fl + 1)) : 0;
+            
+            if (fl_map != 0) {
+                fl = __builtin_ctzll(fl_map);
+                sl_map = bins->sl_bitmap[fl];
+            }
+        }
+        
+        if (sl_map != 0) {
+            sl = __builtin_ctz(sl_map);
+            INSTR_VISIT(1);
+            return bins->heads[fl][sl];
+        }
+    }
+    
+    // Último recurso: la clase exacta del tamaño puede tener bloques que sí alcanzan
+    tlsfMapping(size, &fl, &sl);
+    for (MemoryBlock* block = bins->heads[fl][sl]; block != NULL; block = block->free_next) {
+        INSTR_VISIT(1);
+        if (block->size >= size) {
+            return block;
+        }
+    }
+    
+    return NULL;
+}
+
+// Agrega un bloque libre a la cabeza de su clase
+static void tlsfInsert(SegregatedBins* bins, MemoryBlock* block) {
+    int fl, sl;
+    tlsfMapping(block->size, &fl, &sl);
+    
+    block->free_prev = NULL;
+    block->free_next = bins->heads[fl][sl];
+    if (block->free_next != NULL) {
+        block->free_next->free_prev = block;
+    }
+    
+    bins->heads[fl][sl] = block;
+    bins->fl_bitmap |= 1ULL << fl;
+    bins->sl_bitmap[fl] |= 1U << sl;
+}
+
+// Quita un bloque libre de su clase (su tamaño no debe haber cambiado desde que se insertó)
+static void tlsfRemove(SegregatedBins* bins, MemoryBlock* block) {
+    int fl, sl;
+    tlsfMapping(block->size, &fl, &sl);
+    
+    if (block->free_prev != NULL) {
+        block->free_prev->free_next = block->free_next;
+    } else {
+        bins->heads[fl][sl] = block->free_next;
+    }
+    if (block->free_next != NULL) {
+        block->free_next->free_prev = block->free_prev;
+    }
+    
+    if (bins->heads[fl][sl] == NULL) {
+        bins->sl_bitmap[fl] &= ~(1U << sl);
+        if (bins->sl_bitmap[fl] == 0) {
+            bins->fl_bitmap &= ~(1ULL << fl);
+        }
+    }
+    
+    block->free_prev = NULL;
+    block->free_next = NULL;
+}
+
+// Indica si la política usa el treap ordenado por tamaño (si no, por dirección)
+static bool treeBySize(PlacementPolicy policy) {
+    return policy == PLACEMENT_BEST_FIT || policy == PLACEMENT_WORST_FIT;
+}
+
+// Orden del treap: por dirección, o por (tamaño, dirección) para best/worst-fit
+static bool treeLess(const MemoryBlock* a, const MemoryBlock* b, bool by_size) {
+    if (by_size && a->size != b->size) {
+        return a->size < b->size;
+    }
+    return a->start_address < b->start_address;
+}
+
+// Recalcula el máximo tamaño libre del subárbol a partir de sus hijos
+static void treeUpdate(MemoryBlock* node) {
+    MemSize max_size = node->size;
+    
+    if (node->tree_left != NULL && node->tree_left->tree_max_size > max_size) {
+        max_size = node->tree_left->tree_max_size;
+    }
+    if (node->tree_right != NULL && node->tree_right->tree_max_size > max_size) {
+        max_size = node->tree_right->tree_max_size;
+    }
+    
+    node->tree_max_size = max_size;
+}
+
+// Divide el treap en nodos menores que la clave (left) y mayores o iguales (right)
+static void treeSplit(MemoryBlock* root, const MemoryBlock* key, bool by_size,
+                      MemoryBlock** left, MemoryBlock** right) {
+    if (root == NULL) {
+        *left = NULL;
+        *right = NULL;
+    } else if (treeLess(root, key, by_size)) {
+        treeSplit(root->tree_right, key, by_size, &root->tree_right, right);
+        treeUpdate(root);
+        *left = root;
+    } else {
+        treeSplit(root->tree_left, key, by_size, left, &root->tree_left);
+        treeUpdate(root);
+        *right = root;
+    }
+}
+
+// Une dos treaps donde todas las claves de a son menores que las de b
+static MemoryBlock* treeMerge(MemoryBlock* a, MemoryBlock* b) {
+    if (a == NULL) return b;
+    if (b == NULL) return a;
+    
+    if (a->tree_priority > b->tree_priority) {
+        a->tree_right = treeMerge(a->tree_right, b);
+        treeUpdate(a);
+        return a;
+    }
+    
+    b->tree_left = treeMerge(a, b->tree_left);
+    treeUpdate(b);
+    return b;
+}
+
+// Inserta un bloque libre en el treap
+static void treeInsert(MemorySimulator* sim, MemoryBlock* node, bool by_size) {
+    // xorshift64 para las prioridades
+    sim->tree_seed ^= sim->tree_seed << 13;
+    sim->tree_seed ^= sim->tree_seed >> 7;
+    sim->tree_seed ^= sim->tree_seed << 17;
+    
+    node->tree_priority = (uint32_t) (sim->tree_seed >> 32);
+    node->tree_left = NULL;
+    node->tree_right = NULL;
+    node->tree_max_size = node->size;
+    
+    MemoryBlock* left;
+    MemoryBlock* right;
+    treeSplit(sim->free_tree, node, by_size, &left, &right);
+    sim->free_tree = treeMerge(treeMerge(left, node), right);
+}
+
+// Quita un bloque del subárbol (su clave no debe haber cambiado desde que se insertó)
+static MemoryBlock* treeRemove(MemoryBlock* root, MemoryBlock* node, bool by_size) {
+    if (root == NULL) {
+        return NULL;
+    }
+    
+    if (root == node) {
+        MemoryBlock* merged = treeMerge(node->tree_left, node->tree_right);
+        node->tree_left = NULL;
+        node->tree_right = NULL;
+        return merged;
+    }
+    
+    if (treeLess(node, root, by_size)) {
+        root->tree_left = treeRemove(root->tree_left, node, by_size);
+    } else {
+        root->tree_right = treeRemove(root->tree_right, node, by_size);
+    }
+    
+    treeUpdate(root);
+    return root;
+}
+
+// Bloque de menor dirección del subárbol con al menos el tamaño dado
+static MemoryBlock* treeLeftmostFit(MemoryBlock* node, MemSize size) {
+    while (node != NULL && node->tree_max_size >= size) {
+        INSTR_VISIT(1);
+        if (node->tree_left != NULL && node->tree_left->tree_max_size >= size) {
+            node = node->tree_left;
+        } else if (node->size >= size) {
+            return node;
+        } else {
+            node = node->tree_right;
+        }
+    }
+    return NULL;
+}
+
+// Bloque de menor dirección >= min_address con al menos el tamaño dado (árbol por dirección)
+static MemoryBlock* treeFirstFitFrom(MemoryBlock* node, MemSize min_address, MemSize size) {
+    if (node == NULL || node->tree_max_size < size) {
+        return NULL;
+    }
+    INSTR_VISIT(1);
+    
+    if (node->start_address < min_address) {
+        return treeFirstFitFrom(node->tree_right, min_address, size);
+    }
+    
+    // Este nodo y todo su subárbol derecho están por encima de min_address
+    MemoryBlock* found = treeFirstFitFrom(node->tree_left, min_address, size);
+    if (found != NULL) {
+        return found;
+    }
+    if (node->size >= size) {
+        return node;
+    }
+    return treeLeftmostFit(node->tree_right, size);
+}
+
+// Menor bloque con tamaño >= size; a igual tamaño, el de menor dirección (árbol por tamaño)
+static MemoryBlock* treeLowerBound(MemoryBlock* node, MemSize size) {
+    MemoryBlock* found = NULL;
+    
+    while (node != NULL) {
+        INSTR_VISIT(1);
+        if (node->size >= size) {
+            found = node;
+            node = node->tree_left;
+        } else {
+            node = node->tree_right;
+        }
+    }
+    
+    return found;
+}
+
+// Encuentra un bloque libre de al menos el tamaño dado según la política actual. En
+// particiones fijas la política no aplica: siempre es la menor partición que alcanza
+MemoryBlock* findFreeBlock(MemorySimulator* sim, MemSize size) {
+    if (sim->partition_type == FIXED_PARTITIONS) {
+        return partitionIndexSearch(&sim->partitions, size);
+    }
+    
+    switch (sim->placement) {
+        case PLACEMENT_SEGREGATED_FIT:
+            return tlsfSearch(&sim->bins, size);
+        
+        case PLACEMENT_FIRST_FIT:
+            return treeFirstFitFrom(sim->free_tree, 0, size);
+        
+        case PLACEMENT_FIRST_FIT_SCAN: {
+            // La tabla está ordenada por dirección: la primera fila que alcanza es la de first-fit
+            size_t index = freeTableScan(sim->free_table.size, sim->free_table.count, size);
+            INSTR_VISIT(index < sim->free_table.count ? index + 1 : index);
+            return index < sim->free_table.count ? sim->free_table.node[index] : NULL;
+        }
+        
+        case PLACEMENT_NEXT_FIT: {
+            // Continuar desde el cursor y, si no hay lugar, dar la vuelta al inicio
+            MemoryBlock* found = treeFirstFitFrom(sim->free_tree, sim->next_fit_cursor, size);
+            if (found == NULL) {
+                found = treeFirstFitFrom(sim->free_tree, 0, size);
+            }
+            if (found != NULL) {
+                sim->next_fit_cursor = found->start_address + size;
+            }
+            return found;
+        }
+        
+        case PLACEMENT_BEST_FIT:
+            return treeLowerBound(sim->free_tree, size);
+        
+        case PLACEMENT_WORST_FIT: {
+            // El más grande es el extremo derecho; entre iguales, el de menor dirección
+            MemoryBlock* largest = sim->free_tree;
+            while (largest != NULL && largest->tree_right != NULL) {
+                INSTR_VISIT(1);
+                largest = largest->tree_right;
+            }
+            if (largest == NULL || largest->size < size) {
+                return NULL;
+            }
+            return treeLowerBound(sim->free_tree, largest->size);
+        }
+    }
+    
+    return NULL;
+}
+
+// Primera fila cuya dirección de inicio es >= address (búsqueda binaria)
+static size_t freeTableLowerBound(const FreeTable* table, MemSize address) {
+    size_t low = 0;
+    size_t high = table->count;
+    
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (table->start[middle] < address) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+// Garantiza una fila por cada nodo vivo. Como nunca hay más bloques libres que nodos,
+// las inserciones posteriores no reservan memoria y no pueden fallar a mitad de una
+// operación; se llama antes de crear un nodo y al reconstruir el índice
+bool freeTableReserve(MemorySimulator* sim) {
+    FreeTable* table = &sim->free_table;
+    
+    if (sim->placement != PLACEMENT_FIRST_FIT_SCAN || table->capacity > sim->pool.live_nodes) {
+        return true;
+    }
+    
+    size_t capacity = (table->capacity == 0) ? FREE_TABLE_INITIAL_CAPACITY : table->capacity;
+    while (capacity <= sim->pool.live_nodes) {
+        capacity *= 2;
+    }
+    
+    MemSize* start = (MemSize*) realloc(table->start, capacity * sizeof(MemSize));
+    if (start != NULL) table->start = start;
+    MemSize* size = (MemSize*) realloc(table->size, capacity * sizeof(MemSize));
+    if (size != NULL) table->size = size;
+    MemoryBlock** node = (MemoryBlock**) realloc(table->node, capacity * sizeof(MemoryBlock*));
+    if (node != NULL) table->node = node;
+    
+    if (start == NULL || size == NULL || node == NULL) {
+        return false;
+    }
+    table->capacity = capacity;
+    return true;
+}
+
+// Agrega un bloque libre a la tabla manteniendo el orden por dirección (la capacidad ya
+// fue reservada por freeTableReserve)
+static void freeTableInsert(MemorySimulator* sim, MemoryBlock* block) {
+    FreeTable* table = &sim->free_table;
+
+    // Desplazar las filas posteriores: memmove sobre arreglos contiguos
+    size_t index = freeTableLowerBound(table, block->start_address);
+    size_t tail = table->count - index;
+    memmove(&table->start[index + 1], &table->start[index], tail * sizeof(MemSize));
+    memmove(&table->size[index + 1], &table->size[index], tail * sizeof(MemSize));
+    memmove(&table->node[index + 1], &table->node[index], tail * sizeof(MemoryBlock*));
+    
+    table->start[index] = block->start_address;
+    table->size[index] = block->size;
+    table->node[index] = block;
+    table->count++;
+}
+
+// Quita un bloque libre de la tabla (su dirección no debe haber cambiado desde que se insertó)
+static void freeTableRemove(MemorySimulator* sim, MemoryBlock* block) {
+    FreeTable* table = &sim->free_table;
+    size_t index = freeTableLowerBound(table, block->start_address);
+    
+    if (index == table->count || table->node[index] != block) {
+        table->missing++;  // Lo reporta validateSimulator
+        return;
+    }
+    
+    size_t tail = table->count - index - 1;
+    memmove(&table->start[index], &table->start[index + 1], tail * sizeof(MemSize));
+    memmove(&table->size[index], &table->size[index + 1], tail * sizeof(MemSize));
+    memmove(&table->node[index], &table->node[index + 1], tail * sizeof(MemoryBlock*));
+    table->count--;
+}
+
+// Libera los arreglos de la tabla de bloques libres
+void freeTableRelease(MemorySimulator* sim) {
+    free(sim->free_table.start);
+    free(sim->free_table.size);
+    free(sim->free_table.node);
+    memset(&sim->free_table, 0, sizeof(FreeTable));
+}
+
+// Escaneo escalar: índice del primer tamaño >= size, o count si no hay ninguno
+size_t freeTableScanScalar(const MemSize* sizes, size_t count, MemSize size) {
+    for (size_t i = 0; i < count; i++) {
+        if (sizes[i] >= size) {
+            return i;
+        }
+    }
+    return count;
+}
+
+#ifdef FREE_TABLE_SIMD
+// Las comparaciones de 64 bits de SSE4.2/AVX2 son con signo: invertir el bit de signo de
+// ambos lados convierte "a >= size" sin signo en "a ^ signo > (size - 1) ^ signo" con signo
+#define FREE_TABLE_SIGN_BIT 0x8000000000000000ULL
+
+// Escaneo con SSE4.2: dos tamaños por comparación, cuatro por iteración
+__attribute__((target("sse4.2")))
+size_t freeTableScanSse42(const MemSize* sizes, size_t count, MemSize size) {
+    const __m128i sign = _mm_set1_epi64x((long long) FREE_TABLE_SIGN_BIT);
+    const __m128i limit = _mm_set1_epi64x((long long) ((size - 1) ^ FREE_TABLE_SIGN_BIT));
+    size_t i = 0;
+    
+    for (; i + 4 <= count; i += 4) {
+        __m128i a = _mm_xor_si128(_mm_loadu_si128((const __m128i*) (sizes + i)), sign);
+        __m128i b = _mm_xor_si128(_mm_loadu_si128((const __m128i*) (sizes + i + 2)), sign);
+        int mask = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(a, limit))) |
+                   (_mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(b, limit))) << 2);
+        if (mask != 0) {
+            return i + (size_t) __builtin_ctz((unsigned) mask);
+        }
+    }
+    
+    return i + freeTableScanScalar(sizes + i, count - i, size);
+}
+
+// Escaneo con AVX2: cuatro tamaños por comparación, ocho por iteración
+__attribute__((target("avx2")))
+size_t freeTableScanAvx2(const MemSize* sizes, size_t count, MemSize size) {
+    const __m256i sign = _mm256_set1_epi64x((long long) FREE_TABLE_SIGN_BIT);
+    const __m256i limit = _mm256_set1_epi64x((long long) ((size - 1) ^ FREE_TABLE_SIGN_BIT));
+    size_t i = 0;
+    
+    for (; i + 8 <= count; i += 8) {
+        __m256i a = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*) (sizes + i)), sign);
+        __m256i b = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*) (sizes + i + 4)), sign);
+        int mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(a, limit))) |
+                   (_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(b, limit))) << 4);
+        if (mask != 0) {
+            return i + (size_t) __builtin_ctz((unsigned) mask);
+        }
+    }
+    
+    return i + freeTableScanScalar(sizes + i, count - i, size);
+}
+#endif
+
+// Índice del primer tamaño >= size (count si no hay), con la mejor variante que soporte la CPU
+size_t freeTableScan(const MemSize* sizes, size_t count, MemSize size) {
+    if (size == 0) {
+        return 0;  // Cualquier fila alcanza (y size - 1 desbordaría en las variantes SIMD)
+    }
+    
+#ifdef FREE_TABLE_SIMD
+    // Consultar la CPU solo lee una variable global ya inicializada (seguro entre hilos)
+    if (__builtin_cpu_supports("avx2")) return freeTableScanAvx2(sizes, count, size);
+    if (__builtin_cpu_supports("sse4.2")) return freeTableScanSse42(sizes, count, size);
+#endif
+    
+    return freeTableScanScalar(sizes, count, size);
+}
+
+// Compara dos tamaños para qsort
+static int compareMemSize(const void* a, const void* b) {
+    MemSize x = *(const MemSize*) a;
+    MemSize y = *(const MemSize*) b;
+    return (x > y) - (x < y);
+}
+
+// Libera los arreglos del índice de particiones fijas
+void partitionIndexRelease(MemorySimulator* sim) {
+    free(sim->partitions.sizes);
+    free(sim->partitions.stacks);
+    free(sim->partitions.tree);
+    memset(&sim->partitions, 0, sizeof(PartitionIndex));
+}
+
+// Arma el índice con los tamaños distintos de las particiones del mapa y las pilas vacías
+// (los bloques libres los agrega quien llama). Devuelve false si no hubo memoria
+static bool partitionIndexBuild(MemorySimulator* sim) {
+    PartitionIndex* index = &sim->partitions;
+    size_t blocks = 0;
+    
+    partitionIndexRelease(sim);
+    for (MemoryBlock* current = sim->memory_map; current != NULL; current = current->next) {
+        blocks++;
+    }
+    if (blocks == 0) {
+        return true;
+    }
+    
+    MemSize* sizes = (MemSize*) malloc(blocks * sizeof(MemSize));
+    if (sizes == NULL) {
+        return false;
+    }
+    
+    size_t i = 0;
+    for (MemoryBlock* current = sim->memory_map; current != NULL; current = current->next) {
+        sizes[i++] = current->size;
+    }
+    qsort(sizes, blocks, sizeof(MemSize), compareMemSize);
+    
+    size_t count = 1;
+    for (i = 1; i < blocks; i++) {
+        if (sizes[i] != sizes[count - 1]) {
+            sizes[count++] = sizes[i];
+        }
+    }
+    
+    size_t leaves = 1;
+    while (leaves < count) {
+        leaves *= 2;
+    }
+    
+    index->sizes = sizes;
+    index->stacks = (MemoryBlock**) calloc(count, sizeof(MemoryBlock*));
+    index->tree = (uint8_t*) calloc(2 * leaves, sizeof(uint8_t));
+    index->count = count;
+    index->leaves = leaves;
+    
+    if (index->stacks == NULL || index->tree == NULL) {
+        partitionIndexRelease(sim);
+        return false;
+    }
+    return true;
+}
+
+// Posición del primer tamaño >= size (count si no hay ninguno), por búsqueda binaria
+static size_t partitionSizeLowerBound(const PartitionIndex* index, MemSize size) {
+    size_t low = 0;
+    size_t high = index->count;
+    
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        
+        if (index->sizes[middle] < size) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+// Marca si la pila del tamaño i tiene particiones y corrige los ancestros que cambian
+static void partitionTreeSet(PartitionIndex* index, size_t i, bool non_empty) {
+    size_t node = index->leaves + i;
+    
+    index->tree[node] = non_empty;
+    for (node /= 2; node >= 1; node /= 2) {
+        uint8_t value = index->tree[2 * node] | index->tree[2 * node + 1];
+        
+        if (index->tree[node] == value) {
+            break;
+        }
+        index->tree[node] = value;
+    }
+}
+
+// Apila una partición libre sobre las de su tamaño
+static void partitionIndexPush(PartitionIndex* index, MemoryBlock* block) {
+    size_t i = partitionSizeLowerBound(index, block->size);
+    
+    block->free_prev = NULL;
+    block->free_next = index->stacks[i];
+    if (block->free_next != NULL) {
+        block->free_next->free_prev = block;
+    } else {
+        partitionTreeSet(index, i, true);
+    }
+    index->stacks[i] = block;
+}
+
+// Quita una partición libre de su pila; solo busca el tamaño si era la cima
+static void partitionIndexRemove(PartitionIndex* index, MemoryBlock* block) {
+    if (block->free_prev != NULL) {
+        block->free_prev->free_next = block->free_next;
+    } else {
+        size_t i = partitionSizeLowerBound(index, block->size);
+        
+        index->stacks[i] = block->free_next;
+        if (block->free_next == NULL) {
+            partitionTreeSet(index, i, false);
+        }
+    }
+    if (block->free_next != NULL) {
+        block->free_next->free_prev = block->free_prev;
+    }
+}
+
+// Cima de la pila del menor tamaño >= size que tenga particiones libres: búsqueda binaria
+// del tamaño y, si su pila está vacía, la siguiente hoja no vacía según el árbol
+MemoryBlock* partitionIndexSearch(const PartitionIndex* index, MemSize size) {
+    size_t i = partitionSizeLowerBound(index, size);
+    
+    if (i == index->count) {
+        return NULL;
+    }
+    
+    size_t node = index->leaves + i;
+    if (!index->tree[node]) {
+        // Subir mientras el nodo sea hijo derecho o su hermano derecho esté vacío
+        while (node > 1 && (node % 2 == 1 || !index->tree[node + 1])) {
+            INSTR_VISIT(1);
+            node /= 2;
+        }
+        if (node == 1) {
+            return NULL;
+        }
+        
+        // Bajar desde el hermano derecho por el hijo no vacío más a la izquierda
+        node++;
+        while (node < index->leaves) {
+            INSTR_VISIT(1);
+            node = index->tree[2 * node] ? 2 * node : 2 * node + 1;
+        }
+    }
+    
+    INSTR_VISIT(1);
+    return index->stacks[node - index->leaves];
+}
+
+// Tamaño de la mayor partición libre: se baja por el hijo no vacío más a la derecha
+MemSize partitionIndexLargest(const PartitionIndex* index) {
+    if (index->count == 0 || !index->tree[1]) {
+        return 0;
+    }
+    
+    size_t node = 1;
+    while (node < index->leaves) {
+        node = index->tree[2 * node + 1] ? 2 * node + 1 : 2 * node;
+    }
+    return index->sizes[node - index->leaves];
+}
+
+// Registra un bloque que acaba de quedar libre en el índice de la política actual
+void freeIndexInsert(MemorySimulator* sim, MemoryBlock* block) {
+    sim->free_memory += block->size;
+    sim->free_block_count++;
+    
+    if (sim->partition_type == FIXED_PARTITIONS) {
+        partitionIndexPush(&sim->partitions, block);
+    } else if (sim->placement == PLACEMENT_SEGREGATED_FIT) {
+        tlsfInsert(&sim->bins, block);
+    } else if (sim->placement == PLACEMENT_FIRST_FIT_SCAN) {
+        // La tabla resuelve la búsqueda; el treap por dirección da el mayor bloque en O(1)
+        freeTableInsert(sim, block);
+        treeInsert(sim, block, false);
+    } else {
+        treeInsert(sim, block, treeBySize(sim->placement));
+    }
+}
+
+// Quita un bloque libre del índice antes de ocuparlo o cambiar su tamaño
+void freeIndexRemove(MemorySimulator* sim, MemoryBlock* block) {
+    sim->free_memory -= block->size;
+    sim->free_block_count--;
+    
+    if (sim->partition_type == FIXED_PARTITIONS) {
+        partitionIndexRemove(&sim->partitions, block);
+    } else if (sim->placement == PLACEMENT_SEGREGATED_FIT) {
+        tlsfRemove(&sim->bins, block);
+    } else if (sim->placement == PLACEMENT_FIRST_FIT_SCAN) {
+        freeTableRemove(sim, block);
+        sim->free_tree = treeRemove(sim->free_tree, block, false);
+    } else {
+        sim->free_tree = treeRemove(sim->free_tree, block, treeBySize(sim->placement));
+    }
+}
+
+// Reconstruye el índice de bloques libres a partir del mapa de memoria. Devuelve false
+// si no hubo memoria para la tabla contigua (el índice queda vacío)
+bool freeIndexRebuild(MemorySimulator* sim) {
+    memset(&sim->bins, 0, sizeof(SegregatedBins));
+    sim->free_tree = NULL;
+    sim->free_table.count = 0;
+    sim->free_table.missing = 0;
+    
+    // En modo buddy las listas por orden son el único índice de bloques libres y en modo
+    // mapa de bits no hay bloques libres con nodo (ambos llevan sus propios contadores)
+    if (sim->partition_type == BUDDY_PARTITIONS || sim->partition_type == BITMAP_PARTITIONS) {
+        return true;
+    }
+    
+    sim->free_memory = 0;
+    sim->free_block_count = 0;
+    
+    if (sim->partition_type == FIXED_PARTITIONS) {
+        // Se apilan desde la última partición para que la de menor dirección quede arriba:
+        // con el mapa recién creado las particiones de un tamaño se ocupan en orden
+        if (!partitionIndexBuild(sim)) {
+            return false;
+        }
+        
+        MemoryBlock* last = sim->memory_map;
+        while (last != NULL && last->next != NULL) {
+            last = last->next;
+        }
+        for (MemoryBlock* current = last; current != NULL; current = current->prev) {
+            if (current->status == FREE) {
+                freeIndexInsert(sim, current);
+            }
+        }
+        return true;
+    }
+    
+    if (!freeTableReserve(sim)) {
+        return false;
+    }
+    
+    for (MemoryBlock* current = sim->memory_map; current != NULL; current = current->next) {
+        if (current->status == FREE) {
+            freeIndexInsert(sim, current);
+        }
+    }
+    return true;
+}
+
+// Orden (log2) de un tamaño potencia de dos
+static int buddyOrderOf(MemSize size) {
+    return 63 - __builtin_clzll(size);
+}
+
+// Posición en buddy_bitmap del bloque de orden dado que comienza en la dirección
+static size_t buddyBit(MemorySimulator* sim, int order, MemSize address) {
+    return sim->buddy_bit_offset[order] + ((size_t) address >> order);
+}
+
+// Agrega un bloque libre a la lista de su orden y marca su bit
+static void buddyPush(MemorySimulator* sim, MemoryBlock* block) {
+    int order = buddyOrderOf(block->size);
+    size_t bit = buddyBit(sim, order, block->start_address);
+    
+    block->free_prev = NULL;
+    block->free_next = sim->buddy_free[order];
+    if (block->free_next != NULL) {
+        block->free_next->free_prev = block;
+    }
+    
+    sim->buddy_free[order] = block;
+    sim->buddy_order_mask |= 1ULL << order;
+    sim->free_memory += block->size;
+    sim->free_block_count++;
+    sim->buddy_bitmap[bit >> 6] |= 1ULL << (bit & 63);
+}
+
+// Quita un bloque libre de la lista de su orden y limpia su bit
+static void buddyUnlink(MemorySimulator* sim, MemoryBlock* block) {
+    int order = buddyOrderOf(block->size);
+    size_t bit = buddyBit(sim, order, block->start_address);
+    
+    if (block->free_prev != NULL) {
+        block->free_prev->free_next = block->free_next;
+    } else {
+        sim->buddy_free[order] = block->free_next;
+    }
+    if (block->free_next != NULL) {
+        block->free_next->free_prev = block->free_prev;
+    }
+    
+    if (sim->buddy_free[order] == NULL) {
+        sim->buddy_order_mask &= ~(1ULL << order);
+    }
+    sim->free_memory -= block->size;
+    sim->free_block_count--;
+    sim->buddy_bitmap[bit >> 6] &= ~(1ULL << (bit & 63));
+    block->free_prev = NULL;
+    block->free_next = NULL;
+}
+
+// Calcula los órdenes del sistema buddy y reserva su mapa de bits, con las listas libres
+// vacías (los bloques los agrega quien llama)
+static bool buddyInitTables(MemorySimulator* sim) {
+    MemSize total = sim->total_memory;
+    sim->buddy_max_order = buddyOrderOf(total);
+    
+    // En memorias enormes el bloque mínimo crece para que el mapa de bits siga siendo chico
+    sim->buddy_min_order = 0;
+    while ((total >> sim->buddy_min_order) > BUDDY_MAX_LEAVES) {
+        sim->buddy_min_order++;
+    }
+    
+    // Un bit por cada bloque posible de cada orden
+    size_t bits = 0;
+    for (int order = sim->buddy_min_order; order <= sim->buddy_max_order; order++) {
+        sim->buddy_bit_offset[order] = bits;
+        bits += (size_t) total >> order;
+    }
+    
+    sim->buddy_bitmap = (uint64_t*) calloc((bits + 63) / 64, sizeof(uint64_t));
+    
+    if (sim->buddy_bitmap == NULL) {
+        return false;
+    }
+    
+    memset(sim->buddy_free, 0, sizeof(sim->buddy_free));
+    sim->buddy_order_mask = 0;
+    sim->free_memory = 0;
+    sim->free_block_count = 0;
+    return true;
+}
+
+// Crea el mapa buddy: la memoria se divide en bloques alineados de potencias de dos
+// (la descomposición binaria del total), cada uno libre en la lista de su orden
+bool buddySetup(MemorySimulator* sim) {
+    MemSize total = sim->total_memory;
+    
+    if (!buddyInitTables(sim)) {
+        return false;
+    }
+    
+    MemoryBlock* prev_block = NULL;
+    MemSize address = 0;
+    
+    for (int order = sim->buddy_max_order; order >= sim->buddy_min_order; order--) {
+        if ((total & (1ULL << order)) == 0) {
+            continue;
+        }
+        
+        MemoryBlock* block = blockAlloc(sim);
+        
+        if (block == NULL) {
+            return false;
+        }
+        
+        block->id = sim->next_block_id++;
+        block->start_address = address;
+        block->size = 1ULL << order;
+        block->status = FREE;
+        strcpy(block->process_name, "");
+        block->next = NULL;
+        block->prev = prev_block;
+        
+        if (prev_block == NULL) {
+            sim->memory_map = block;
+        } else {
+            prev_block->next = block;
+        }
+        prev_block = block;
+        
+        buddyPush(sim, block);
+        address += block->size;
+    }
+    
+    // El resto menor que el bloque mínimo no se puede asignar
+    sim->available_memory -= total - address;
+    sim->usable_memory = address;
+    return true;
+}
+
+// Libera las estructuras auxiliares del modo buddy
+void buddyRelease(MemorySimulator* sim) {
+    free(sim->buddy_bitmap);
+    sim->buddy_bitmap = NULL;
+    memset(sim->buddy_free, 0, sizeof(sim->buddy_free));
+    sim->buddy_order_mask = 0;
+}
+
+// Asigna el menor bloque buddy que alcance, dividiendo bloques mayores si hace falta
+SimStatus buddyAllocate(MemorySimulator* sim, char* process_name, MemSize process_size) {
+    // Orden del menor bloque potencia de dos que contiene al proceso
+    int order = process_size <= 1 ? 0 : 64 - __builtin_clzll(process_size - 1);
+    if (order < sim->buddy_min_order) {
+        order = sim->buddy_min_order;
+    }
+    
+    uint64_t candidates = (order <= sim->buddy_max_order) ? sim->buddy_order_mask & (~0ULL << order) : 0;
+    
+    INSTR_VISIT(1);
+    if (candidates == 0) {
+        INSTR_FAIL(sim, SIM_ERR_FRAGMENTATION);
+        return SIM_ERR_FRAGMENTATION;
+    }
+    
+    int current_order = __builtin_ctzll(candidates);
+    MemoryBlock* block = sim->buddy_free[current_order];
+    buddyUnlink(sim, block);
+    
+    // Dividir a la mitad hasta llegar al orden pedido; la mitad derecha queda libre
+    while (current_order > order) {
+        MemoryBlock* half = blockAlloc(sim);
+        
+        if (half == NULL) {
+            INSTR_FAIL(sim, SIM_ERR_NO_MEMORY);
+            buddyFreeBlock(sim, block);
+            return SIM_ERR_NO_MEMORY;
+        }
+        
+        current_order--;
+        INSTR_COUNT(sim, splits, 1);
+        
+        half->id = sim->next_block_id++;
+        half->start_address = block->start_address + (1ULL << current_order);
+        half->size = 1ULL << current_order;
+        half->status = FREE;
+        strcpy(half->process_name, "");
+        
+        block->size = half->size;
+        listInsertAfter(block, half);
+        buddyPush(sim, half);
+    }
+    
+    block->status = OCCUPIED;
+    block->requested_size = process_size;
+    strcpy(block->process_name, process_name);
+    nameIndexInsert(sim, block);
+    sim->available_memory -= block->size;
+    sim->internal_waste += block->size - process_size;
+    return SIM_OK;
+}
+
+// Devuelve un bloque al sistema buddyfusionándolo con su buddy mientras esté libre
+void buddyFreeBlock(MemorySimulator* sim, MemoryBlock* block) {
+    int order = buddyOrderOf(block->size);
+    
+    while (order < sim->buddy_max_order) {
+        MemSize buddy_address = block->start_address ^ (1ULL << order);
+        
+        // El buddy debe existir dentro de la memoria y estar libre con el mismo orden
+        if (buddy_address > sim->total_memory - (1ULL << order)) {
+            break;
+        }
+        
+        size_t bit = buddyBit(sim, order, buddy_address);
+        if ((sim->buddy_bitmap[bit >> 6] & (1ULL << (bit & 63))) == 0) {
+            break;
+        }
+        
+        // Un buddy libre del mismo orden es siempre el vecino inmediato
+        MemoryBlock* buddy = (buddy_address < block->start_address) ? block->prev : block->next;
+        buddyUnlink(sim, buddy);
+        
+        // Sobrevive el bloque de menor dirección
+        MemoryBlock* low = (buddy_address < block->start_address) ? buddy : block;
+        MemoryBlock* high = low->next;
+        
+        low->size *= 2;
+        listUnlink(sim, high);
+        blockRelease(sim, high);
+        INSTR_COUNT(sim, coalesces, 1);
+        
+        block = low;
+        order++;
+    }
+    
+    sim->freed_start = block->start_address;
+    sim->freed_size = block->size;
+    buddyPush(sim, block);
+}
+
+// Nombre corto de una unidad de memoria
+const char* memoryUnitName(MemoryUnit unit) {
+    switch (unit) {
+        case UNIT_MB:   return "MB";
+        case UNIT_KB:   return "KB";
+        case UNIT_PAGE: return "pág";
+        case UNIT_BYTE: return "B";
+    }
+    return "?";
+}
+
+// Bytes que representa una unidad de memoria
+uint64_t memoryUnitBytes(MemoryUnit unit) {
+    switch (unit) {
+        case UNIT_MB:   return 1ULL << 20;
+        case UNIT_KB:   return 1ULL << 10;
+        case UNIT_PAGE: return PAGE_SIZE_BYTES;
+        case UNIT_BYTE: return 1;
+    }
+    return 1;
+}
+
+// Interpreta el nombre de una unidad de memoria
+bool parseMemoryUnit(const char* text, MemoryUnit* unit) {
+    if (strcmp(text, "mb") == 0 || strcmp(text, "MB") == 0) {
+        *unit = UNIT_MB;
+    } else if (strcmp(text, "kb") == 0 || strcmp(text, "KB") == 0) {
+        *unit = UNIT_KB;
+    } else if (strcmp(text, "page") == 0 || strcmp(text, "pagina") == 0) {
+        *unit = UNIT_PAGE;
+    } else if (strcmp(text, "byte") == 0 || strcmp(text, "b") == 0 || strcmp(text, "B") == 0) {
+        *unit = UNIT_BYTE;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Interpreta un tamaño: un número en unidades de la simulación, o con sufijo B, K, M, G o T
+// (opcionalmente seguido de B) que se convierte a unidades redondeando hacia arriba
+bool parseMemorySize(const char* text, MemoryUnit unit, MemSize* size) {
+    if (!isdigit((unsigned char) text[0])) {
+        return false;
+    }
+    
+    char* end;
+    errno = 0;
+    unsigned long long value = strtoull(text, &end, 10);
+    
+    if (errno == ERANGE) {
+        return false;
+    }
+    if (*end == '\0') {
+        *size = value;
+        return true;
+    }
+    
+    uint64_t multiplier;
+    switch (toupper((unsigned char) *end)) {
+        case 'B': multiplier = 1;          break;
+        case 'K': multiplier = 1ULL << 10; break;
+        case 'M': multiplier = 1ULL << 20; break;
+        case 'G': multiplier = 1ULL << 30; break;
+        case 'T': multiplier = 1ULL << 40; break;
+        default:  return false;
+    }
+    end++;
+    if (multiplier > 1 && toupper((unsigned char) *end) == 'B') {
+        end++;
+    }
+    if (*end != '\0' || value > UINT64_MAX / multiplier) {
+        return false;
+    }
+    
+    uint64_t bytes = value * multiplier;
+    uint64_t unit_bytes = memoryUnitBytes(unit);
+    *size = bytes / unit_bytes + (bytes % unit_bytes != 0);
+    return true;
+}
+
+// Interpreta una disposición de particiones fijas: entradas separadas por comas o espacios,
+// cada una un tamaño (ver parseMemorySize) que puede ir precedido de "Nx" para repetirlo N
+// veces, como en "4x16M,2x64M,128M". Devuelve en sizes un arreglo nuevo con las particiones
+// en orden, que quien llama libera con free
+bool parsePartitionLayout(const char* text, MemoryUnit unit, MemSize** sizes, size_t* count) {
+    MemSize* result = NULL;
+    size_t used = 0;
+    size_t capacity = 0;
+    bool ok = true;
+    
+    while (ok) {
+        text += strspn(text, ", \t\r\n");
+        if (*text == '\0') {
+            break;
+        }
+        
+        char entry[64];
+        size_t length = strcspn(text, ", \t\r\n");
+        if (length >= sizeof(entry)) {
+            ok = false;
+            break;
+        }
+        memcpy(entry, text, length);
+        entry[length] = '\0';
+        text += length;
+        
+        // Repeticiones opcionales antes de la 'x'
+        unsigned long long repeat = 1;
+        char* size_text = entry;
+        char* times = strpbrk(entry, "xX");
+        
+        if (times != NULL) {
+            char* end;
+            
+            *times = '\0';
+            errno = 0;
+            repeat = strtoull(entry, &end, 10);
+            ok = isdigit((unsigned char) entry[0]) && *end == '\0' && errno != ERANGE && repeat > 0;
+            size_text = times + 1;
+        }
+        
+        MemSize size;
+        if (!ok || !parseMemorySize(size_text, unit, &size) || size == 0 || repeat > (size_t) INT_MAX - used) {
+            ok = false;
+            break;
+        }
+        
+        if (used + repeat > capacity) {
+            size_t new_capacity = (capacity == 0) ? 16 : capacity * 2;
+            if (new_capacity < used + repeat) {
+                new_capacity = used + repeat;
+            }
+            
+            MemSize* grown = (MemSize*) realloc(result, new_capacity * sizeof(MemSize));
+            if (grown == NULL) {
+                ok = false;
+                break;
+            }
+            result = grown;
+            capacity = new_capacity;
+        }
+        
+        for (unsigned long long i = 0; i < repeat; i++) {
+            result[used++] = size;
+        }
+    }
+    
+    if (!ok || used == 0) {
+        free(result);
+        return false;
+    }
+    
+    *sizes = result;
+    *count = used;
+    return true;
+}
+
+// Describe en error (de error_size bytes; puede ser NULL) una inconsistencia encontrada
+// por las validaciones. Siempre devuelve false
+static bool validationError(char* error, size_t error_size, const char* message, const MemoryBlock* block) {
+    if (error == NULL || error_size == 0) {
+        return false;
+    }
+    if (block != NULL) {
+        snprintf(error, error_size, "%s (bloque %llu en la dirección %llu)", message,
+                 (unsigned long long) block->id, (unsigned long long) block->start_address);
+    } else {
+        snprintf(error, error_size, "%s", message);
+    }
+    return false;
+}
+
+// Recorre el mapa completo y verifica que la lista, el índice por nombre y los contadores
+// incrementales describan la misma memoria. Devuelve false en la primera inconsistencia
+// y la describe en error (de error_size bytes; puede ser NULL)
+bool validateSimulator(MemorySimulator* sim, char* error, size_t error_size) {
+    if (sim->partition_type == BITMAP_PARTITIONS) {
+        return bitmapValidate(sim, error, error_size);
+    }
+    
+    MemSize address = 0;
+    MemSize free_memory = 0;
+    MemSize occupied_memory = 0;
+    MemSize internal_waste = 0;
+    uint64_t free_blocks = 0;
+    uint64_t occupied_blocks = 0;
+    uint64_t blocks = 0;
+    MemoryBlock* prev = NULL;
+    bool table = sim->partition_type == DYNAMIC_PARTITIONS && sim->placement == PLACEMENT_FIRST_FIT_SCAN;
+    
+    for (MemoryBlock* block = sim->memory_map; block != NULL; block = block->next) {
+        if (block->prev != prev) {
+            return validationError(error, error_size, "enlace al bloque anterior roto", block);
+        }
+        if (block->start_address != address || block->size == 0 ||
+            block->size > sim->total_memory - block->start_address) {
+            return validationError(error, error_size, "los bloques no son contiguos o exceden la memoria", block);
+        }
+        if (sim->partition_type == BUDDY_PARTITIONS &&
+            ((block->size & (block->size - 1)) != 0 || block->start_address % block->size != 0)) {
+            return validationError(error, error_size, "bloque buddy sin tamaño potencia de dos o desalineado", block);
+        }
+        
+        if (block->status == FREE) {
+            if (sim->partition_type == DYNAMIC_PARTITIONS && prev != NULL && prev->status == FREE) {
+                return validationError(error, error_size, "dos bloques libres adyacentes sin fusionar", block);
+            }
+            // La tabla contigua tiene una fila por bloque libre, en el mismo orden
+            if (table && (free_blocks >= sim->free_table.count || sim->free_table.node[free_blocks] != block ||
+                          sim->free_table.start[free_blocks] != block->start_address ||
+                          sim->free_table.size[free_blocks] != block->size)) {
+                return validationError(error, error_size, "bloque libre ausente o desactualizado en la tabla contigua", block);
+            }
+            free_memory += block->size;
+            free_blocks++;
+        } else {
+            if (block->requested_size == 0 || block->requested_size > block->size) {
+                return validationError(error, error_size, "tamaño solicitado fuera de rango", block);
+            }
+            if (nameIndexFind(sim, block->process_name) != block) {
+                return validationError(error, error_size, "proceso ausente del índice por nombre", block);
+            }
+            occupied_memory += block->size;
+            internal_waste += block->size - block->requested_size;
+            occupied_blocks++;
+        }
+        
+        address += block->size;
+        blocks++;
+        prev = block;
+    }
+    
+    // Lo que queda después del último bloque no cuenta como disponible: el resto sin
+    // particionar en particiones fijas y el resto menor que el bloque mínimo en buddy
+    if (sim->partition_type == DYNAMIC_PARTITIONS && address != sim->total_memory) {
+        return validationError(error, error_size, "los bloques no cubren toda la memoria", NULL);
+    }
+    if (sim->partition_type == FIXED_PARTITIONS && blocks != (uint64_t) sim->num_fixed_partitions) {
+        return validationError(error, error_size, "cantidad de particiones fijas distinta de la configurada", NULL);
+    }
+    if (sim->available_memory != address - occupied_memory || sim->usable_memory != address) {
+        return validationError(error, error_size, "memoria disponible distinta de la suma de los bloques", NULL);
+    }
+    if (sim->free_memory != free_memory || sim->free_block_count != free_blocks) {
+        return validationError(error, error_size, "contadores de memoria libre desactualizados", NULL);
+    }
+    if (table && (sim->free_table.count != free_blocks || sim->free_table.missing > 0)) {
+        return validationError(error, error_size, "la tabla contigua no coincide con los bloques libres", NULL);
+    }
+    if (sim->internal_waste != internal_waste) {
+        return validationError(error, error_size, "contador de fragmentación interna desactualizado", NULL);
+    }
+    if (sim->name_index_count != occupied_blocks) {
+        return validationError(error, error_size, "el índice por nombre no coincide con los bloques ocupados", NULL);
+    }
+    if (sim->pool.live_nodes != blocks) {
+        return validationError(error, error_size, "nodos del pool en uso distintos de los bloques del mapa", NULL);
+    }
+    
+    return true;
+}
+
+// Marca (ocupado) o limpia (libre) un rango de bits, de a una palabra de 64 por paso,
+// y actualiza en el resumen si cada palabra tocada quedó con algún trozo libre
+static void bitmapSetRange(MemorySimulator* sim, size_t start, size_t count, bool occupied) {
+    while (count > 0) {
+        size_t word = start >> 6;
+        size_t offset = start & 63;
+        size_t span = 64 - offset;
+        if (span > count) span = count;
+        
+        uint64_t mask = (span == 64) ? ~0ULL : ((1ULL << span) - 1) << offset;
+        if (occupied) {
+            sim->bitmap[word] |= mask;
+        } else {
+            sim->bitmap[word] &= ~mask;
+        }
+        
+        if (sim->bitmap[word] == ~0ULL) {
+            sim->bitmap_summary[word >> 6] &= ~(1ULL << (word & 63));
+        } else {
+            sim->bitmap_summary[word >> 6] |= 1ULL << (word & 63);
+        }
+        
+        start += span;
+        count -= span;
+    }
+}
+
+// Primera palabra >= word con algún trozo libre (o words si no hay), 64 palabras por paso
+static size_t bitmapNextNonFull(const MemorySimulator* sim, size_t word, size_t words) {
+    size_t index = word >> 6;
+    size_t summary_words = (words + 63) / 64;
+    
+    if (index >= summary_words) {
+        return words;
+    }
+    
+    uint64_t pending = sim->bitmap_summary[index] & (~0ULL << (word & 63));
+    while (pending == 0) {
+        if (++index == summary_words) {
+            return words;
+        }
+        pending = sim->bitmap_summary[index];
+    }
+    
+    return index * 64 + (size_t) __builtin_ctzll(pending);
+}
+
+// Indica si el bit dado está libre
+static bool bitmapIsFree(const MemorySimulator* sim, size_t bit) {
+    return (sim->bitmap[bit >> 6] & (1ULL << (bit & 63))) == 0;
+}
+
+// Largo de la racha libre que contiene a los bits [start, end): se extiende de a una
+// palabra por paso hacia ambos lados hasta el primer trozo ocupado
+size_t bitmapRunAround(const MemorySimulator* sim, size_t start, size_t end) {
+    size_t low = start;
+    while (low > 0) {
+        size_t word = (low - 1) >> 6;
+        size_t top = (low - 1) & 63;
+        uint64_t occupied = sim->bitmap[word] & ((top == 63) ? ~0ULL : (1ULL << (top + 1)) - 1);
+        
+        if (occupied != 0) {
+            low = word * 64 + (size_t) (64 - __builtin_clzll(occupied));
+            break;
+        }
+        low = word * 64;
+    }
+    
+    size_t high = end;
+    while (high < sim->bitmap_bits) {
+        size_t word = high >> 6;
+        uint64_t occupied = sim->bitmap[word] & (~0ULL << (high & 63));
+        
+        if (occupied != 0) {
+            high = word * 64 + (size_t) __builtin_ctzll(occupied);
+            break;
+        }
+        high = (word + 1) * 64;
+    }
+    
+    if (high > sim->bitmap_bits) {
+        high = sim->bitmap_bits;
+    }
+    return high - low;
+}
+
+// Primer bit de la primera racha de count bits libres (first-fit), o SIZE_MAX si no hay.
+// Cada palabra de 64 bits se resuelve en pocas operaciones: las totalmente libres u
+// ocupadas en un paso; en las mixtas, ctz/clz dan los bits libres de los extremos (que
+// continúan rachas entre palabras), popcount descarta las que no tienen count bits libres
+// y una cascada de AND con desplazamientos encuentra rachas internas de hasta 64 bits.
+static size_t bitmapFindRun(MemorySimulator* sim, size_t count) {
+    size_t words = (sim->bitmap_bits + 63) / 64;
+    size_t run = 0;
+    size_t run_start = 0;
+    
+    for (size_t i = bitmapNextNonFull(sim, 0, words); i < words; i++) {
+        uint64_t free_bits = ~sim->bitmap[i];
+        INSTR_VISIT(1);
+        
+        if (free_bits == ~0ULL) {
+            if (run == 0) run_start = i * 64;
+            run += 64;
+            if (run >= count) return run_start;
+            continue;
+        }
+        if (free_bits == 0) {
+            // Saltar de una vez todas las palabras llenas consultando el resumen
+            run = 0;
+            i = bitmapNextNonFull(sim, i, words) - 1;
+            continue;
+        }
+        
+        // La racha que viene de la palabra anterior sigue por los bits libres bajos
+        size_t low_free = (size_t) __builtin_ctzll(~free_bits);
+        if (run > 0 && run + low_free >= count) {
+            return run_start;
+        }
+        
+        // Rachas internas: tras la cascada, el bit k sigue en 1 solo si los bits k..k+count-1
+        // estaban libres (una racha interna de más de 64 bits es imposible)
+        if (count <= 64 && (size_t) __builtin_popcountll(free_bits) >= count) {
+            uint64_t starts = free_bits;
+            size_t length = 1;
+            
+            while (length < count && starts != 0) {
+                size_t shift = (length < count - length) ? length : count - length;
+                starts &= starts >> shift;
+                length += shift;
+            }
+            if (starts != 0) {
+                return i * 64 + (size_t) __builtin_ctzll(starts);
+            }
+        }
+        
+        // Solo los bits libres altos pueden continuar en la palabra siguiente
+        run = (size_t) __builtin_clzll(~free_bits);
+        run_start = i * 64 + 64 - run;
+    }
+    
+    return SIZE_MAX;
+}
+
+// Mayor racha de bits libres, en unidades de memoria (recorre el mapa de a palabras)
+MemSize bitmapLargestRun(MemorySimulator* sim) {
+    size_t words = (sim->bitmap_bits + 63) / 64;
+    size_t best = 0;
+    size_t run = 0;
+    
+    for (size_t i = 0; i < words; i++) {
+        uint64_t free_bits = ~sim->bitmap[i];
+        
+        if (free_bits == ~0ULL) {
+            run += 64;
+            continue;
+        }
+        
+        // La racha que viene de la palabra anterior termina en el primer bit ocupado
+        int position = __builtin_ctzll(~free_bits);
+        run += (size_t) position;
+        if (run > best) best = run;
+        run = 0;
+        
+        while (position < 64 && (free_bits >> position) != 0) {
+            position += __builtin_ctzll(free_bits >> position);
+            int ones = __builtin_ctzll(~(free_bits >> position));
+            position += ones;
+            run = (size_t) ones;
+            if (position < 64) {
+                if (run > best) best = run;
+                run = 0;  // Si llegó al bit 63 la racha sigue en la palabra siguiente
+            }
+        }
+    }
+    
+    if (run > best) best = run;
+    return (MemSize) best * sim->bitmap_chunk;
+}
+
+// Crea el mapa de bits con todos los trozos libres. Con chunk = 0 se usa un trozo de una
+// unidad, agrandado lo necesario para que el mapa no supere BITMAP_MAX_BITS bits.
+bool bitmapSetup(MemorySimulator* sim, MemSize chunk) {
+    if (chunk == 0) {
+        chunk = 1;
+        while (sim->total_memory / chunk > BITMAP_MAX_BITS) {
+            chunk *= 2;
+        }
+    }
+    if (chunk > sim->total_memory) {
+        chunk = sim->total_memory;
+    }
+    
+    size_t bits = (size_t) (sim->total_memory / chunk);
+    size_t words = (bits + 63) / 64;
+    
+    sim->bitmap = (uint64_t*) calloc(words, sizeof(uint64_t));
+    sim->bitmap_summary = (uint64_t*) malloc((words + 63) / 64 * sizeof(uint64_t));
+    if (sim->bitmap == NULL || sim->bitmap_summary == NULL) {
+        return false;
+    }
+    
+    // Al comienzo todas las palabras tienen trozos libres
+    memset(sim->bitmap_summary, 0xFF, (words + 63) / 64 * sizeof(uint64_t));
+    
+    // Los bits sobrantes de la última palabra se marcan ocupados para que nunca se asignen
+    if (bits % 64 != 0) {
+        sim->bitmap[words - 1] = ~0ULL << (bits % 64);
+    }
+    
+    sim->bitmap_bits = bits;
+    sim->bitmap_chunk = chunk;
+    sim->next_block_id = 1;
+    sim->free_memory = (MemSize) bits * chunk;
+    sim->free_block_count = 1;
+    
+    // El resto menor que un trozo no se puede asignar
+    sim->available_memory -= sim->total_memory - sim->free_memory;
+    sim->usable_memory = sim->free_memory;
+    return true;
+}
+
+// Libera el mapa de bits
+void bitmapRelease(MemorySimulator* sim) {
+    free(sim->bitmap);
+    free(sim->bitmap_summary);
+    sim->bitmap = NULL;
+    sim->bitmap_summary = NULL;
+    sim->bitmap_bits = 0;
+    sim->bitmap_chunk = 0;
+}
+
+// Asigna la primera racha de trozos libres que alcance. El proceso recibe un nodo solo
+// para el índice por nombre: los huecos no tienen nodo y la fusión es implícita en los bits.
+SimStatus bitmapAllocate(MemorySimulator* sim, char* process_name, MemSize process_size) {
+    MemSize chunks = process_size / sim->bitmap_chunk + (process_size % sim->bitmap_chunk != 0);
+    size_t start = (chunks <= sim->bitmap_bits) ? bitmapFindRun(sim, (size_t) chunks) : SIZE_MAX;
+    
+    if (start == SIZE_MAX) {
+        INSTR_FAIL(sim, SIM_ERR_FRAGMENTATION);
+        return SIM_ERR_FRAGMENTATION;
+    }
+    
+    MemoryBlock* block = blockAlloc(sim);
+    if (block == NULL) {
+        INSTR_FAIL(sim, SIM_ERR_NO_MEMORY);
+        return SIM_ERR_NO_MEMORY;
+    }
+    
+    // Una racha libre se convierte en hasta dos (lo que queda a cada lado)
+    size_t end = start + (size_t) chunks;
+    bool left_free = start > 0 && bitmapIsFree(sim, start - 1);
+    bool right_free = end < sim->bitmap_bits && bitmapIsFree(sim, end);
+    sim->free_block_count = sim->free_block_count + left_free + right_free - 1;
+    INSTR_COUNT(sim, splits, left_free || right_free);
+    bitmapSetRange(sim, start, (size_t) chunks, true);
+    
+    block->id = sim->next_block_id++;
+    block->start_address = (MemSize) start * sim->bitmap_chunk;
+    block->size = chunks * sim->bitmap_chunk;
+    block->requested_size = process_size;
+    block->status = OCCUPIED;
+    strcpy(block->process_name, process_name);
+    block->next = NULL;
+    block->prev = NULL;
+    nameIndexInsert(sim, block);
+    
+    sim->free_memory -= block->size;
+    sim->available_memory -= block->size;
+    sim->internal_waste += block->size - process_size;
+    return SIM_OK;
+}
+
+// Devuelve los trozos de un proceso al mapa de bits y libera su nodo
+void bitmapFreeBlock(MemorySimulator* sim, MemoryBlock* block) {
+    size_t start = (size_t) (block->start_address / sim->bitmap_chunk);
+    size_t count = (size_t) (block->size / sim->bitmap_chunk);
+    size_t end = start + count;
+    
+    // Al liberar, la racha se une a las rachas libres vecinas
+    bool left_free = start > 0 && bitmapIsFree(sim, start - 1);
+    bool right_free = end < sim->bitmap_bits && bitmapIsFree(sim, end);
+    sim->free_block_count = sim->free_block_count + 1 - left_free - right_free;
+    INSTR_COUNT(sim, coalesces, left_free + right_free);
+    bitmapSetRange(sim, start, count, false);
+    sim->free_memory += block->size;
+    blockRelease(sim, block);
+}
+
+// Orden por dirección de inicio para qsort
+static int compareBlockAddress(const void* a, const void* b) {
+    const MemoryBlock* x = *(const MemoryBlock* const*) a;
+    const MemoryBlock* y = *(const MemoryBlock* const*) b;
+    return (x->start_address > y->start_address) - (x->start_address < y->start_address);
+}
+
+// Procesos cargados en modo mapa de bits, ordenados por dirección (NULL si no hay memoria)
+static MemoryBlock** bitmapSortedBlocks(MemorySimulator* sim) {
+    MemoryBlock** blocks = (MemoryBlock**) malloc((sim->name_index_count + 1) * sizeof(MemoryBlock*));
+    
+    if (blocks == NULL) {
+        return NULL;
+    }
+    
+    size_t count = 0;
+    for (size_t i = 0; i < sim->name_index_capacity; i++) {
+        for (MemoryBlock* block = sim->name_index[i]; block != NULL; block = block->hash_next) {
+            blocks[count++] = block;
+        }
+    }
+    
+    qsort(blocks, count, sizeof(MemoryBlock*), compareBlockAddress);
+    return blocks;
+}
+
+// Arma una lista temporal ordenada por dirección con los procesos y los huecos entre ellos
+// para mostrar el mapa. Los huecos se crean en *gaps, que el llamador debe liberar.
+MemoryBlock* bitmapBuildMap(MemorySimulator* sim, MemoryBlock** gaps) {
+    size_t count = sim->name_index_count;
+    MemoryBlock** blocks = bitmapSortedBlocks(sim);
+    *gaps = (MemoryBlock*) calloc(count + 1, sizeof(MemoryBlock));
+    
+    if (blocks == NULL || *gaps == NULL) {
+        free(blocks);
+        free(*gaps);
+        *gaps = NULL;
+        return NULL;
+    }
+    
+    MemoryBlock* head = NULL;
+    MemoryBlock** link = &head;
+    MemSize address = 0;
+    MemSize end = (MemSize) sim->bitmap_bits * sim->bitmap_chunk;
+    size_t gap_count = 0;
+    
+    for (size_t i = 0; i <= count; i++) {
+        MemSize next_start = (i < count) ? blocks[i]->start_address : end;
+        
+        if (next_start > address) {
+            MemoryBlock* gap = &(*gaps)[gap_count++];
+            gap->start_address = address;
+            gap->size = next_start - address;
+            gap->status = FREE;
+            *link = gap;
+            link = &gap->next;
+        }
+        if (i < count) {
+            *link = blocks[i];
+            link = &blocks[i]->next;
+            address = blocks[i]->start_address + blocks[i]->size;
+        }
+    }
+    
+    *link = NULL;
+    free(blocks);
+    return head;
+}
+
+// Verifica que el mapa de bits, los procesos indexados y los contadores coincidan
+bool bitmapValidate(MemorySimulator* sim, char* error, size_t error_size) {
+    MemoryBlock** blocks = bitmapSortedBlocks(sim);
+    
+    if (blocks == NULL) {
+        return validationError(error, error_size, "sin memoria para validar", NULL);
+    }
+    
+    MemSize occupied_memory = 0;
+    MemSize internal_waste = 0;
+    MemSize previous_end = 0;
+    bool valid = true;
+    
+    for (size_t i = 0; i < sim->name_index_count && valid; i++) {
+        MemoryBlock* block = blocks[i];
+        size_t start = (size_t) (block->start_address / sim->bitmap_chunk);
+        size_t count = (size_t) (block->size / sim->bitmap_chunk);
+        
+        if (block->start_address < previous_end || block->start_address % sim->bitmap_chunk != 0 ||
+            block->size % sim->bitmap_chunk != 0 || start + count > sim->bitmap_bits) {
+            valid = validationError(error, error_size, "proceso solapado o desalineado con el mapa de bits", block);
+        } else if (block->requested_size == 0 || block->requested_size > block->size) {
+            valid = validationError(error, error_size, "tamaño solicitado fuera de rango", block);
+        }
+        for (size_t bit = start; bit < start + count && valid; bit++) {
+            if (bitmapIsFree(sim, bit)) {
+                valid = validationError(error, error_size, "trozo de un proceso marcado como libre", block);
+            }
+        }
+        
+        previous_end = block->start_address + block->size;
+        occupied_memory += block->size;
+        internal_waste += block->size - block->requested_size;
+    }
+    free(blocks);
+    
+    if (!valid) {
+        return false;
+    }
+    
+    // Contar bits ocupados y rachas libres
+    size_t occupied_bits = 0;
+    uint64_t free_runs = 0;
+    for (size_t bit = 0; bit < sim->bitmap_bits; bit++) {
+        if (!bitmapIsFree(sim, bit)) {
+            occupied_bits++;
+        } else if (bit == 0 || !bitmapIsFree(sim, bit - 1)) {
+            free_runs++;
+        }
+    }
+    
+    MemSize usable = (MemSize) sim->bitmap_bits * sim->bitmap_chunk;
+    
+    if ((MemSize) occupied_bits * sim->bitmap_chunk != occupied_memory) {
+        return validationError(error, error_size, "bits ocupados que no pertenecen a ningún proceso", NULL);
+    }
+    if (sim->free_memory != usable - occupied_memory || sim->free_block_count != free_runs) {
+        return validationError(error, error_size, "contadores de memoria libre desactualizados", NULL);
+    }
+    if (sim->available_memory != usable - occupied_memory || sim->usable_memory != usable) {
+        return validationError(error, error_size, "memoria disponible distinta de la suma de los bloques", NULL);
+    }
+    if (sim->internal_waste != internal_waste) {
+        return validationError(error, error_size, "contador de fragmentación interna desactualizado", NULL);
+    }
+    if (sim->pool.live_nodes != sim->name_index_count) {
+        return validationError(error, error_size, "nodos del pool en uso distintos de los procesos cargados", NULL);
+    }
+    
+    return true;
+}
+
+// Suma de verificación de una secuencia de palabras (FNV-1a de a 64 bits)
+static uint64_t snapshotChecksum(uint64_t hash, const void* data, size_t bytes) {
+    const uint64_t* words = (const uint64_t*) data;
+    
+    for (size_t i = 0; i < bytes / sizeof(uint64_t); i++) {
+        hash = (hash ^ words[i]) * 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+// Escribe un lote de palabras acumulando la suma de verificación
+static bool snapshotWrite(FILE* file, const void* data, size_t bytes, uint64_t* checksum) {
+    *checksum = snapshotChecksum(*checksum, data, bytes);
+    return fwrite(data, 1, bytes, file) == bytes;
+}
+
+// Guarda el estado del simulador en un archivo binario: encabezado, bloques en orden de
+// dirección y, en modo buddy o segregated, las direcciones de los bloques libres en el
+// orden de sus listas (de eso depende qué bloque se elige después). Se escribe en
+// "<path>.tmp" y se renombra al final, así un checkpoint nunca queda a medio escribir
+SimStatus saveSnapshot(MemorySimulator* sim, const char* path, uint64_t trace_line) {
+    SnapshotHeader header;
+    MemoryBlock** sorted = NULL;
+    char* temp_path = (char*) malloc(strlen(path) + 5);
+    
+    if (temp_path == NULL) {
+        return SIM_ERR_NO_MEMORY;
+    }
+    sprintf(temp_path, "%s.tmp", path);
+    FILE* file = fopen(temp_path, "wb");
+    SnapshotBlock* batch = (SnapshotBlock*) malloc(SNAPSHOT_WRITE_BATCH * sizeof(SnapshotBlock));
+    
+    // En modo mapa de bits los procesos no forman una lista: se ordenan por dirección
+    if (sim->partition_type == BITMAP_PARTITIONS) {
+        sorted = bitmapSortedBlocks(sim);
+    }
+    if (file == NULL || batch == NULL || (sim->partition_type == BITMAP_PARTITIONS && sorted == NULL)) {
+        SimStatus status = (file == NULL) ? SIM_ERR_IO : SIM_ERR_NO_MEMORY;
+        if (file != NULL) {
+            fclose(file);
+            remove(temp_path);
+        }
+        free(temp_path);
+        free(batch);
+        free(sorted);
+        return status;
+    }
+    
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.byte_order = SNAPSHOT_BYTE_ORDER;
+    header.header_size = sizeof(SnapshotHeader);
+    header.trace_line = trace_line;
+    header.total_memory = sim->total_memory;
+    header.available_memory = sim->available_memory;
+    header.fixed_partition_size = sim->fixed_partition_size;
+    header.next_fit_cursor = sim->next_fit_cursor;
+    header.compaction_moved = sim->compaction_moved;
+    header.bitmap_chunk = sim->bitmap_chunk;
+    header.internal_waste = sim->internal_waste;
+    header.compaction_blocks_moved = sim->compaction_blocks_moved;
+    header.next_block_id = sim->next_block_id;
+    header.tree_seed = sim->tree_seed;
+    header.unit = (uint32_t) sim->unit;
+    header.partition_type = (uint32_t) sim->partition_type;
+    header.placement = (uint32_t) sim->placement;
+    header.num_fixed_partitions = sim->num_fixed_partitions;
+    
+    // El encabezado se reescribe al final, con las cantidades y la suma de verificación
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    uint64_t checksum = 0xCBF29CE484222325ULL;
+    size_t pending = 0;
+    size_t sorted_index = 0;
+    MemoryBlock* block = (sorted != NULL) ? (sim->name_index_count > 0 ? sorted[0] : NULL) : sim->memory_map;
+    
+    while (ok && block != NULL) {
+        SnapshotBlock* record = &batch[pending++];
+        
+        memset(record, 0, sizeof(SnapshotBlock));  // Relleno determinista para la suma
+        record->id = block->id;
+        record->start_address = block->start_address;
+        record->size = block->size;
+        record->requested_size = (block->status == OCCUPIED) ? block->requested_size : 0;
+        record->status = (uint32_t) block->status;
+        if (block->status == OCCUPIED) {
+            strcpy(record->process_name, block->process_name);
+        }
+        header.block_count++;
+        
+        if (pending == SNAPSHOT_WRITE_BATCH) {
+            ok = snapshotWrite(file, batch, pending * sizeof(SnapshotBlock), &checksum);
+            pending = 0;
+        }
+        
+        if (sorted != NULL) {
+            block = (++sorted_index < sim->name_index_count) ? sorted[sorted_index] : NULL;
+        } else {
+            block = block->next;
+        }
+    }
+    if (ok && pending > 0) {
+        ok = snapshotWrite(file, batch, pending * sizeof(SnapshotBlock), &checksum);
+    }
+    
+    // Orden de las listas libres: se reutiliza el lote como arreglo de direcciones
+    MemSize* addresses = (MemSize*) batch;
+    size_t address_capacity = SNAPSHOT_WRITE_BATCH * sizeof(SnapshotBlock) / sizeof(MemSize);
+    size_t list_count = 0;
+    MemoryBlock** lists = NULL;
+    
+    if (sim->partition_type == BUDDY_PARTITIONS) {
+        lists = sim->buddy_free;
+        list_count = BUDDY_MAX_ORDERS;
+    } else if (sim->partition_type == FIXED_PARTITIONS) {
+        lists = sim->partitions.stacks;
+        list_count = sim->partitions.count;
+    } else if (sim->partition_type != BITMAP_PARTITIONS && sim->placement == PLACEMENT_SEGREGATED_FIT) {
+        lists = &sim->bins.heads[0][0];
+        list_count = TLSF_FL_COUNT * TLSF_SL_COUNT;
+    }
+    
+    pending = 0;
+    for (size_t list = 0; ok && list < list_count; list++) {
+        for (MemoryBlock* node = lists[list]; ok && node != NULL; node = node->free_next) {
+            addresses[pending++] = node->start_address;
+            header.free_list_count++;
+            
+            if (pending == address_capacity) {
+                ok = snapshotWrite(file, addresses, pending * sizeof(MemSize), &checksum);
+                pending = 0;
+            }
+        }
+    }
+    if (ok && pending > 0) {
+        ok = snapshotWrite(file, addresses, pending * sizeof(MemSize), &checksum);
+    }
+    
+    header.checksum = checksum;
+    ok = ok && fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = (fclose(file) == 0) && ok;
+    ok = ok && rename(temp_path, path) == 0;
+    
+    if (!ok) {
+        remove(temp_path);
+    }
+    
+    free(temp_path);
+    free(batch);
+    free(sorted);
+    return ok ? SIM_OK : SIM_ERR_IO;
+}
+
+// Verifica un registro antes de usarlo para reconstruir el estado: los datos vienen de
+// un archivo y no deben poder romper las estructuras
+static bool snapshotBlockValid(const MemorySimulator* sim, const SnapshotBlock* record, MemSize expected_start) {
+    if (record->status > OCCUPIED || record->size == 0 || record->start_address > sim->total_memory ||
+        record->size > sim->total_memory - record->start_address) {
+        return false;
+    }
+    if (record->status == OCCUPIED &&
+        (record->requested_size == 0 || record->requested_size > record->size ||
+         record->process_name[0] == '\0' || memchr(record->process_name, '\0', MAX_PROCESS_NAME) == NULL)) {
+        return false;
+    }
+    
+    if (sim->partition_type == BITMAP_PARTITIONS) {
+        // Solo procesos, alineados a trozos, en orden y sin solaparse
+        return record->status == OCCUPIED && record->start_address >= expected_start &&
+               record->start_address % sim->bitmap_chunk == 0 && record->size % sim->bitmap_chunk == 0 &&
+               record->start_address + record->size <= (MemSize) sim->bitmap_bits * sim->bitmap_chunk;
+    }
+    if (record->start_address != expected_start) {
+        return false;
+    }
+    if (sim->partition_type == BUDDY_PARTITIONS) {
+        return (record->size & (record->size - 1)) == 0 && record->start_address % record->size == 0 &&
+               record->size >= (1ULL << sim->buddy_min_order);
+    }
+    return true;
+}
+
+// Registro cuyo bloque comienza en la dirección dada (búsqueda binaria; count si no hay)
+static size_t snapshotFindBlock(const SnapshotBlock* records, size_t count, MemSize address) {
+    size_t low = 0, high = count;
+    
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (records[middle].start_address < address) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return (low < count && records[low].start_address == address) ? low : count;
+}
+
+// Restaura un simulador desde un snapshot. El archivo se mapea en memoria y los nodos
+// salen de un único trozo del pool, así que el costo es proporcional al tamaño del
+// archivo. Devuelve NULL y deja el motivo en *status si el archivo no es válido
+MemorySimulator* loadSnapshot(const char* path, uint64_t* trace_line, SimStatus* status) {
+    int fd = open(path, O_RDONLY);
+    struct stat info;
+    
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        if (fd >= 0) close(fd);
+        *status = SIM_ERR_IO;
+        return NULL;
+    }
+    if ((size_t) info.st_size < sizeof(SnapshotHeader)) {
+        close(fd);
+        *status = SIM_ERR_BAD_SNAPSHOT;
+        return NULL;
+    }
+    
+    size_t length = (size_t) info.st_size;
+    void* data = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        *status = SIM_ERR_IO;
+        return NULL;
+    }
+    madvise(data, length, MADV_SEQUENTIAL);
+    
+    const SnapshotHeader* header = (const SnapshotHeader*) data;
+    const SnapshotBlock* records = (const SnapshotBlock*) ((const char*) data + sizeof(SnapshotHeader));
+    uint64_t payload = length - sizeof(SnapshotHeader);
+    
+    // Firma, orden de bytes, versión, tamaño, suma de verificación y configuración
+    bool valid = memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) == 0 &&
+                 header->byte_order == SNAPSHOT_BYTE_ORDER && header->version == SNAPSHOT_VERSION &&
+                 header->header_size == sizeof(SnapshotHeader);
+    if (valid && (header->block_count > payload / sizeof(SnapshotBlock) ||
+                  header->free_list_count > header->block_count ||
+                  payload != header->block_count * sizeof(SnapshotBlock) + header->free_list_count * sizeof(MemSize))) {
+        valid = false;
+    } else if (valid && snapshotChecksum(0xCBF29CE484222325ULL, records, (size_t) payload) != header->checksum) {
+        valid = false;
+    } else if (valid && (header->total_memory == 0 || header->unit > UNIT_BYTE ||
+               header->partition_type > BITMAP_PARTITIONS || header->placement > PLACEMENT_FIRST_FIT_SCAN ||
+               (header->partition_type == FIXED_PARTITIONS && header->num_fixed_partitions <= 0) ||
+               (header->partition_type == BITMAP_PARTITIONS &&
+                (header->bitmap_chunk == 0 || header->bitmap_chunk > header->total_memory ||
+                 header->total_memory / header->bitmap_chunk > BITMAP_MAX_BITS)))) {
+        valid = false;
+    }
+    
+    if (!valid) {
+        munmap(data, length);
+        *status = SIM_ERR_BAD_SNAPSHOT;
+        return NULL;
+    }
+    
+    // Partir de un simulador vacío con la misma memoria y descartar su bloque inicial
+    size_t count = (size_t) header->block_count;
+    size_t free_list_count = (size_t) header->free_list_count;
+    const MemSize* free_order = (const MemSize*) (records + count);
+    MemorySimulator* sim = initSimulator(header->total_memory, (MemoryUnit) header->unit);
+    MemoryBlock** nodes = (MemoryBlock**) calloc(count + 1, sizeof(MemoryBlock*));
+    size_t capacity = NAME_INDEX_INITIAL_CAPACITY;
+    
+    while (capacity - capacity / 4 < count) {
+        capacity *= 2;
+    }
+    
+    if (sim == NULL) {
+        munmap(data, length);
+        free(nodes);
+        *status = SIM_ERR_NO_MEMORY;
+        return NULL;
+    }
+    sim->memory_map = NULL;
+    blockPoolReset(sim);
+    free(sim->name_index);
+    sim->name_index = NULL;
+    sim->partition_type = (PartitionType) header->partition_type;
+    sim->placement = (PlacementPolicy) header->placement;
+    sim->num_fixed_partitions = header->num_fixed_partitions;
+    sim->fixed_partition_size = header->fixed_partition_size;
+    
+    bool ok = nodes != NULL && nameIndexInit(sim, capacity) && blockPoolReserve(sim, count);
+    if (ok && sim->partition_type == BUDDY_PARTITIONS) {
+        ok = buddyInitTables(sim);
+    } else if (ok && sim->partition_type == BITMAP_PARTITIONS) {
+        ok = bitmapSetup(sim, header->bitmap_chunk);
+        sim->free_block_count = 0;
+    }
+    if (!ok) {
+        munmap(data, length);
+        free(nodes);
+        freeSimulator(sim);
+        *status = SIM_ERR_NO_MEMORY;
+        return NULL;
+    }
+    
+    MemoryBlock* prev_block = NULL;
+    MemSize address = 0;
+    size_t free_records = 0;
+    
+    for (size_t i = 0; i < count && ok; i++) {
+        const SnapshotBlock* record = &records[i];
+        
+        if (!snapshotBlockValid(sim, record, address)) {
+            ok = false;
+            break;
+        }
+        
+        MemoryBlock* block = blockAlloc(sim);  // Nunca falla: el trozo ya está reservado
+        block->id = record->id;
+        block->start_address = record->start_address;
+        block->size = record->size;
+        block->requested_size = record->requested_size;
+        block->status = (BlockStatus) record->status;
+        memcpy(block->process_name, record->process_name, MAX_PROCESS_NAME);
+        block->next = NULL;
+        block->prev = NULL;
+        block->free_next = NULL;  // Marca "todavía no está en una lista libre"
+        nodes[i] = block;
+        
+        if (block->status == OCCUPIED) {
+            nameIndexInsert(sim, block);
+        } else {
+            free_records++;
+        }
+        
+        if (sim->partition_type == BITMAP_PARTITIONS) {
+            // Cada hueco entre procesos es una racha libre
+            if (block->start_address > address) {
+                sim->free_block_count++;
+            }
+            bitmapSetRange(sim, (size_t) (block->start_address / sim->bitmap_chunk),
+                           (size_t) (block->size / sim->bitmap_chunk), true);
+            sim->free_memory -= block->size;
+        } else {
+            block->prev = prev_block;
+            if (prev_block == NULL) {
+                sim->memory_map = block;
+            } else {
+                prev_block->next = block;
+            }
+            prev_block = block;
+        }
+        address = block->start_address + block->size;
+    }
+    
+    if (ok && sim->partition_type == BITMAP_PARTITIONS &&
+        address < (MemSize) sim->bitmap_bits * sim->bitmap_chunk) {
+        sim->free_block_count++;  // Racha libre final
+    }
+    
+    // Listas libres: con orden guardado se insertan del último al primero (cada inserción
+    // va a la cabeza, así cada lista queda como estaba); si no, se reconstruye por dirección
+    bool ordered_lists = sim->partition_type == BUDDY_PARTITIONS ||
+                         (sim->partition_type == FIXED_PARTITIONS && free_list_count > 0) ||
+                         (sim->partition_type == DYNAMIC_PARTITIONS && sim->placement == PLACEMENT_SEGREGATED_FIT);
+    if (ok && ordered_lists) {
+        ok = free_list_count == free_records;
+        if (sim->partition_type != BUDDY_PARTITIONS) {
+            // Índice vacío; los bloques se agregan abajo en el orden guardado
+            memset(&sim->bins, 0, sizeof(SegregatedBins));
+            sim->free_tree = NULL;
+            sim->free_memory = 0;
+            sim->free_block_count = 0;
+        }
+        if (ok && sim->partition_type == FIXED_PARTITIONS) {
+            ok = partitionIndexBuild(sim);
+        }
+        
+        for (size_t i = free_list_count; ok && i-- > 0;) {
+            size_t index = snapshotFindBlock(records, count, free_order[i]);
+            MemoryBlock* block = (index < count) ? nodes[index] : NULL;
+            
+            // Cada bloque libre debe aparecer una sola vez: un bloque ya insertado tiene
+            // free_next distinto de NULL (el último de su lista se marca apuntándose a sí mismo)
+            if (block == NULL || block->status != FREE || block->free_next != NULL) {
+                ok = false;
+                break;
+            }
+            
+            if (sim->partition_type == BUDDY_PARTITIONS) {
+                buddyPush(sim, block);
+            } else {
+                freeIndexInsert(sim, block);
+            }
+            if (block->free_next == NULL) {
+                block->free_next = block;
+            }
+        }
+        
+        // Quitar las marcas de los últimos de cada lista
+        for (size_t i = 0; i < count && nodes[i] != NULL; i++) {
+            if (nodes[i]->free_next == nodes[i]) {
+                nodes[i]->free_next = NULL;
+            }
+        }
+    } else if (ok) {
+        ok = free_list_count == 0 && freeIndexRebuild(sim);
+    }
+    
+    // Contadores guardados (la semilla del treap después de reconstruirlo, para que las
+    // próximas prioridades sean las mismas que sin el snapshot)
+    sim->available_memory = header->available_memory;
+    if (sim->partition_type != BITMAP_PARTITIONS) {
+        sim->usable_memory = address;  // Fin del último bloque (el mapa de bits ya lo fijó)
+    }
+    sim->next_fit_cursor = header->next_fit_cursor;
+    sim->compaction_moved = header->compaction_moved;
+    sim->compaction_blocks_moved = header->compaction_blocks_moved;
+    sim->internal_waste = header->internal_waste;
+    sim->next_block_id = header->next_block_id;
+    sim->tree_seed = header->tree_seed;
+    if (trace_line != NULL) {
+        *trace_line = header->trace_line;
+    }
+    munmap(data, length);
+    free(nodes);
+    
+    if (!ok || !validateSimulator(sim, NULL, 0)) {
+        freeSimulator(sim);
+        *status = SIM_ERR_BAD_SNAPSHOT;
+        return NULL;
+    }
+    
+    *status = SIM_OK;
+    return sim;
+}
+
+// Crea el simulador concurrente repartiendo la memoria en arenas de igual tamaño
+// (la última se queda con el resto). Devuelve NULL si falta memoria.
+ConcurrentSimulator* concurrentInit(MemSize memory_size, MemoryUnit unit, int arena_count, PlacementPolicy placement) {
+    if (arena_count <= 0 || memory_size < (MemSize) arena_count) {
+        return NULL;
+    }
+    
+    ConcurrentSimulator* cs = (ConcurrentSimulator*) malloc(sizeof(ConcurrentSimulator));
+    if (cs == NULL) {
+        return NULL;
+    }
+    
+    cs->arenas = (Arena*) calloc((size_t) arena_count, sizeof(Arena));
+    if (cs->arenas == NULL) {
+        free(cs);
+        return NULL;
+    }
+    
+    cs->arena_count = arena_count;
+    cs->total_memory = memory_size;
+    cs->unit = unit;
+    
+    MemSize arena_size = memory_size / (MemSize) arena_count;
+    for (int i = 0; i < arena_count; i++) {
+        Arena* arena = &cs->arenas[i];
+        MemSize size = (i == arena_count - 1) ? memory_size - arena_size * (MemSize) i : arena_size;
+        
+        arena->base = arena_size * (MemSize) i;
+        arena->sim = initSimulator(size, unit);
+        if (arena->sim == NULL || setPlacementPolicy(arena->sim, placement) != SIM_OK) {
+            // Solo las arenas anteriores quedaron completas
+            if (arena->sim != NULL) freeSimulator(arena->sim);
+            cs->arena_count = i;
+            concurrentFree(cs);
+            return NULL;
+        }
+        pthread_mutex_init(&arena->lock, NULL);
+    }
+    
+    return cs;
+}
+
+// Toma el lock de una arena contando si tuvo que esperar a otro hilo
+static void arenaLock(Arena* arena) {
+    bool contended = pthread_mutex_trylock(&arena->lock) != 0;
+    
+    if (contended) {
+        pthread_mutex_lock(&arena->lock);
+        arena->contended++;
+    }
+    arena->acquisitions++;
+}
+
+// Asigna un proceso empezando por la arena hogar y siguiendo por las demás en orden.
+// Devuelve la arena donde quedó (hace falta para liberarlo) o -1 si no cupo en ninguna.
+// Los nombres solo se verifican dentro de cada arena: deben ser únicos por hilo.
+int concurrentAllocate(ConcurrentSimulator* cs, int home, char* process_name, MemSize process_size) {
+    for (int attempt = 0; attempt < cs->arena_count; attempt++) {
+        int index = (home + attempt) % cs->arena_count;
+        Arena* arena = &cs->arenas[index];
+        
+        arenaLock(arena);
+        bool ok = allocateProcess(arena->sim, process_name, process_size) == SIM_OK;
+        pthread_mutex_unlock(&arena->lock);
+        
+        if (ok) {
+            return index;
+        }
+    }
+    
+    return -1;
+}
+
+// Libera un proceso de la arena indicada (o buscándolo en todas si arena es negativa)
+bool concurrentDeallocate(ConcurrentSimulator* cs, int arena, char* process_name) {
+    int first = (arena >= 0) ? arena : 0;
+    int last = (arena >= 0) ? arena : cs->arena_count - 1;
+    
+    for (int i = first; i <= last; i++) {
+        arenaLock(&cs->arenas[i]);
+        bool ok = deallocateProcess(cs->arenas[i].sim, process_name) == SIM_OK;
+        pthread_mutex_unlock(&cs->arenas[i].lock);
+        
+        if (ok) {
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+// Valida cada arena por separado y que juntas cubran toda la memoria sin solaparse; la
+// inconsistencia queda en error como en validateSimulator, con la arena donde ocurrió.
+// Debe llamarse sin hilos trabajando (toma igualmente cada lock).
+bool concurrentValidate(ConcurrentSimulator* cs, char* error, size_t error_size) {
+    MemSize expected_base = 0;
+    bool valid = true;
+    
+    for (int i = 0; i < cs->arena_count && valid; i++) {
+        Arena* arena = &cs->arenas[i];
+        
+        pthread_mutex_lock(&arena->lock);
+        if (arena->base != expected_base) {
+            valid = validationError(error, error_size, "las arenas no son contiguas", NULL);
+        } else {
+            char problem[SIM_ERROR_TEXT];
+            
+            valid = validateSimulator(arena->sim, problem, sizeof(problem));
+            if (!valid && error != NULL && error_size > 0) {
+                snprintf(error, error_size, "%s (en la arena %d)", problem, i);
+            }
+        }
+        expected_base = arena->base + arena->sim->total_memory;
+        pthread_mutex_unlock(&arena->lock);
+    }
+    
+    if (valid && expected_base != cs->total_memory) {
+        valid = validationError(error, error_size, "las arenas no cubren toda la memoria", NULL);
+    }
+    return valid;
+}
+
+// Libera las arenas y el simulador concurrente
+void concurrentFree(ConcurrentSimulator* cs) {
+    for (int i = 0; i < cs->arena_count; i++) {
+        pthread_mutex_destroy(&cs->arenas[i].lock);
+        freeSimulator(cs->arenas[i].sim);
+    }
+    free(cs->arenas);
+    free(cs);
+}
+
+// Crea una cola de admisión vacía. Devuelve NULL si falta memoria
+AdmissionQueue* admissionQueueCreate(QueueDiscipline discipline) {
+    AdmissionQueue* queue = (AdmissionQueue*) calloc(1, sizeof(AdmissionQueue));
+    
+    if (queue != NULL) {
+        queue->discipline = discipline;
+    }
+    return queue;
+}
+
+// Interpreta el nombre de una disciplina de la cola de admisión
+bool parseQueueDiscipline(const char* text, QueueDiscipline* discipline) {
+    if (strcmp(text, "fifo") == 0) {
+        *discipline = QUEUE_FIFO;
+    } else if (strcmp(text, "smallest") == 0 || strcmp(text, "smallest-first") == 0) {
+        *discipline = QUEUE_SMALLEST_FIRST;
+    } else if (strcmp(text, "priority") == 0) {
+        *discipline = QUEUE_PRIORITY;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Nombre corto de una disciplina de la cola de admisión
+const char* queueDisciplineName(QueueDiscipline discipline) {
+    switch (discipline) {
+        case QUEUE_FIFO: return "fifo";
+        case QUEUE_SMALLEST_FIRST: return "smallest";
+        case QUEUE_PRIORITY: return "priority";
+    }
+    return "?";
+}
+
+// Indica si la solicitud a se admite antes que b según la disciplina
+static bool requestBefore(QueueDiscipline discipline, const QueuedRequest* a, const QueuedRequest* b) {
+    if (discipline == QUEUE_SMALLEST_FIRST && a->size != b->size) {
+        return a->size < b->size;
+    }
+    if (discipline == QUEUE_PRIORITY && a->priority != b->priority) {
+        return a->priority > b->priority;
+    }
+    return a->sequence < b->sequence;
+}
+
+// Agrega una solicitud al heap de su clase. Devuelve false si no hay memoria
+static bool requestHeapPush(RequestHeap* heap, QueueDiscipline discipline, const QueuedRequest* request) {
+    if (heap->count == heap->capacity) {
+        size_t capacity = heap->capacity == 0 ? REQUEST_HEAP_INITIAL_CAPACITY : heap->capacity * 2;
+        QueuedRequest* entries = (QueuedRequest*) realloc(heap->entries, capacity * sizeof(QueuedRequest));
+        
+        if (entries == NULL) {
+            return false;
+        }
+        heap->entries = entries;
+        heap->capacity = capacity;
+    }
+    
+    // Subir el hueco hasta la posición de la nueva solicitud
+    size_t i = heap->count++;
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (!requestBefore(discipline, request, &heap->entries[parent])) {
+            break;
+        }
+        heap->entries[i] = heap->entries[parent];
+        i = parent;
+    }
+    heap->entries[i] = *request;
+    return true;
+}
+
+// Quita y devuelve la solicitud de la posición index: la última ocupa su lugar y se
+// reubica hacia arriba o hacia abajo
+static QueuedRequest requestHeapRemove(RequestHeap* heap, QueueDiscipline discipline, size_t index) {
+    QueuedRequest removed = heap->entries[index];
+    QueuedRequest last = heap->entries[--heap->count];
+    size_t i = index;
+    
+    if (i == heap->count) {
+        return removed;
+    }
+    
+    while (i > 0 && requestBefore(discipline, &last, &heap->entries[(i - 1) / 2])) {
+        heap->entries[i] = heap->entries[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= heap->count) {
+            break;
+        }
+        if (child + 1 < heap->count && requestBefore(discipline, &heap->entries[child + 1], &heap->entries[child])) {
+            child++;
+        }
+        if (!requestBefore(discipline, &heap->entries[child], &last)) {
+            break;
+        }
+        heap->entries[i] = heap->entries[child];
+        i = child;
+    }
+    heap->entries[i] = last;
+    
+    return removed;
+}
+
+// Mayor bloque que el modo actual puede dar con toda la memoria libre: una solicitud
+// más grande no se admitiría nunca
+static MemSize largestPossibleBlock(const MemorySimulator* sim) {
+    switch (sim->partition_type) {
+        case FIXED_PARTITIONS: return sim->fixed_partition_size;
+        case BUDDY_PARTITIONS: return 1ULL << sim->buddy_max_order;
+        case BITMAP_PARTITIONS: return (MemSize) sim->bitmap_bits * sim->bitmap_chunk;
+        case DYNAMIC_PARTITIONS: break;
+    }
+    return sim->memory_map == NULL ? 0 : sim->total_memory;
+}
+
+// Agrega a la cola una solicitud que no cupo al llegar. Las que no cabrían ni con toda
+// la memoria libre se rechazan con SIM_ERR_NO_SPACE en lugar de esperar para siempre
+SimStatus admissionQueuePush(AdmissionQueue* queue, MemorySimulator* sim, const QueuedRequest* request) {
+    if (request->size == 0) {
+        return SIM_ERR_INVALID_SIZE;
+    }
+    if (request->size > largestPossibleBlock(sim)) {
+        return SIM_ERR_NO_SPACE;
+    }
+    
+    QueuedRequest entry = *request;
+    entry.sequence = queue->next_sequence;
+    
+    int fl, sl;
+    tlsfMapping(entry.size, &fl, &sl);
+    if (!requestHeapPush(&queue->classes[fl][sl], queue->discipline, &entry)) {
+        return SIM_ERR_NO_MEMORY;
+    }
+    
+    queue->fl_bitmap |= 1ULL << fl;
+    queue->sl_bitmap[fl] |= 1U << sl;
+    queue->next_sequence++;
+    queue->enqueued++;
+    if (++queue->count > queue->max_count) {
+        queue->max_count = queue->count;
+    }
+    return SIM_OK;
+}
+
+// Mejor solicitud (según la disciplina) de tamaño <= hole (hole > 0). Las clases menores
+// que la de hole caben enteras y basta con mirar la raíz de su heap; en la clase de hole
+// se revisan sus solicitudes una por una. Devuelve false si ninguna cabe
+static bool admissionQueueBest(AdmissionQueue* queue, MemSize hole, int* best_fl, int* best_sl, size_t* best_index) {
+    int hole_fl, hole_sl;
+    tlsfMapping(hole, &hole_fl, &hole_sl);
+    const QueuedRequest* best = NULL;
+    
+    uint64_t fl_map = queue->fl_bitmap & ((1ULL << (hole_fl + 1)) - 1);
+    while (fl_map != 0) {
+        int fl = __builtin_ctzll(fl_map);
+        fl_map &= fl_map - 1;
+        
+        uint32_t sl_map = queue->sl_bitmap[fl];
+        if (fl == hole_fl) {
+            sl_map &= (1U << (hole_sl + 1)) - 1;
+        }
+        
+        while (sl_map != 0) {
+            int sl = __builtin_ctz(sl_map);
+            sl_map &= sl_map - 1;
+            RequestHeap* heap = &queue->classes[fl][sl];
+            
+            // Con smallest-first la raíz es la menor de la clase también en la clase de hole
+            bool boundary = fl == hole_fl && sl == hole_sl;
+            size_t scan = (boundary && queue->discipline != QUEUE_SMALLEST_FIRST) ? heap->count : 1;
+            
+            for (size_t i = 0; i < scan; i++) {
+                const QueuedRequest* request = &heap->entries[i];
+                queue->examined++;
+                
+                if (request->size <= hole && (best == NULL || requestBefore(queue->discipline, request, best))) {
+                    best = request;
+                    *best_fl = fl;
+                    *best_sl = sl;
+                    *best_index = i;
+                }
+            }
+            
+            // La primera clase no vacía tiene la menor solicitud de toda la cola
+            if (queue->discipline == QUEUE_SMALLEST_FIRST) {
+                return best != NULL;
+            }
+        }
+    }
+    
+    return best != NULL;
+}
+
+// Mayor trozo que queda libre del hueco después de asignar en él el bloque dado
+static MemSize holeRemainder(MemorySimulator* sim, MemSize hole, MemSize block_size) {
+    if (sim->partition_type == BUDDY_PARTITIONS) {
+        // Al dividir quedan libres mitades, cuartos, etc. del hueco y el buddy asigna el
+        // menor bloque que alcanza: el mayor trozo que sobrevive sale de la máscara de órdenes
+        MemSize largest = largestFreeBlock(sim);
+        return largest < hole ? largest : hole;
+    }
+    if (block_size >= hole || sim->partition_type == FIXED_PARTITIONS) {
+        return 0;
+    }
+    return hole - block_size;
+}
+
+// Admite la solicitud en espera que corresponde según la disciplina entre las que caben
+// en un hueco recién liberado o compactado de *hole unidades, y descuenta de *hole lo que
+// ocupó. Devuelve false cuando ninguna cabe; quien llama la repite hasta entonces. Solo
+// se miran las clases de tamaño que caben en el hueco: las solicitudes en espera no
+// cabían en los huecos que ya existían, así que solo el nuevo puede admitirlas
+bool admissionQueueAdmit(AdmissionQueue* queue, MemorySimulator* sim, MemSize* hole, uint64_t now,
+                         QueuedRequest* admitted) {
+    int fl = 0, sl = 0;
+    size_t index = 0;
+    
+    while (queue->count > 0 && *hole > 0 && admissionQueueBest(queue, *hole, &fl, &sl, &index)) {
+        RequestHeap* heap = &queue->classes[fl][sl];
+        QueuedRequest request = requestHeapRemove(heap, queue->discipline, index);
+        
+        if (heap->count == 0) {
+            queue->sl_bitmap[fl] &= ~(1U << sl);
+            if (queue->sl_bitmap[fl] == 0) {
+                queue->fl_bitmap &= ~(1ULL << fl);
+            }
+        }
+        queue->count--;
+        
+        SimStatus status = allocateProcess(sim, request.process_name, request.size);
+        
+        if (status == SIM_OK) {
+            MemoryBlock* block = nameIndexFind(sim, request.process_name);
+            *hole = holeRemainder(sim, *hole, block->size);
+            queue->admitted++;
+            latencyRecord(&queue->wait, now - request.enqueued_at);
+            *admitted = request;
+            return true;
+        }
+        
+        if (status == SIM_ERR_NO_SPACE || status == SIM_ERR_FRAGMENTATION) {
+            // El hueco era menor de lo indicado: la solicitud vuelve a esperar (su lugar en
+            // el heap no cambia) y solo se prueban las más pequeñas
+            requestHeapPush(heap, queue->discipline, &request);
+            queue->sl_bitmap[fl] |= 1U << sl;
+            queue->fl_bitmap |= 1ULL << fl;
+            queue->count++;
+            *hole = request.size - 1;
+        } else {
+            queue->dropped++;  // Nombre ya cargado o sin memoria para metadatos
+        }
+    }
+    
+    return false;
+}
+
+// Libera la cola de admisión y las solicitudes que seguían esperando
+void admissionQueueFree(AdmissionQueue* queue) {
+    if (queue == NULL) {
+        return;
+    }
+    for (int fl = 0; fl < TLSF_FL_COUNT; fl++) {
+        for (int sl = 0; sl < TLSF_SL_COUNT; sl++) {
+            free(queue->classes[fl][sl].entries);
+        }
+    }
+    free(queue);
+}
+
+// Nombre corto de un modo de partición (el mismo que aceptan las trazas)
+const char* partitionTypeName(PartitionType type) {
+    switch (type) {
+        case FIXED_PARTITIONS: return "fixed";
+        case DYNAMIC_PARTITIONS: return "dynamic";
+        case BUDDY_PARTITIONS: return "buddy";
+        case BITMAP_PARTITIONS: return "bitmap";
+    }
+    return "?";
+}
+
+// Devuelve un instante del reloj monótono en nanosegundos
+uint64_t monotonicNanos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+// Índice del bucket log-lineal que corresponde a un valor
+static int latencyBucketIndex(uint64_t ns) {
+    if (ns < LATENCY_SUB_BUCKETS) {
+        return (int) ns;
+    }
+    
+    int exponent = 63 - __builtin_clzll(ns);
+    int sub_bucket = (int) ((ns >> (exponent - LATENCY_SUB_BUCKET_BITS)) & (LATENCY_SUB_BUCKETS - 1));
+    return (exponent - LATENCY_SUB_BUCKET_BITS + 1) * LATENCY_SUB_BUCKETS + sub_bucket;
+}
+
+// Valor representativo (punto medio) de un bucket del histograma
+static uint64_t latencyBucketValue(int index) {
+    if (index < LATENCY_SUB_BUCKETS) {
+        return (uint64_t) index;
+    }
+    
+    int exponent = index / LATENCY_SUB_BUCKETS + LATENCY_SUB_BUCKET_BITS - 1;
+    uint64_t sub_bucket = (uint64_t) (index % LATENCY_SUB_BUCKETS);
+    uint64_t width = 1ULL << (exponent - LATENCY_SUB_BUCKET_BITS);
+    uint64_t lower = (1ULL << exponent) + sub_bucket * width;
+    return lower + width / 2;
+}
+
+// Registra una muestra de latencia en el histograma
+void latencyRecord(LatencyHistogram* hist, uint64_t ns) {
+    hist->buckets[latencyBucketIndex(ns)]++;
+    
+    if (hist->count == 0 || ns < hist->min_ns) {
+        hist->min_ns = ns;
+    }
+    if (ns > hist->max_ns) {
+        hist->max_ns = ns;
+    }
+    
+    hist->count++;
+    hist->total_ns += ns;
+}
+
+// Obtiene el percentil indicado (0-100) del histograma
+uint64_t latencyPercentile(const LatencyHistogram* hist, double percentile) {
+    if (hist->count == 0) {
+        return 0;
+    }
+    
+    uint64_t target = (uint64_t) ((percentile / 100.0) * (double) hist->count);
+    if (target < 1) target = 1;
+    if (target > hist->count) target = hist->count;
+    
+    uint64_t accumulated = 0;
+    for (int i = 0; i < LATENCY_BUCKETS; i++) {
+        accumulated += hist->buckets[i];
+        if (accumulated >= target) {
+            uint64_t value = latencyBucketValue(i);
+            // El punto medio del bucket no puede salirse del rango observado
+            if (value < hist->min_ns) value = hist->min_ns;
+            if (value > hist->max_ns) value = hist->max_ns;
+            return value;
+        }
+    }
+    
+    return hist->max_ns;
+}
@@ -0,0 +1,438 @@
+/**
+ * Motor del simulador de administración de memoria
+ *
+ * Biblioteca con el estado del simulador y todas las operaciones sobre él: modos de
+ * partición, políticas de ubicación, asignación y liberación, compactación, estadísticas
+ * de fragmentación, arenas concurrentes, cola de admisión y snapshots. No escribe en la
+ * terminal ni termina el proceso: las operaciones que pueden fallar devuelven un SimStatus
+ * (o NULL en los constructores) y el programa que la usa decide qué mostrar; las
+ * validaciones describen la inconsistencia que encontraron en un texto que reciben.
+ *
+ * Se compila como libmemsim.a (ver el Makefile); el menú interactivo y los modos no
+ * interactivos de "Actividad 3.c" son un cliente más de esta interfaz.
+ */
+
+#ifndef MEMSIM_H
+#define MEMSIM_H
+
+ #include <stdbool.h>
+ #include <stddef.h>
+ #include <stdint.h>
+ #include <pthread.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+ #define FREE_TABLE_SIMD 1      // Escaneo de la tabla de bloques libres con SSE4.2/AVX2
+#endif
+
+// Contadores e histogramas de latencia del camino crítico; compilar con
+// -DNO_INSTRUMENTATION los quita por completo (para mediciones de rendimiento). El motor y
+// quien lo use deben compilarse con el mismo valor porque cambia el tamaño del simulador
+#ifndef NO_INSTRUMENTATION
+ #define INSTRUMENTATION 1
+#endif
+
+#define MAX_PROCESS_NAME 20
+#define SIM_ERROR_TEXT 160      // Tamaño suficiente para la descripción de una inconsistencia
+#define PAGE_SIZE_BYTES 4096    // Tamaño de página para la granularidad por páginas
+
+// Histograma log-lineal: 16 sub-buckets por potencia de dos (error relativo < 6.25%)
+#define LATENCY_SUB_BUCKET_BITS 4
+#define LATENCY_SUB_BUCKETS (1 << LATENCY_SUB_BUCKET_BITS)
+#define LATENCY_BUCKETS ((64 - LATENCY_SUB_BUCKET_BITS + 1) * LATENCY_SUB_BUCKETS)
+
+// Listas libres segregadas de dos niveles (TLSF): el primer nivel es la potencia de dos
+// del tamaño y el segundo la divide en 16 clases lineales
+#define TLSF_SL_BITS 4
+#define TLSF_SL_COUNT (1 << TLSF_SL_BITS)
+#define TLSF_FL_COUNT (64 - TLSF_SL_BITS + 1)
+
+#define BUDDY_MAX_ORDERS 64     // Órdenes posibles del sistema buddy (bloques de 2^0 a 2^63 unidades)
+
+// Direcciones y tamaños en unidades de asignación (ver MemoryUnit)
+typedef uint64_t MemSize;
+
+// Granularidad de la memoria simulada: a qué equivale una unidad
+typedef enum {
+    UNIT_MB,                    // 1 unidad = 1 MB (por defecto, como en el simulador original)
+    UNIT_KB,                    // 1 unidad = 1 KB
+    UNIT_PAGE,                  // 1 unidad = una página de PAGE_SIZE_BYTES
+    UNIT_BYTE                   // 1 unidad = 1 byte
+} MemoryUnit;
+
+// Tipos de particiones
+typedef enum {
+    FIXED_PARTITIONS,
+    DYNAMIC_PARTITIONS,
+    BUDDY_PARTITIONS,
+    BITMAP_PARTITIONS
+} PartitionType;
+
+// Política de ubicación para elegir el bloque libre de un proceso
+typedef enum {
+    PLACEMENT_FIRST_FIT,        // Bloque libre de menor dirección que alcance
+    PLACEMENT_NEXT_FIT,         // Como first-fit, pero desde donde terminó la última asignación
+    PLACEMENT_BEST_FIT,         // Bloque libre más pequeño que alcance
+    PLACEMENT_WORST_FIT,        // Bloque libre más grande
+    PLACEMENT_SEGREGATED_FIT,   // Clase de tamaño adecuada en listas segregadas (O(1))
+    PLACEMENT_FIRST_FIT_SCAN    // First-fit escaneando una tabla contigua de tamaños (SIMD)
+} PlacementPolicy;
+
+// Estado de un bloque de memoria
+typedef enum {
+    FREE,
+    OCCUPIED
+} BlockStatus;
+
+// Estructura para representar un bloque de memoria
+typedef struct MemoryBlock {
+    uint64_t id;                // ID del bloque
+    MemSize start_address;      // Dirección de inicio
+    MemSize size;               // Tamaño en unidades
+    MemSize requested_size;     // Tamaño solicitado por el proceso (si está ocupado)
+    BlockStatus status;         // Estado (FREE u OCCUPIED)
+    char process_name[MAX_PROCESS_NAME]; // Nombre del proceso que ocupa el bloque
+    struct MemoryBlock* next;   // Puntero al siguiente bloque
+    struct MemoryBlock* prev;   // Puntero al bloque anterior (vecino de menor dirección)
+    struct MemoryBlock* hash_next; // Siguiente bloque en la misma cubeta del índice por nombre
+    struct MemoryBlock* free_prev; // Anterior bloque libre en la misma clase de tamaño
+    struct MemoryBlock* free_next; // Siguiente bloque libre en la misma clase de tamaño
+    struct MemoryBlock* tree_left;  // Hijo izquierdo en el árbol de bloques libres
+    struct MemoryBlock* tree_right; // Hijo derecho en el árbol de bloques libres
+    uint32_t tree_priority;     // Prioridad aleatoria del treap
+    MemSize tree_max_size;      // Mayor tamaño libre en el subárbol (árbol por dirección)
+} MemoryBlock;
+
+// Trozo contiguo de nodos del pool de bloques
+typedef struct BlockChunk {
+    struct BlockChunk* next;    // Siguiente trozo (en orden de creación)
+    size_t capacity;            // Nodos en este trozo
+    MemoryBlock nodes[];        // Nodos
+} BlockChunk;
+
+// Pool de nodos MemoryBlock: reparte nodos de trozos grandes y recicla los liberados
+typedef struct {
+    BlockChunk* first_chunk;    // Primer trozo reservado
+    BlockChunk* last_chunk;     // Último trozo reservado (donde se agregan nuevos)
+    BlockChunk* current_chunk;  // Trozo del que se toman nodos nunca usados
+    size_t current_used;        // Nodos ya entregados de current_chunk
+    MemoryBlock* free_list;     // Nodos devueltos, enlazados por 'next'
+    size_t live_nodes;          // Nodos en uso
+    size_t total_nodes;         // Nodos reservados en todos los trozos
+} BlockPool;
+
+// Índice de bloques libres por clase de tamaño con mapas de bits para búsqueda O(1)
+typedef struct {
+    uint64_t fl_bitmap;                      // Bit i: hay bloques en alguna clase del nivel i
+    uint32_t sl_bitmap[TLSF_FL_COUNT];       // Bit j: la clase (i, j) no está vacía
+    MemoryBlock* heads[TLSF_FL_COUNT][TLSF_SL_COUNT]; // Listas doblemente enlazadas por clase
+} SegregatedBins;
+
+// Tabla de bloques libres ordenada por dirección, como arreglos paralelos (estructura de
+// arreglos): el escaneo first-fit solo lee 'size', 8 bytes por bloque y sin seguir punteros
+typedef struct {
+    MemSize* start;             // Dirección de inicio de cada bloque libre (clave de orden)
+    MemSize* size;              // Tamaño de cada bloque libre
+    MemoryBlock** node;         // Nodo del mapa de memoria (con el nombre, id, etc.)
+    size_t count;               // Filas en uso
+    size_t capacity;            // Filas reservadas
+    uint64_t missing;           // Bajas de bloques que no estaban en la tabla (índice desincronizado)
+} FreeTable;
+
+// Particiones fijas libres agrupadas por tamaño: una pila por cada tamaño distinto y un
+// árbol de segmentos sobre los tamaños que marca las pilas no vacías, para hallar la
+// menor partición libre que alcanza en O(log k) con k tamaños distintos
+typedef struct {
+    MemSize* sizes;             // Tamaños distintos de las particiones, en orden creciente
+    MemoryBlock** stacks;       // Particiones libres de cada tamaño (enlazadas por free_next/free_prev)
+    uint8_t* tree;              // Nodo i: algún tamaño de su rango tiene particiones libres (raíz en 1)
+    size_t count;               // Tamaños distintos
+    size_t leaves;              // Hojas del árbol (potencia de dos >= count, desde tree[leaves])
+} PartitionIndex;
+
+// Resultado de una llamada de compactación
+typedef struct {
+    uint64_t blocks_moved;      // Bloques ocupados desplazados
+    MemSize size_moved;         // Unidades copiadas al desplazarlos
+    bool completed;             // No quedan huecos entre bloques ocupados
+} CompactionResult;
+
+// Estadísticas de ocupación y fragmentación (mantenidas de forma incremental)
+typedef struct {
+    MemSize free_memory;        // Suma de los bloques libres
+    uint64_t free_blocks;       // Cantidad de bloques libres
+    MemSize largest_free_block; // Mayor bloque libre
+    uint64_t occupied_blocks;   // Procesos cargados
+    MemSize internal_waste;     // Unidades asignadas pero no solicitadas por los procesos
+    double external_ratio;      // 1 - mayor bloque libre / memoria libre (0 = sin fragmentar)
+} MemoryStats;
+
+// Histograma de latencias en nanosegundos con memoria constante
+typedef struct {
+    uint64_t buckets[LATENCY_BUCKETS];
+    uint64_t count;
+    uint64_t total_ns;
+    uint64_t min_ns;
+    uint64_t max_ns;
+} LatencyHistogram;
+
+// Resultado de las operaciones del motor. Ninguna función del motor escribe en la
+// terminal ni termina el proceso: devuelven uno de estos códigos y quien llama decide
+typedef enum {
+    SIM_OK,
+    SIM_ERR_INVALID_SIZE,       // Tamaño cero
+    SIM_ERR_NO_SPACE,           // Más grande que toda la memoria disponible
+    SIM_ERR_FRAGMENTATION,      // Hay memoria disponible, pero ningún bloque libre alcanza
+    SIM_ERR_DUPLICATE,          // Ya existe un proceso con ese nombre
+    SIM_ERR_NOT_FOUND,          // No existe un proceso con ese nombre
+    SIM_ERR_NO_MEMORY,          // No se pudo reservar memoria para los metadatos
+    SIM_ERR_INVALID_ARGUMENT,   // Parámetro de configuración fuera de rango
+    SIM_ERR_UNSUPPORTED,        // Operación no aplicable al modo de partición actual
+    SIM_ERR_IO,                 // Falló la lectura o la escritura de un archivo
+    SIM_ERR_BAD_SNAPSHOT,       // El archivo no es un snapshot compatible o está dañado
+    SIM_STATUS_COUNT
+} SimStatus;
+
+#ifdef INSTRUMENTATION
+// Operaciones instrumentadas del camino crítico
+typedef enum {
+    INSTR_ALLOCATE,
+    INSTR_DEALLOCATE,
+    INSTR_COMPACT,
+    INSTR_FRAGMENTATION,
+    INSTR_OP_COUNT
+} InstrOp;
+
+// Contadores de instrumentación de un simulador. Las latencias se guardan en unidades de
+// instrNow() (ciclos del contador de tiempo en x86) y se convierten a ns al reportarlas
+typedef struct {
+    LatencyHistogram latency[INSTR_OP_COUNT];
+    uint64_t failures[SIM_STATUS_COUNT]; // Operaciones rechazadas, por código de estado
+    uint64_t searches;          // Búsquedas de bloque libre
+    uint64_t blocks_visited;    // Nodos, filas o palabras examinados en esas búsquedas
+    uint64_t max_visited;       // Máximo examinado en una sola búsqueda
+    uint64_t splits;            // Bloques libres divididos al asignar
+    uint64_t coalesces;         // Fusiones de bloques libres vecinos
+} InstrStats;
+#endif
+
+// Estructura principal para la simulación
+typedef struct {
+    MemoryBlock* memory_map;    // Lista doblemente enlazada de bloques, ordenada por dirección
+    BlockPool pool;             // De aquí salen todos los nodos de memory_map
+    MemSize total_memory;       // Tamaño total de la memoria en unidades
+    MemSize available_memory;   // Memoria disponible en unidades
+    MemSize usable_memory;      // La que el modo puede asignar: sin el resto fuera de las particiones
+                                // fijas ni el que no llega al bloque mínimo de buddy o al trozo del mapa de bits
+    MemoryUnit unit;            // Granularidad: tamaño de cada unidad
+    PartitionType partition_type; // Tipo de partición actual
+    int num_fixed_partitions;   // Número de particiones fijas (si se usa ese modo)
+    MemSize fixed_partition_size; // Tamaño de la mayor partición fija
+    PartitionIndex partitions;  // Particiones fijas libres por tamaño (solo en ese modo)
+    MemoryBlock** name_index;   // Tabla hash nombre -> bloque ocupado (encadenamiento intrusivo)
+    size_t name_index_capacity; // Número de cubetas (potencia de dos)
+    size_t name_index_count;    // Procesos indexados
+    PlacementPolicy placement;  // Política de ubicación actual
+    SegregatedBins bins;        // Bloques libres por clase (solo con PLACEMENT_SEGREGATED_FIT)
+    MemoryBlock* free_tree;     // Treap de bloques libres: por dirección (first/next) o por tamaño (best/worst)
+    FreeTable free_table;       // Bloques libres en arreglos contiguos (solo con PLACEMENT_FIRST_FIT_SCAN)
+    uint64_t tree_seed;         // Estado del generador de prioridades del treap
+    MemSize next_fit_cursor;    // Dirección donde retoma la búsqueda next-fit
+    MemoryBlock* buddy_free[BUDDY_MAX_ORDERS]; // Listas libres por orden (modo buddy)
+    uint64_t buddy_order_mask;  // Bit k: la lista libre de orden k no está vacía
+    uint64_t* buddy_bitmap;     // Bit por bloque de cada orden: 1 si está libre con ese orden
+    size_t buddy_bit_offset[BUDDY_MAX_ORDERS]; // Primer bit de cada orden en buddy_bitmap
+    int buddy_max_order;        // Orden del mayor bloque posible
+    int buddy_min_order;        // Orden del menor bloque (más de 0 solo en memorias enormes)
+    uint64_t* bitmap;           // Modo mapa de bits: un bit por trozo de memoria, 1 = ocupado
+    size_t bitmap_bits;         // Trozos que cubre el mapa de bits
+    uint64_t* bitmap_summary;   // Un bit por palabra de bitmap: 1 si tiene algún trozo libre
+    MemSize bitmap_chunk;       // Unidades de memoria por bit
+    MemoryBlock* compact_cursor; // Todos los bloques anteriores están ocupados y contiguos
+    MemSize compaction_moved;          // Unidades movidas por compactación desde el inicio
+    uint64_t compaction_blocks_moved;  // Bloques movidos por compactación desde el inicio
+    MemSize free_memory;        // Suma de los tamaños de los bloques libres
+    uint64_t free_block_count;  // Cantidad de bloques libres
+    MemSize internal_waste;     // Suma de (tamaño - tamaño solicitado) de los bloques ocupados
+    MemSize freed_start;        // Hueco que dejó la última liberación, ya fusionado con sus
+    MemSize freed_size;         // vecinos salvo en modo mapa de bits (ver freedHoleSize)
+    uint64_t next_block_id;     // Siguiente ID disponible para bloques nuevos
+#ifdef INSTRUMENTATION
+    InstrStats instr;           // Contadores del camino crítico desde el inicio
+#endif
+} MemorySimulator;
+
+// Arena del modo concurrente: una región de la memoria con su propio simulador y su lock
+typedef struct {
+    MemorySimulator* sim;       // Simulador de la región (direcciones relativas a base)
+    pthread_mutex_t lock;       // Protege a sim y a los contadores de la arena
+    MemSize base;               // Dirección global donde empieza la región
+    uint64_t acquisitions;      // Veces que se tomó el lock
+    uint64_t contended;         // Veces que el lock estaba tomado por otro hilo al pedirlo
+} Arena;
+
+// Simulador concurrente: la memoria se reparte en arenas y cada hilo tiene una arena
+// "hogar" donde asigna primero; si no hay lugar prueba las demás en orden
+typedef struct {
+    Arena* arenas;
+    int arena_count;
+    MemSize total_memory;
+    MemoryUnit unit;
+} ConcurrentSimulator;
+
+// Disciplina de la cola de admisión: cuál de las solicitudes en espera que caben se
+// admite primero cuando se libera memoria
+typedef enum {
+    QUEUE_FIFO,                 // La que llegó primero
+    QUEUE_SMALLEST_FIRST,       // La más pequeña (a igual tamaño, la que llegó primero)
+    QUEUE_PRIORITY              // La de mayor prioridad (a igual prioridad, la que llegó primero)
+} QueueDiscipline;
+
+// Solicitud de asignación que espera memoria. Quien la encola completa todo menos
+// sequence; el motor no interpreta duration ni tag
+typedef struct {
+    MemSize size;               // Tamaño solicitado
+    uint64_t sequence;          // Orden de llegada a la cola (lo asigna la cola)
+    uint64_t enqueued_at;       // Instante de llegada, en el tiempo de quien usa la cola
+    uint64_t duration;          // Tiempo que el proceso permanecerá cargado una vez admitido
+    uint64_t tag;               // Dato libre de quien usa la cola (por ejemplo, un número de proceso)
+    uint32_t priority;          // Mayor número = más prioridad
+    char process_name[MAX_PROCESS_NAME];
+} QueuedRequest;
+
+// Heap binario de solicitudes, ordenado según la disciplina de la cola
+typedef struct {
+    QueuedRequest* entries;
+    size_t count;
+    size_t capacity;
+} RequestHeap;
+
+// Cola de admisión: las solicitudes se agrupan en las mismas clases de tamaño que TLSF y
+// cada clase es un heap; los mapas de bits dicen qué clases tienen solicitudes. Al
+// liberarse un hueco solo se miran las clases cuyos tamaños caben en él
+typedef struct {
+    QueueDiscipline discipline;
+    RequestHeap classes[TLSF_FL_COUNT][TLSF_SL_COUNT];
+    uint64_t fl_bitmap;         // Bit i: hay solicitudes en alguna clase del nivel i
+    uint32_t sl_bitmap[TLSF_FL_COUNT]; // Bit j: la clase (i, j) tiene solicitudes
+    size_t count;               // Solicitudes en espera
+    size_t max_count;           // Máximo de solicitudes en espera a la vez
+    uint64_t next_sequence;     // Número de la próxima solicitud encolada
+    uint64_t enqueued;          // Solicitudes que tuvieron que esperar
+    uint64_t admitted;          // Solicitudes admitidas desde la cola
+    uint64_t dropped;           // Descartadas al admitirlas (nombre ya cargado o sin metadatos)
+    uint64_t examined;          // Solicitudes comparadas al elegir cuál admitir
+    LatencyHistogram wait;      // Espera de las admitidas, en unidades de tiempo de quien usa la cola
+} AdmissionQueue;
+
+// Simulador: creación, modos de partición y operaciones sobre procesos
+MemorySimulator* initSimulator(MemSize memory_size, MemoryUnit unit);
+SimStatus setPartitionMode(MemorySimulator* sim, PartitionType type, int num_partitions);
+SimStatus setFixedPartitions(MemorySimulator* sim, const MemSize* sizes, size_t count);
+bool parsePartitionLayout(const char* text, MemoryUnit unit, MemSize** sizes, size_t* count);
+const char* partitionTypeName(PartitionType type);
+const char* simStatusMessage(SimStatus status);
+SimStatus allocateProcess(MemorySimulator* sim, char* process_name, MemSize process_size);
+SimStatus deallocateProcess(MemorySimulator* sim, char* process_name);
+void calculateFragmentation(MemorySimulator* sim, MemSize* internal_frag, MemSize* external_frag);
+void getMemoryStats(MemorySimulator* sim, MemoryStats* stats);
+MemSize largestFreeBlock(MemorySimulator* sim);
+MemSize freedHoleSize(MemorySimulator* sim);
+SimStatus compactMemory(MemorySimulator* sim, CompactionResult* result);
+bool compactMemoryStep(MemorySimulator* sim, uint64_t max_blocks, MemSize max_size, CompactionResult* result);
+bool compactUntilFits(MemorySimulator* sim, MemSize process_size, CompactionResult* result);
+void freeSimulator(MemorySimulator* sim);
+
+// Granularidad y validación
+const char* memoryUnitName(MemoryUnit unit);
+uint64_t memoryUnitBytes(MemoryUnit unit);
+bool parseMemoryUnit(const char* text, MemoryUnit* unit);
+bool parseMemorySize(const char* text, MemoryUnit unit, MemSize* size);
+bool validateSimulator(MemorySimulator* sim, char* error, size_t error_size);
+
+// Lista de bloques ordenada por dirección
+void listInsertAfter(MemoryBlock* position, MemoryBlock* block);
+void listUnlink(MemorySimulator* sim, MemoryBlock* block);
+
+// Pool de nodos de bloques
+MemoryBlock* blockAlloc(MemorySimulator* sim);
+void blockRelease(MemorySimulator* sim, MemoryBlock* block);
+void blockPoolReset(MemorySimulator* sim);
+void blockPoolDestroy(MemorySimulator* sim);
+bool blockPoolReserve(MemorySimulator* sim, size_t count);
+
+// Índice hash de procesos por nombre
+bool nameIndexInit(MemorySimulator* sim, size_t capacity);
+MemoryBlock* nameIndexFind(MemorySimulator* sim, const char* process_name);
+void nameIndexInsert(MemorySimulator* sim, MemoryBlock* block);
+void nameIndexRemove(MemorySimulator* sim, MemoryBlock* block);
+void nameIndexClear(MemorySimulator* sim);
+
+// Políticas de ubicación e índice de bloques libres
+SimStatus setPlacementPolicy(MemorySimulator* sim, PlacementPolicy policy);
+bool parsePlacementPolicy(const char* text, PlacementPolicy* policy);
+const char* placementPolicyName(PlacementPolicy policy);
+MemoryBlock* findFreeBlock(MemorySimulator* sim, MemSize size);
+void freeIndexInsert(MemorySimulator* sim, MemoryBlock* block);
+void freeIndexRemove(MemorySimulator* sim, MemoryBlock* block);
+bool freeIndexRebuild(MemorySimulator* sim);
+
+// Índice de particiones fijas por tamaño
+MemoryBlock* partitionIndexSearch(const PartitionIndex* index, MemSize size);
+MemSize partitionIndexLargest(const PartitionIndex* index);
+void partitionIndexRelease(MemorySimulator* sim);
+
+// Tabla contigua de bloques libres con escaneo vectorizado
+size_t freeTableScan(const MemSize* sizes, size_t count, MemSize size);
+size_t freeTableScanScalar(const MemSize* sizes, size_t count, MemSize size);
+#ifdef FREE_TABLE_SIMD
+size_t freeTableScanSse42(const MemSize* sizes, size_t count, MemSize size);
+size_t freeTableScanAvx2(const MemSize* sizes, size_t count, MemSize size);
+#endif
+bool freeTableReserve(MemorySimulator* sim);
+void freeTableRelease(MemorySimulator* sim);
+
+// Modo concurrente por arenas
+ConcurrentSimulator* concurrentInit(MemSize memory_size, MemoryUnit unit, int arena_count, PlacementPolicy placement);
+int concurrentAllocate(ConcurrentSimulator* cs, int home, char* process_name, MemSize process_size);
+bool concurrentDeallocate(ConcurrentSimulator* cs, int arena, char* process_name);
+bool concurrentValidate(ConcurrentSimulator* cs, char* error, size_t error_size);
+void concurrentFree(ConcurrentSimulator* cs);
+
+// Cola de admisión de solicitudes que esperan memoria
+AdmissionQueue* admissionQueueCreate(QueueDiscipline discipline);
+bool parseQueueDiscipline(const char* text, QueueDiscipline* discipline);
+const char* queueDisciplineName(QueueDiscipline discipline);
+SimStatus admissionQueuePush(AdmissionQueue* queue, MemorySimulator* sim, const QueuedRequest* request);
+bool admissionQueueAdmit(AdmissionQueue* queue, MemorySimulator* sim, MemSize* hole, uint64_t now,
+                         QueuedRequest* admitted);
+void admissionQueueFree(AdmissionQueue* queue);
+
+// Sistema buddy
+bool buddySetup(MemorySimulator* sim);
+void buddyRelease(MemorySimulator* sim);
+SimStatus buddyAllocate(MemorySimulator* sim, char* process_name, MemSize process_size);
+void buddyFreeBlock(MemorySimulator* sim, MemoryBlock* block);
+
+// Modo mapa de bits
+bool bitmapSetup(MemorySimulator* sim, MemSize chunk);
+void bitmapRelease(MemorySimulator* sim);
+SimStatus bitmapAllocate(MemorySimulator* sim, char* process_name, MemSize process_size);
+void bitmapFreeBlock(MemorySimulator* sim, MemoryBlock* block);
+MemSize bitmapLargestRun(MemorySimulator* sim);
+size_t bitmapRunAround(const MemorySimulator* sim, size_t start, size_t end);
+MemoryBlock* bitmapBuildMap(MemorySimulator* sim, MemoryBlock** gaps);
+bool bitmapValidate(MemorySimulator* sim, char* error, size_t error_size);
+
+// Snapshots del estado
+SimStatus saveSnapshot(MemorySimulator* sim, const char* path, uint64_t trace_line);
+MemorySimulator* loadSnapshot(const char* path, uint64_t* trace_line, SimStatus* status);
+
+// Histogramas de latencia y reloj
+void latencyRecord(LatencyHistogram* hist, uint64_t ns);
+uint64_t latencyPercentile(const LatencyHistogram* hist, double percentile);
+uint64_t monotonicNanos(void);
+#ifdef INSTRUMENTATION
+double instrTicksPerNs(void);
+#endif
+
+#endif
@@ -0,0 +1,277 @@
+/**
+ * Pruebas del motor (parte de "make check")
+ *
+ * Aplica cargas generadas en cada modo de partición con cada política de ubicación y
+ * valida las invariantes con validateSimulator después de cada operación; a mitad de la
+ * carga cada caso cambia al modo siguiente de la lista. Cada
+ * ROUND_TRIP_EVERY operaciones guarda un snapshot, lo restaura y comprueba que el
+ * simulador restaurado vuelve a guardar los mismos bytes y que responde igual que el
+ * original a la continuación de la carga.
+ */
+
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <stdbool.h>
+ #include <stdint.h>
+ #include <unistd.h>
+ #include "memsim.h"
+
+#define MEMORY_SIZE 4096            // KB de memoria simulada
+#define WORKLOAD_OPERATIONS 12000   // Operaciones por combinación de modo y política
+#define ROUND_TRIP_EVERY 3000       // Operaciones entre snapshots restaurados
+#define CONTINUATION_OPERATIONS 400 // Operaciones aplicadas al original y a la copia
+#define MODE_SWITCH_AT 7500         // Operación en la que el caso pasa al modo siguiente
+#define MAX_LIVE 1024               // Procesos cargados a la vez como máximo
+
+// Modo de partición de un caso de prueba
+typedef struct {
+    PartitionType type;
+    int partitions;             // Particiones iguales (fijas) o trozo (mapa de bits)
+    const char* layout;         // Particiones fijas de tamaños distintos, o NULL
+} ModeCase;
+
+static const ModeCase mode_cases[] = {
+    { FIXED_PARTITIONS, 64, NULL },
+    { FIXED_PARTITIONS, 0, "8x256,16x64,32x16,64x4,100" },  // Deja memoria sin particionar
+    { DYNAMIC_PARTITIONS, 0, NULL },
+    { BUDDY_PARTITIONS, 0, NULL },
+    { BITMAP_PARTITIONS, 4, NULL },
+};
+
+#define MODE_CASE_COUNT ((int) (sizeof(mode_cases) / sizeof(mode_cases[0])))
+#define POLICY_COUNT (PLACEMENT_FIRST_FIT_SCAN + 1)
+
+// Carga generada: el estado del generador y los procesos cargados. Es un valor, así que
+// una copia reproduce la misma continuación sobre otro simulador
+typedef struct {
+    uint64_t state;
+    uint64_t next_id;
+    size_t live;
+    char names[MAX_LIVE][MAX_PROCESS_NAME];
+} Workload;
+
+// Siguiente número pseudoaleatorio (xorshift64)
+static uint64_t workloadRandom(Workload* workload) {
+    workload->state ^= workload->state << 13;
+    workload->state ^= workload->state >> 7;
+    workload->state ^= workload->state << 17;
+    return workload->state;
+}
+
+// Aplica una operación elegida al azar y devuelve su resultado. Las liberaciones y
+// asignaciones repetidas también prueban los caminos de error
+static SimStatus workloadStep(Workload* workload, MemorySimulator* sim) {
+    uint64_t choice = workloadRandom(workload) % 1000;
+    CompactionResult result;
+    
+    if (choice < 4) {
+        return setPlacementPolicy(sim, (PlacementPolicy) (workloadRandom(workload) % POLICY_COUNT));
+    }
+    if (choice < 20) {
+        compactMemoryStep(sim, 1 + workloadRandom(workload) % 4, 0, &result);
+        return SIM_OK;
+    }
+    if (choice < 30) {
+        compactMemoryStep(sim, 0, 1 + workloadRandom(workload) % 256, &result);
+        return SIM_OK;
+    }
+    if (choice < 36) {
+        return compactUntilFits(sim, 1 + workloadRandom(workload) % 512, &result) ? SIM_OK : SIM_ERR_NO_SPACE;
+    }
+    if (choice < 38) {
+        return compactMemory(sim, &result);
+    }
+    if (choice < 45) {
+        char name[MAX_PROCESS_NAME];
+        snprintf(name, sizeof(name), "x%llu", (unsigned long long) workloadRandom(workload) % 100);
+        return deallocateProcess(sim, name);
+    }
+    
+    if (choice < 560 || workload->live == 0) {
+        // Tamaños chicos en su mayoría y, de vez en cuando, uno que no entra
+        uint64_t roll = workloadRandom(workload);
+        MemSize size = (roll % 50 == 0) ? MEMORY_SIZE / 2 + roll % MEMORY_SIZE : 1 + roll % 160;
+        
+        if (workload->live > 0 && roll % 97 == 0) {
+            return allocateProcess(sim, workload->names[roll % workload->live], size);
+        }
+        if (workload->live == MAX_LIVE) {
+            return SIM_OK;
+        }
+        
+        char* name = workload->names[workload->live];
+        snprintf(name, MAX_PROCESS_NAME, "p%llu", (unsigned long long) workload->next_id++);
+        SimStatus status = allocateProcess(sim, name, size);
+        workload->live += (status == SIM_OK);
+        return status;
+    }
+    
+    size_t victim = (size_t) (workloadRandom(workload) % workload->live);
+    SimStatus status = deallocateProcess(sim, workload->names[victim]);
+    workload->live--;
+    memcpy(workload->names[victim], workload->names[workload->live], MAX_PROCESS_NAME);
+    return status;
+}
+
+// Pone el simulador en el modo del caso; los procesos cargados se descartan
+static SimStatus modeApply(MemorySimulator* sim, const ModeCase* mode) {
+    if (mode->layout == NULL) {
+        return setPartitionMode(sim, mode->type, mode->partitions);
+    }
+    
+    MemSize* sizes;
+    size_t count;
+    if (!parsePartitionLayout(mode->layout, UNIT_KB, &sizes, &count)) {
+        return SIM_ERR_INVALID_ARGUMENT;
+    }
+    
+    SimStatus status = setFixedPartitions(sim, sizes, count);
+    free(sizes);
+    return status;
+}
+
+// Compara el contenido de dos archivos
+static bool filesEqual(const char* first_path, const char* second_path) {
+    FILE* first = fopen(first_path, "rb");
+    FILE* second = fopen(second_path, "rb");
+    bool equal = first != NULL && second != NULL;
+    
+    while (equal) {
+        char first_buffer[4096];
+        char second_buffer[4096];
+        size_t first_length = fread(first_buffer, 1, sizeof(first_buffer), first);
+        size_t second_length = fread(second_buffer, 1, sizeof(second_buffer), second);
+        
+        equal = first_length == second_length && memcmp(first_buffer, second_buffer, first_length) == 0;
+        if (first_length == 0) {
+            break;
+        }
+    }
+    
+    if (first != NULL) fclose(first);
+    if (second != NULL) fclose(second);
+    return equal;
+}
+
+// Guarda el simulador, lo restaura y sigue la carga sobre los dos a la vez. Devuelve
+// false y describe la diferencia en error si el restaurado no equivale al original
+static bool snapshotRoundTrip(MemorySimulator* sim, Workload* workload, uint64_t operation,
+                              const char* directory, char* error, size_t error_size) {
+    char original_path[256];
+    char copy_path[256];
+    uint64_t trace_line = 0;
+    SimStatus status;
+    bool ok = false;
+    
+    snprintf(original_path, sizeof(original_path), "%s/original.snap", directory);
+    snprintf(copy_path, sizeof(copy_path), "%s/copia.snap", directory);
+    
+    if (saveSnapshot(sim, original_path, operation) != SIM_OK) {
+        snprintf(error, error_size, "no se pudo guardar el snapshot");
+        return false;
+    }
+    
+    MemorySimulator* copy = loadSnapshot(original_path, &trace_line, &status);
+    if (copy == NULL) {
+        snprintf(error, error_size, "no se pudo restaurar el snapshot: %s", simStatusMessage(status));
+        return false;
+    }
+    
+    if (trace_line != operation) {
+        snprintf(error, error_size, "el snapshot devolvió la línea %llu", (unsigned long long) trace_line);
+    } else if (saveSnapshot(copy, copy_path, operation) != SIM_OK || !filesEqual(original_path, copy_path)) {
+        snprintf(error, error_size, "el simulador restaurado no vuelve a guardar los mismos bytes");
+    } else {
+        Workload copy_workload = *workload;
+        ok = true;
+        
+        for (int i = 0; ok && i < CONTINUATION_OPERATIONS; i++) {
+            SimStatus original_status = workloadStep(workload, sim);
+            SimStatus copy_status = workloadStep(&copy_workload, copy);
+            
+            if (original_status != copy_status) {
+                snprintf(error, error_size, "la copia respondió \"%s\" y el original \"%s\" en la operación %d de la continuación",
+                         simStatusMessage(copy_status), simStatusMessage(original_status), i + 1);
+                ok = false;
+            } else if (!validateSimulator(copy, error, error_size)) {
+                ok = false;
+            }
+        }
+        
+        if (ok && (saveSnapshot(sim, original_path, 0) != SIM_OK || saveSnapshot(copy, copy_path, 0) != SIM_OK ||
+                   !filesEqual(original_path, copy_path))) {
+            snprintf(error, error_size, "el original y la copia divergen después de la continuación");
+            ok = false;
+        }
+    }
+    
+    remove(original_path);
+    remove(copy_path);
+    freeSimulator(copy);
+    return ok;
+}
+
+// Corre la carga de un caso. Devuelve false después de informar la primera falla
+static bool runCase(int mode_index, PlacementPolicy policy, const char* directory, uint64_t* snapshots) {
+    static Workload workload;
+    const ModeCase* mode = &mode_cases[mode_index];
+    char error[SIM_ERROR_TEXT];
+    MemorySimulator* sim = initSimulator(MEMORY_SIZE, UNIT_KB);
+    bool ok = sim != NULL && modeApply(sim, mode) == SIM_OK && setPlacementPolicy(sim, policy) == SIM_OK;
+    
+    if (!ok) {
+        snprintf(error, sizeof(error), "no se pudo preparar el simulador");
+    }
+    
+    memset(&workload, 0, sizeof(workload));
+    workload.state = 0x9E3779B97F4A7C15ULL ^ ((uint64_t) mode_index << 32) ^ (uint64_t) policy;
+    
+    for (uint64_t operation = 1; ok && operation <= WORKLOAD_OPERATIONS; operation++) {
+        if (operation == MODE_SWITCH_AT && modeApply(sim, &mode_cases[(mode_index + 1) % MODE_CASE_COUNT]) == SIM_OK) {
+            workload.live = 0;
+        }
+        
+        workloadStep(&workload, sim);
+        ok = validateSimulator(sim, error, sizeof(error));
+        
+        if (ok && operation % ROUND_TRIP_EVERY == 0) {
+            ok = snapshotRoundTrip(sim, &workload, operation, directory, error, sizeof(error));
+            *snapshots += ok;
+        }
+    }
+    
+    if (!ok) {
+        fprintf(stderr, "FALLA motor: modo %s%s%s, política %s: %s\n", partitionTypeName(mode->type),
+                mode->layout != NULL ? " " : "", mode->layout != NULL ? mode->layout : "",
+                placementPolicyName(policy), error);
+    }
+    if (sim != NULL) {
+        freeSimulator(sim);
+    }
+    return ok;
+}
+
+int main(void) {
+    const char* temporary = getenv("TMPDIR");
+    char directory[256];
+    uint64_t snapshots = 0;
+    int failures = 0;
+    
+    snprintf(directory, sizeof(directory), "%s/memsim-check.XXXXXX", temporary != NULL ? temporary : "/tmp");
+    if (mkdtemp(directory) == NULL) {
+        fprintf(stderr, "FALLA motor: no se pudo crear un directorio temporal\n");
+        return 1;
+    }
+    
+    for (int mode = 0; mode < MODE_CASE_COUNT; mode++) {
+        for (int policy = 0; policy < POLICY_COUNT; policy++) {
+            failures += !runCase(mode, (PlacementPolicy) policy, directory, &snapshots);
+        }
+    }
+    
+    rmdir(directory);
+    printf("motor: %d casos de %d operaciones validadas, %llu snapshots restaurados y comparados, %d fallas\n",
+           MODE_CASE_COUNT * POLICY_COUNT, WORKLOAD_OPERATIONS, (unsigned long long) snapshots, failures);
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,344 @@
+/**
+ * Prueba de la memoria paginada contra un modelo de referencia (parte de "make check")
+ *
+ * Genera una traza de referencias con localidad, varios procesos y escrituras, la
+ * reproduce con "programa --paging" y compara los fallos, los fallos en frío, los
+ * reemplazos y las escrituras de cada política con los de un modelo directo: los marcos
+ * son un arreglo que se recorre entero para buscar la página y la víctima, sin tablas
+ * hash, listas ni TLB. Se prueba con y sin TLB: la TLB no debe cambiar ningún contador
+ * salvo sus aciertos.
+ *
+ * Uso: paging <programa>
+ */
+
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <stdbool.h>
+ #include <stdint.h>
+ #include <unistd.h>
+
+#define REFERENCES 60000            // Referencias de la traza generada
+#define PROCESSES 5
+#define PROCESS_PAGES 1500          // Páginas que puede tocar cada proceso
+#define MAX_FRAMES 128
+#define SEEN_CAPACITY (1 << 15)     // Potencia de dos, mayor que PROCESSES * PROCESS_PAGES * 2
+#define PATH_TEXT 512
+#define COMMAND_TEXT 2048
+#define POLICY_COUNT 4
+
+static const char* const policy_names[POLICY_COUNT] = { "fifo", "lru", "clock", "aging" };
+
+// Una referencia de la traza, ya traducida a página
+typedef struct {
+    uint32_t pid;
+    uint64_t address;
+    bool write;
+} Reference;
+
+// Configuración de una corrida
+typedef struct {
+    uint64_t page_size;
+    uint32_t frames;
+    uint32_t tlb;
+    uint64_t aging_interval;
+} PagingCase;
+
+static const PagingCase paging_cases[] = {
+    { 4096, 8, 0, 50 },
+    { 4096, 64, 64, 1000 },
+    { 8192, 48, 16, 7 },
+    { 4096, 100, 0, 1 },
+};
+
+#define CASE_COUNT ((int) (sizeof(paging_cases) / sizeof(paging_cases[0])))
+
+// Contadores que se comparan con los del programa
+typedef struct {
+    uint64_t faults;
+    uint64_t cold_faults;
+    uint64_t evictions;
+    uint64_t writebacks;
+} ModelStats;
+
+// Marco del modelo
+typedef struct {
+    uint32_t pid;
+    uint64_t vpn;
+    uint64_t loaded;            // Instante de carga (FIFO)
+    uint64_t used;              // Instante del último uso (LRU)
+    uint32_t age;
+    bool referenced;
+    bool dirty;
+} ModelFrame;
+
+// Páginas vistas alguna vez (para los fallos en frío): hash abierto de (pid, vpn + 1)
+typedef struct {
+    uint32_t pid[SEEN_CAPACITY];
+    uint64_t key[SEEN_CAPACITY];
+} SeenPages;
+
+// Siguiente número pseudoaleatorio (xorshift64)
+static uint64_t nextRandom(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+// Genera las referencias y las escribe en formato de traza, con comentarios, líneas
+// vacías, direcciones decimales y hexadecimales y marcas r/w opcionales
+static bool writeTrace(const char* path, Reference* references) {
+    FILE* file = fopen(path, "w");
+    uint64_t state = 0x106689D45497FDB5ULL;
+    uint64_t centers[PROCESSES] = { 0 };
+    uint32_t pid = 0;
+    
+    if (file == NULL) {
+        return false;
+    }
+    
+    fprintf(file, "# Traza generada por tests/paging.c\n\n");
+    for (int i = 0; i < REFERENCES; i++) {
+        Reference* reference = &references[i];
+        uint64_t roll = nextRandom(&state);
+        
+        if (roll % 64 == 0) {
+            pid = (uint32_t) (nextRandom(&state) % PROCESSES);
+        }
+        if (roll % 512 == 1) {
+            centers[pid] = nextRandom(&state) % PROCESS_PAGES;
+        }
+        
+        // Casi siempre cerca del centro del proceso; a veces, cualquier página
+        uint64_t page = (roll % 10 != 0) ? (centers[pid] + nextRandom(&state) % 24) % PROCESS_PAGES
+                                         : nextRandom(&state) % PROCESS_PAGES;
+        reference->pid = pid;
+        reference->address = 0x7f0000000000ULL * (pid + 1) + page * 4096 + nextRandom(&state) % 4096;
+        reference->write = (roll >> 20) % 10 < 3;
+        
+        const char* mark = reference->write ? " w" : ((roll >> 20) % 10 < 6 ? " r" : "");
+        if ((roll >> 30) % 2 == 0) {
+            fprintf(file, "proc%u 0x%llx%s\n", pid, (unsigned long long) reference->address, mark);
+        } else {
+            fprintf(file, "proc%u %llu%s\n", pid, (unsigned long long) reference->address, mark);
+        }
+        if ((roll >> 40) % 1000 == 0) {
+            fprintf(file, "# cambio de fase\n");
+        }
+    }
+    
+    return fclose(file) == 0;
+}
+
+// Marca la página como vista. Devuelve true si es la primera vez
+static bool seenInsert(SeenPages* seen, uint32_t pid, uint64_t vpn) {
+    size_t slot = (size_t) ((vpn * 0x9E3779B97F4A7C15ULL) ^ pid) & (SEEN_CAPACITY - 1);
+    
+    while (seen->key[slot] != 0) {
+        if (seen->key[slot] == vpn + 1 && seen->pid[slot] == pid) {
+            return false;
+        }
+        slot = (slot + 1) & (SEEN_CAPACITY - 1);
+    }
+    seen->key[slot] = vpn + 1;
+    seen->pid[slot] = pid;
+    return true;
+}
+
+// Elige la víctima recorriendo todos los marcos según la política
+static uint32_t modelVictim(int policy, ModelFrame* frames, uint32_t count, uint32_t* hand) {
+    uint32_t victim = 0;
+    
+    if (policy == 0 || policy == 1) {
+        for (uint32_t i = 1; i < count; i++) {
+            uint64_t current = (policy == 0) ? frames[i].loaded : frames[i].used;
+            uint64_t best = (policy == 0) ? frames[victim].loaded : frames[victim].used;
+            if (current < best) {
+                victim = i;
+            }
+        }
+        return victim;
+    }
+    
+    if (policy == 2) {
+        while (frames[*hand].referenced) {
+            frames[*hand].referenced = false;
+            *hand = (*hand + 1) % count;
+        }
+        victim = *hand;
+        *hand = (*hand + 1) % count;
+        return victim;
+    }
+    
+    // Aging: el menor contador, con el bit pendiente como el más reciente; ante empates
+    // gana el primero desde la manecilla
+    uint64_t lowest = UINT64_MAX;
+    for (uint32_t step = 0; step < count; step++) {
+        uint32_t i = (*hand + step) % count;
+        uint32_t age = (frames[i].age >> 1) | ((uint32_t) frames[i].referenced << 31);
+        if (age < lowest) {
+            lowest = age;
+            victim = i;
+        }
+    }
+    *hand = (victim + 1) % count;
+    return victim;
+}
+
+// Simula una política sobre las referencias
+static void modelRun(int policy, const PagingCase* config, const Reference* references, ModelStats* stats) {
+    static ModelFrame frames[MAX_FRAMES];
+    static SeenPages seen;
+    int shift = __builtin_ctzll(config->page_size);
+    uint32_t used = 0;
+    uint32_t hand = 0;
+    uint64_t countdown = config->aging_interval;
+    
+    memset(stats, 0, sizeof(ModelStats));
+    memset(&seen, 0, sizeof(seen));
+    
+    for (uint64_t now = 0; now < REFERENCES; now++) {
+        const Reference* reference = &references[now];
+        uint64_t vpn = reference->address >> shift;
+        uint32_t index = used;
+        
+        for (uint32_t i = 0; i < used; i++) {
+            if (frames[i].pid == reference->pid && frames[i].vpn == vpn) {
+                index = i;
+                break;
+            }
+        }
+        
+        if (index == used) {
+            stats->faults++;
+            stats->cold_faults += seenInsert(&seen, reference->pid, vpn);
+            
+            if (used < config->frames) {
+                index = used++;
+            } else {
+                index = modelVictim(policy, frames, used, &hand);
+                stats->evictions++;
+                stats->writebacks += frames[index].dirty;
+            }
+            
+            frames[index] = (ModelFrame) { reference->pid, vpn, now, now, 0, false, false };
+        }
+        
+        frames[index].used = now;
+        frames[index].dirty |= reference->write;
+        frames[index].referenced = true;
+        
+        if (policy == 3 && --countdown == 0) {
+            for (uint32_t i = 0; i < used; i++) {
+                frames[i].age = (frames[i].age >> 1) | ((uint32_t) frames[i].referenced << 31);
+                frames[i].referenced = false;
+            }
+            countdown = config->aging_interval;
+        }
+    }
+}
+
+// Corre el programa sobre la traza y compara su reporte con el modelo. Devuelve la
+// cantidad de diferencias
+static int checkCase(const char* program, const char* trace, const PagingCase* config, const Reference* references) {
+    char command[COMMAND_TEXT];
+    char line[512];
+    bool reported[POLICY_COUNT] = { false };
+    unsigned long long total = 0;
+    int mismatches = 0;
+    
+    snprintf(command, sizeof(command),
+             "'%s' --paging '%s' --page-size %llu --frames %u --tlb %u --aging-interval %llu --replace all 2>&1",
+             program, trace, (unsigned long long) config->page_size, config->frames, config->tlb,
+             (unsigned long long) config->aging_interval);
+    
+    FILE* output = popen(command, "r");
+    if (output == NULL) {
+        fprintf(stderr, "FALLA paginación: no se pudo ejecutar el programa\n");
+        return 1;
+    }
+    
+    while (fgets(line, sizeof(line), output) != NULL) {
+        char name[16];
+        unsigned long long faults, cold_faults, evictions, writebacks;
+        double rate, tlb;
+        
+        sscanf(line, "=== Memoria paginada: %llu referencias", &total);
+        if (sscanf(line, "%15s %llu %lf%% %llu %llu %llu %lf%%", name, &faults, &rate, &cold_faults,
+                   &evictions, &writebacks, &tlb) != 7) {
+            continue;
+        }
+        
+        for (int policy = 0; policy < POLICY_COUNT; policy++) {
+            if (strcmp(name, policy_names[policy]) != 0) {
+                continue;
+            }
+            
+            ModelStats expected;
+            modelRun(policy, config, references, &expected);
+            reported[policy] = true;
+            
+            if (faults != expected.faults || cold_faults != expected.cold_faults ||
+                evictions != expected.evictions || writebacks != expected.writebacks ||
+                (config->tlb == 0 && tlb != 0.0)) {
+                fprintf(stderr, "FALLA paginación: %s con %u marcos de %llu bytes y TLB %u: el programa da "
+                        "%llu/%llu/%llu/%llu y el modelo %llu/%llu/%llu/%llu (fallos/en frío/reemplazos/escrituras)\n",
+                        name, config->frames, (unsigned long long) config->page_size, config->tlb,
+                        faults, cold_faults, evictions, writebacks,
+                        (unsigned long long) expected.faults, (unsigned long long) expected.cold_faults,
+                        (unsigned long long) expected.evictions, (unsigned long long) expected.writebacks);
+                mismatches++;
+            }
+        }
+    }
+    
+    if (pclose(output) != 0 || total != REFERENCES) {
+        fprintf(stderr, "FALLA paginación: el programa no reprodujo las %d referencias\n", REFERENCES);
+        mismatches++;
+    }
+    for (int policy = 0; policy < POLICY_COUNT; policy++) {
+        if (!reported[policy]) {
+            fprintf(stderr, "FALLA paginación: falta la política %s en el reporte\n", policy_names[policy]);
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+int main(int argc, char* argv[]) {
+    static Reference references[REFERENCES];
+    const char* temporary = getenv("TMPDIR");
+    char directory[PATH_TEXT / 2];
+    char trace[PATH_TEXT];
+    int failures = 0;
+    bool written;
+    
+    if (argc != 2) {
+        fprintf(stderr, "Uso: %s <programa>\n", argv[0]);
+        return 2;
+    }
+    
+    snprintf(directory, sizeof(directory), "%s/memsim-check.XXXXXX", temporary != NULL ? temporary : "/tmp");
+    if (mkdtemp(directory) == NULL) {
+        fprintf(stderr, "FALLA paginación: no se pudo crear un directorio temporal\n");
+        return 1;
+    }
+    
+    snprintf(trace, sizeof(trace), "%s/referencias.txt", directory);
+    written = writeTrace(trace, references);
+    if (!written) {
+        fprintf(stderr, "FALLA paginación: no se pudo escribir la traza\n");
+        failures++;
+    }
+    
+    for (int i = 0; written && i < CASE_COUNT; i++) {
+        failures += checkCase(argv[1], trace, &paging_cases[i], references);
+    }
+    
+    remove(trace);
+    rmdir(directory);
+    printf("paginación: %d configuraciones x %d políticas comparadas con el modelo, %d fallas\n",
+           CASE_COUNT, POLICY_COUNT, failures);
+    return failures > 0 ? 1 : 0;
+}
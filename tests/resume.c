@@ -0,0 +1,211 @@
+/**
+ * Prueba de reanudación desde checkpoints (parte de "make check")
+ *
+ * Genera una traza que pasa por todos los modos de partición, cambia de política y
+ * compacta, y la reproduce con el programa escribiendo checkpoints. Después reanuda
+ * desde cada checkpoint con --restore y --resume y exige que el snapshot final y el mapa
+ * exportado sean idénticos, byte a byte, a los de la corrida sin interrumpir. Se repite
+ * con cada política de ubicación inicial.
+ *
+ * Uso: resume <programa>
+ */
+
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <stdbool.h>
+ #include <stdint.h>
+ #include <unistd.h>
+
+#define TRACE_LINES 9000            // Líneas de la traza generada
+#define SEGMENT_LINES 1500          // Líneas entre cambios de modo
+#define CHECKPOINT_EVERY 1100       // Operaciones entre checkpoints
+#define MAX_LIVE 4096
+#define MAX_NAME 20
+#define PATH_TEXT 512
+#define COMMAND_TEXT 4096
+
+static const char* const modes[] = { "dynamic", "bitmap 4", "buddy", "bitmap", "fixed 24", "dynamic" };
+static const char* const policies[] = { "first", "next", "best", "worst", "segregated", "scan" };
+static const char* const compactions[] = { "compact", "compact blocks 2", "compact mb 96", "compact fit 200" };
+
+#define MODE_COUNT ((int) (sizeof(modes) / sizeof(modes[0])))
+#define POLICY_COUNT ((int) (sizeof(policies) / sizeof(policies[0])))
+
+// Siguiente número pseudoaleatorio (xorshift64)
+static uint64_t nextRandom(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+// Escribe la traza de la prueba: todas sus líneas son operaciones válidas, así que el
+// checkpoint k queda en la línea k * CHECKPOINT_EVERY
+static bool writeTrace(const char* path) {
+    static char live[MAX_LIVE][MAX_NAME];
+    FILE* file = fopen(path, "w");
+    uint64_t state = 0x2545F4914F6CDD1DULL;
+    size_t live_count = 0;
+    uint64_t next_id = 0;
+    
+    if (file == NULL) {
+        return false;
+    }
+    
+    for (int line = 0; line < TRACE_LINES; line++) {
+        uint64_t choice = nextRandom(&state) % 1000;
+        
+        if (line % SEGMENT_LINES == 0) {
+            // Al cambiar de modo se descartan todos los procesos
+            fprintf(file, "mode %s\n", modes[(line / SEGMENT_LINES) % MODE_COUNT]);
+            live_count = 0;
+        } else if (choice < 8) {
+            fprintf(file, "policy %s\n", policies[nextRandom(&state) % POLICY_COUNT]);
+        } else if (choice < 30) {
+            fprintf(file, "%s\n", compactions[nextRandom(&state) % 4]);
+        } else if (choice < 560 || live_count == 0) {
+            uint64_t size = 1 + nextRandom(&state) % 120;
+            if (live_count < MAX_LIVE) {
+                snprintf(live[live_count++], MAX_NAME, "p%llu", (unsigned long long) next_id);
+            }
+            fprintf(file, "alloc p%llu %lluK\n", (unsigned long long) next_id++, (unsigned long long) size);
+        } else {
+            // Los procesos que no entraron también se liberan: el free falla y se cuenta
+            size_t victim = (size_t) (nextRandom(&state) % live_count);
+            fprintf(file, "free %s\n", live[victim]);
+            memcpy(live[victim], live[--live_count], MAX_NAME);
+        }
+    }
+    
+    return fclose(file) == 0;
+}
+
+// Compara el contenido de dos archivos
+static bool filesEqual(const char* first_path, const char* second_path) {
+    FILE* first = fopen(first_path, "rb");
+    FILE* second = fopen(second_path, "rb");
+    bool equal = first != NULL && second != NULL;
+    
+    while (equal) {
+        char first_buffer[4096];
+        char second_buffer[4096];
+        size_t first_length = fread(first_buffer, 1, sizeof(first_buffer), first);
+        size_t second_length = fread(second_buffer, 1, sizeof(second_buffer), second);
+        
+        equal = first_length == second_length && memcmp(first_buffer, second_buffer, first_length) == 0;
+        if (first_length == 0) {
+            break;
+        }
+    }
+    
+    if (first != NULL) fclose(first);
+    if (second != NULL) fclose(second);
+    return equal;
+}
+
+// Ejecuta el programa con los argumentos dados, sin mostrar su salida
+static bool runProgram(const char* program, const char* arguments) {
+    char command[2 * COMMAND_TEXT];
+    
+    snprintf(command, sizeof(command), "'%s' %s >/dev/null 2>&1", program, arguments);
+    return system(command) == 0;
+}
+
+// Reproduce la traza con una política inicial y reanuda desde cada checkpoint. Devuelve
+// la cantidad de reanudaciones que no llegaron al mismo estado (o -1 si la corrida
+// completa falla)
+static int checkPolicy(const char* program, const char* directory, int policy, int* resumed) {
+    const char* extra = (policy % 2 == 1) ? "--compact-on-fail" : "";
+    char trace[PATH_TEXT];
+    char arguments[COMMAND_TEXT];
+    int mismatches = 0;
+    bool complete;
+    
+    snprintf(trace, sizeof(trace), "%s/traza.txt", directory);
+    snprintf(arguments, sizeof(arguments),
+             "--memory 2048 --unit KB --policy %s %s --no-map --trace '%s' --checkpoint-every %d "
+             "--checkpoint-prefix '%s/cp' --save '%s/completa.snap' --export-map '%s/completa.json'",
+             policies[policy], extra, trace, CHECKPOINT_EVERY, directory, directory, directory);
+    complete = runProgram(program, arguments);
+    if (!complete) {
+        fprintf(stderr, "FALLA reanudación: la corrida completa con %s no terminó bien\n", policies[policy]);
+        mismatches = -1;
+    }
+    
+    for (int line = CHECKPOINT_EVERY; line <= TRACE_LINES; line += CHECKPOINT_EVERY) {
+        char checkpoint[PATH_TEXT];
+        char snapshot[2][PATH_TEXT];
+        char map[2][PATH_TEXT];
+        
+        snprintf(checkpoint, sizeof(checkpoint), "%s/cp.%d.snap", directory, line);
+        snprintf(snapshot[0], PATH_TEXT, "%s/completa.snap", directory);
+        snprintf(snapshot[1], PATH_TEXT, "%s/reanudada.snap", directory);
+        snprintf(map[0], PATH_TEXT, "%s/completa.json", directory);
+        snprintf(map[1], PATH_TEXT, "%s/reanudada.json", directory);
+        snprintf(arguments, sizeof(arguments),
+                 "--restore '%s' --resume %s --no-map --trace '%s' --save '%s' --export-map '%s'",
+                 checkpoint, extra, trace, snapshot[1], map[1]);
+        
+        // Sin corrida completa solo se borran los checkpoints que haya dejado
+        if (complete) {
+            if (!runProgram(program, arguments)) {
+                fprintf(stderr, "FALLA reanudación: %s, línea %d: el programa no terminó bien\n",
+                        policies[policy], line);
+                mismatches++;
+            } else if (!filesEqual(snapshot[0], snapshot[1]) || !filesEqual(map[0], map[1])) {
+                fprintf(stderr, "FALLA reanudación: %s, línea %d: el estado final difiere\n",
+                        policies[policy], line);
+                mismatches++;
+            }
+            (*resumed)++;
+        }
+        remove(checkpoint);
+        remove(snapshot[1]);
+        remove(map[1]);
+    }
+    
+    snprintf(arguments, sizeof(arguments), "%s/completa.snap", directory);
+    remove(arguments);
+    snprintf(arguments, sizeof(arguments), "%s/completa.json", directory);
+    remove(arguments);
+    return mismatches;
+}
+
+int main(int argc, char* argv[]) {
+    const char* temporary = getenv("TMPDIR");
+    char directory[PATH_TEXT / 2];
+    char trace[PATH_TEXT];
+    int resumed = 0;
+    int failures = 0;
+    bool written;
+    
+    if (argc != 2) {
+        fprintf(stderr, "Uso: %s <programa>\n", argv[0]);
+        return 2;
+    }
+    
+    snprintf(directory, sizeof(directory), "%s/memsim-check.XXXXXX", temporary != NULL ? temporary : "/tmp");
+    if (mkdtemp(directory) == NULL) {
+        fprintf(stderr, "FALLA reanudación: no se pudo crear un directorio temporal\n");
+        return 1;
+    }
+    
+    snprintf(trace, sizeof(trace), "%s/traza.txt", directory);
+    written = writeTrace(trace);
+    if (!written) {
+        fprintf(stderr, "FALLA reanudación: no se pudo escribir la traza\n");
+        failures++;
+    }
+    
+    for (int policy = 0; written && policy < POLICY_COUNT; policy++) {
+        int mismatches = checkPolicy(argv[1], directory, policy, &resumed);
+        failures += (mismatches < 0) ? 1 : mismatches;
+    }
+    
+    remove(trace);
+    rmdir(directory);
+    printf("reanudación: %d reanudaciones desde checkpoints con %d políticas iniciales, %d fallas\n",
+           resumed, POLICY_COUNT, failures);
+    return failures > 0 ? 1 : 0;
+}